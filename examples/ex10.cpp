@@ -460,18 +460,13 @@ HyperelasticOperator::HyperelasticOperator(FiniteElementSpace &f,
    backward_euler_oper = new BackwardEulerOperator(&M, &S, &H);
 
 #ifndef MFEM_USE_SUITESPARSE
-   J_prec = new DSmoother(1);
-   MINRESSolver *J_minres = new MINRESSolver;
-   J_minres->SetRelTol(rel_tol);
-   J_minres->SetAbsTol(0.0);
-   J_minres->SetMaxIter(300);
-   J_minres->SetPrintLevel(-1);
-   J_minres->SetPreconditioner(*J_prec);
-   J_solver = J_minres;
+   // the Jacobian is symmetric and the ordering/symbolic analysis of the
+   // sparse LDL^T factorization is reused in all Newton iterations
+   J_solver = new SparseLDLSolver;
 #else
    J_solver = new UMFPackSolver;
-   J_prec = NULL;
 #endif
+   J_prec = NULL;
 
    newton_solver.iterative_mode = false;
    newton_solver.SetSolver(*J_solver);
@@ -13,21 +13,93 @@
 
 #include "fem.hpp"
 #include <cmath>
+#include <algorithm>
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
 
 namespace mfem
 {
 
+/* Return a finalized SparseMatrix with zero entries whose sparsity pattern
+   couples all vector components of the (scalar) dofs connected in 'dof_dof',
+   with rows given by the vdofs of 'test_fes' and columns given by the vdofs
+   of 'trial_fes'. The data of 'dof_dof' is taken over if both spaces are
+   scalar. */
+static SparseMatrix *AllocVDofSparsity(Table &dof_dof,
+                                       const FiniteElementSpace &test_fes,
+                                       const FiniteElementSpace &trial_fes)
+{
+   const int height = test_fes.GetVSize(), width = trial_fes.GetVSize();
+   const int te_vdim = test_fes.GetVDim(), tr_vdim = trial_fes.GetVDim();
+   int *I, *J;
+
+   if (te_vdim == 1 && tr_vdim == 1)
+   {
+      I = dof_dof.GetI();
+      J = dof_dof.GetJ();
+      dof_dof.LoseData();
+   }
+   else
+   {
+      const int *dI = dof_dof.GetI(), *dJ = dof_dof.GetJ();
+      const int ndofs = test_fes.GetNDofs();
+
+      I = new int[height+1];
+      for (int k = 0; k < ndofs; k++)
+      {
+         const int row_size = (dI[k+1] - dI[k])*tr_vdim;
+         for (int vd = 0; vd < te_vdim; vd++)
+            I[test_fes.DofToVDof(k, vd)] = row_size;
+      }
+      for (int i = 0, sum = 0; i <= height; i++)
+      {
+         const int row_size = (i < height) ? I[i] : 0;
+         I[i] = sum;
+         sum += row_size;
+      }
+
+      J = new int[I[height]];
+      for (int k = 0; k < ndofs; k++)
+         for (int vd = 0; vd < te_vdim; vd++)
+         {
+            int *row_J = J + I[test_fes.DofToVDof(k, vd)];
+            for (int vd2 = 0; vd2 < tr_vdim; vd2++)
+               for (int j = dI[k]; j < dI[k+1]; j++)
+                  *row_J++ = trial_fes.DofToVDof(dJ[j], vd2);
+         }
+   }
+
+   double *data = new double[I[height]];
+   SparseMatrix *mat = new SparseMatrix(I, J, data, height, width);
+   *mat = 0.0;
+   return mat;
+}
+
+/* Copy the element-to-dof table of 'fes' into 'el_dof', decoding the
+   orientation signs of the dofs (see FiniteElementSpace::GetElementDofs). */
+static void GetElementToUnsignedDofTable(FiniteElementSpace &fes,
+                                         Table &el_dof)
+{
+   fes.BuildElementToDofTable();
+   fes.GetElementToDofTable().Copy(el_dof);
+   int *J = el_dof.GetJ();
+   for (int k = 0; k < el_dof.Size_of_connections(); k++)
+      if (J[k] < 0)
+         J[k] = -1-J[k];
+}
+
 void BilinearForm::AllocMat()
 {
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   if (precompute_sparsity == 0)
    {
       mat = new SparseMatrix(height);
       return;
    }
 
-   fes->BuildElementToDofTable();
-   const Table &elem_dof = fes->GetElementToDofTable();
-   Table dof_dof;
+   const int ndofs = fes->GetNDofs();
+   Table elem_dof, dof_dof;
+   GetElementToUnsignedDofTable(*fes, elem_dof);
 
    if (fbfi.Size() > 0)
    {
@@ -38,25 +110,18 @@ void BilinearForm::AllocMat()
          mfem::Mult(*face_elem, elem_dof, face_dof);
          delete face_elem;
       }
-      Transpose(face_dof, dof_face, height);
+      Transpose(face_dof, dof_face, ndofs);
       mfem::Mult(dof_face, face_dof, dof_dof);
    }
    else
    {
       // the sparsity pattern is defined from the map: element->dof
       Table dof_elem;
-      Transpose(elem_dof, dof_elem, height);
+      Transpose(elem_dof, dof_elem, ndofs);
       mfem::Mult(dof_elem, elem_dof, dof_dof);
    }
 
-   int *I = dof_dof.GetI();
-   int *J = dof_dof.GetJ();
-   double *data = new double[I[height]];
-
-   mat = new SparseMatrix(I, J, data, height, height);
-   *mat = 0.0;
-
-   dof_dof.LoseData();
+   mat = AllocVDofSparsity(dof_dof, *fes, *fes);
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f)
@@ -66,7 +131,16 @@ BilinearForm::BilinearForm (FiniteElementSpace * f)
    mat = mat_e = NULL;
    extern_bfs = 0;
    element_matrices = NULL;
+#ifdef MFEM_USE_OPENMP
+   // needed by the multithreaded assembly, see UsePrecomputedSparsity()
+   precompute_sparsity = 1;
+#else
    precompute_sparsity = 0;
+#endif
+   assembly = AssemblyLevel::FULL;
+   elmat_reuse = 0;
+   static_cond = NULL;
+   elem_colors = NULL;
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
@@ -80,6 +154,10 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    extern_bfs = 1;
    element_matrices = NULL;
    precompute_sparsity = ps;
+   assembly = AssemblyLevel::FULL;
+   elmat_reuse = 0;
+   static_cond = NULL;
+   elem_colors = NULL;
 
    bfi = bf->GetDBFI();
    dbfi.SetSize (bfi->Size());
@@ -116,9 +194,36 @@ const double& BilinearForm::Elem (int i, int j) const
 
 void BilinearForm::Mult (const Vector & x, Vector & y) const
 {
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      y = 0.0;
+      for (int k = 0; k < dbfi.Size(); k++)
+         dbfi[k]->AddMultPA(x, y);
+      return;
+   }
    mat -> Mult (x, y);
 }
 
+void BilinearForm::AddMult (const Vector & x, Vector & y, const double a) const
+{
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      if (a == 1.0)
+      {
+         for (int k = 0; k < dbfi.Size(); k++)
+            dbfi[k]->AddMultPA(x, y);
+      }
+      else
+      {
+         Vector z(y.Size());
+         Mult(x, z);
+         y.Add(a, z);
+      }
+      return;
+   }
+   mat -> AddMult (x, y, a);
+}
+
 MatrixInverse * BilinearForm::Inverse() const
 {
    return mat -> Inverse();
@@ -126,11 +231,27 @@ MatrixInverse * BilinearForm::Inverse() const
 
 void BilinearForm::Finalize (int skip_zeros)
 {
+   if (static_cond)
+      static_cond->Finalize(skip_zeros);
+   if (mat == NULL)
+      return;
    mat -> Finalize (skip_zeros);
    if (mat_e)
       mat_e -> Finalize (skip_zeros);
 }
 
+void BilinearForm::EnableStaticCondensation()
+{
+   MFEM_VERIFY(assembly == AssemblyLevel::FULL,
+               "static condensation requires full assembly");
+#ifdef MFEM_USE_MPI
+   MFEM_VERIFY(dynamic_cast<ParFiniteElementSpace *>(fes) == NULL,
+               "static condensation is not supported by ParBilinearForm");
+#endif
+   if (static_cond == NULL)
+      static_cond = new StaticCondensation(fes);
+}
+
 void BilinearForm::AddDomainIntegrator (BilinearFormIntegrator * bfi)
 {
    dbfi.Append (bfi);
@@ -195,19 +316,56 @@ void BilinearForm::Assemble (int skip_zeros)
 
    int i;
 
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      MFEM_VERIFY(bbfi.Size() == 0 && fbfi.Size() == 0 && bfbfi.Size() == 0,
+                  "partial assembly supports only domain integrators");
+      MFEM_VERIFY(static_cond == NULL,
+                  "static condensation requires full assembly");
+      for (int k = 0; k < dbfi.Size(); k++)
+         dbfi[k]->AssemblePA(*fes);
+      return;
+   }
+
+   // the domain integrators use the cached geometric factors of the mesh
+   for (int k = 0; k < dbfi.Size(); k++)
+      dbfi[k]->UseGeometricFactors(mesh);
+
+   if (static_cond)
+   {
+      AssembleCondensed(skip_zeros);
+      for (int k = 0; k < dbfi.Size(); k++)
+         dbfi[k]->UseGeometricFactors(NULL);
+      return;
+   }
+
    if (mat == NULL)
       AllocMat();
 
+   bool domain_assembled = false;
+   // the NURBS elements are not determined by their control points
+   if (dbfi.Size() && elmat_reuse && !element_matrices && !mesh->NURBSext)
+   {
+      AssembleDomainSimilar(skip_zeros);
+      domain_assembled = true;
+   }
 #ifdef MFEM_USE_OPENMP
    int free_element_matrices = 0;
-   if (!element_matrices)
+   if (domain_assembled)
+      ;
+   else if (dbfi.Size() && mat->Finalized() && !element_matrices)
+   {
+      AssembleDomainThreaded();
+      domain_assembled = true;
+   }
+   else if (!element_matrices)
    {
       ComputeElementMatrices();
       free_element_matrices = 1;
    }
 #endif
 
-   if (dbfi.Size())
+   if (dbfi.Size() && !domain_assembled)
    {
       for (i = 0; i < fes -> GetNE(); i++)
       {
@@ -294,6 +452,269 @@ void BilinearForm::Assemble (int skip_zeros)
    if (free_element_matrices)
       FreeElementMatrices();
 #endif
+
+   for (int k = 0; k < dbfi.Size(); k++)
+      dbfi[k]->UseGeometricFactors(NULL);
+}
+
+void BilinearForm::AssembleCondensed(int skip_zeros)
+{
+   MFEM_VERIFY(dbfi.Size() > 0 && fbfi.Size() == 0 && bfbfi.Size() == 0,
+               "static condensation requires domain integrators and does not "
+               "support face integrators");
+
+   static_cond->Init();
+
+   DenseMatrix elmat;
+   for (int i = 0; i < fes->GetNE(); i++)
+   {
+      ComputeElementMatrix(i, elmat);
+      static_cond->AssembleMatrix(i, elmat, skip_zeros);
+   }
+
+   for (int i = 0; i < fes->GetNBE(); i++)
+   {
+      const FiniteElement &be = *fes->GetBE(i);
+      ElementTransformation *eltrans = fes->GetBdrElementTransformation(i);
+      for (int k = 0; k < bbfi.Size(); k++)
+      {
+         bbfi[k]->AssembleElementMatrix(be, *eltrans, elemmat);
+         static_cond->AssembleBdrMatrix(i, elemmat, skip_zeros);
+      }
+   }
+}
+
+void BilinearForm::ColorElements()
+{
+   Table elem_dof, dof_elem;
+   GetElementToUnsignedDofTable(*fes, elem_dof);
+   Transpose(elem_dof, dof_elem, fes->GetNDofs());
+
+   // greedy coloring of the graph of elements sharing a dof
+   const int ne = fes->GetNE();
+   Array<int> color(ne), marker;
+   int num_colors = 0;
+   for (int e = 0; e < ne; e++)
+   {
+      const int *dofs = elem_dof.GetRow(e);
+      for (int i = 0; i < elem_dof.RowSize(e); i++)
+      {
+         const int *els = dof_elem.GetRow(dofs[i]);
+         for (int j = 0; j < dof_elem.RowSize(dofs[i]); j++)
+            if (els[j] < e)
+               marker[color[els[j]]] = e;
+      }
+      int c = 0;
+      while (c < num_colors && marker[c] == e)
+         c++;
+      if (c == num_colors)
+      {
+         num_colors++;
+         marker.Append(-1);
+      }
+      color[e] = c;
+   }
+
+   elem_colors = new Table;
+   elem_colors->MakeI(num_colors);
+   for (int e = 0; e < ne; e++)
+      elem_colors->AddAColumnInRow(color[e]);
+   elem_colors->MakeJ();
+   for (int e = 0; e < ne; e++)
+      elem_colors->AddConnection(color[e], e);
+   elem_colors->ShiftUpI();
+}
+
+int BilinearForm::CloneDomainIntegrators(
+   Array<BilinearFormIntegrator*> &integs)
+{
+   const int nd = dbfi.Size();
+   int nt = 1;
+#ifdef MFEM_USE_OPENMP
+   nt = omp_get_max_threads();
+#endif
+   integs.SetSize(nt*nd);
+   for (int k = 0; k < nd; k++)
+      integs[k] = dbfi[k];
+   for (int i = nd; i < nt*nd; i++)
+   {
+      integs[i] = dbfi[i % nd]->Clone();
+      if (integs[i] == NULL)
+      {
+         // some integrator can not be copied, use only one thread
+         for (int j = nd; j < i; j++)
+            delete integs[j];
+         integs.SetSize(nd);
+         return 1;
+      }
+   }
+   return nt;
+}
+
+void BilinearForm::DeleteDomainIntegratorClones(
+   Array<BilinearFormIntegrator*> &integs)
+{
+   for (int i = dbfi.Size(); i < integs.Size(); i++)
+      delete integs[i];
+   integs.SetSize(0);
+}
+
+void BilinearForm::AssembleDomainThreaded()
+{
+   if (elem_colors == NULL)
+      ColorElements();
+   mat->SortColumnIndices();
+
+   const int num_colors = elem_colors->Size();
+   Array<BilinearFormIntegrator*> integs;
+#ifdef MFEM_USE_OPENMP
+   const int num_threads = CloneDomainIntegrators(integs);
+#pragma omp parallel num_threads(num_threads)
+#else
+   CloneDomainIntegrators(integs);
+#endif
+   {
+      BilinearFormIntegrator **bfi = integs.GetData();
+#ifdef MFEM_USE_OPENMP
+      bfi += omp_get_thread_num()*dbfi.Size();
+#endif
+      IsoparametricTransformation eltrans;
+      DenseMatrix elmat, tmp;
+      Array<int> el_vdofs;
+
+      for (int c = 0; c < num_colors; c++)
+      {
+         const int *els = elem_colors->GetRow(c);
+         const int n = elem_colors->RowSize(c);
+         // the implicit barrier at the end of the loop separates the colors
+#ifdef MFEM_USE_OPENMP
+#pragma omp for schedule(static)
+#endif
+         for (int k = 0; k < n; k++)
+         {
+            const int i = els[k];
+            const FiniteElement &fe = *fes->GetFE(i);
+            fes->GetElementTransformation(i, &eltrans);
+            bfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+            for (int j = 1; j < dbfi.Size(); j++)
+            {
+               bfi[j]->AssembleElementMatrix(fe, eltrans, tmp);
+               elmat += tmp;
+            }
+            fes->GetElementVDofs(i, el_vdofs);
+            mat->AddSubMatrixSorted(el_vdofs, el_vdofs, elmat);
+         }
+      }
+   }
+   DeleteDomainIntegratorClones(integs);
+}
+
+void BilinearForm::GroupSimilarElements(Table &groups)
+{
+   const int ne = fes->GetNE();
+   IsoparametricTransformation eltrans;
+   Array<const FiniteElement *> fe_list;
+
+   // the keys of the elements: FiniteElement index, attribute, number of
+   // points, scale exponent, and the quantized coordinates of the points
+   // relative to the first one
+   Array<int> key_ptr(ne+1);
+   Array<double> keys;
+   key_ptr[0] = 0;
+   for (int i = 0; i < ne; i++)
+   {
+      const FiniteElement *fe = fes->GetFE(i);
+      int fe_idx = fe_list.Find(fe);
+      if (fe_idx < 0)
+         fe_idx = fe_list.Append(fe) - 1;
+
+      fes->GetElementTransformation(i, &eltrans);
+      const DenseMatrix &pm = eltrans.GetPointMat();
+      double h = 0.0;
+      for (int j = 1; j < pm.Width(); j++)
+         for (int d = 0; d < pm.Height(); d++)
+            h = std::max(h, fabs(pm(d,j) - pm(d,0)));
+      int exp;
+      frexp(h, &exp);
+      const double scale = ldexp(1.0, exp - 36);
+
+      keys.Append(fe_idx);
+      keys.Append(fes->GetAttribute(i));
+      keys.Append(pm.Width());
+      keys.Append(exp);
+      for (int j = 1; j < pm.Width(); j++)
+         for (int d = 0; d < pm.Height(); d++)
+            keys.Append(floor((pm(d,j) - pm(d,0))/scale + 0.5) + 0.0);
+      key_ptr[i+1] = keys.Size();
+   }
+
+   // hash table of the representatives, chained through 'next'
+   int num_buckets = 1;
+   while (num_buckets < ne)
+      num_buckets *= 2;
+   Array<int> bucket(num_buckets), next(ne), group(ne);
+   bucket = -1;
+   int num_groups = 0;
+   for (int i = 0; i < ne; i++)
+   {
+      const double *key = keys.GetData() + key_ptr[i];
+      const int key_size = key_ptr[i+1] - key_ptr[i];
+
+      // FNV-1a hash of the bytes of the key
+      unsigned hash = 2166136261u;
+      const unsigned char *bytes = (const unsigned char *) key;
+      for (size_t b = 0; b < key_size*sizeof(double); b++)
+         hash = (hash ^ bytes[b]) * 16777619u;
+      int &head = bucket[hash & (num_buckets-1)];
+
+      int r;
+      for (r = head; r >= 0; r = next[r])
+         if (key_ptr[r+1] - key_ptr[r] == key_size &&
+             std::equal(key, key + key_size, keys.GetData() + key_ptr[r]))
+            break;
+      if (r >= 0)
+         group[i] = group[r];
+      else
+      {
+         group[i] = num_groups++;
+         next[i] = head;
+         head = i;
+      }
+   }
+
+   groups.MakeI(num_groups);
+   for (int i = 0; i < ne; i++)
+      groups.AddAColumnInRow(group[i]);
+   groups.MakeJ();
+   for (int i = 0; i < ne; i++)
+      groups.AddConnection(group[i], i);
+   groups.ShiftUpI();
+}
+
+void BilinearForm::AssembleDomainSimilar(int skip_zeros)
+{
+   Table groups;
+   GroupSimilarElements(groups);
+
+   DenseMatrix elmat;
+   for (int g = 0; g < groups.Size(); g++)
+   {
+      const int *els = groups.GetRow(g);
+      const FiniteElement &fe = *fes->GetFE(els[0]);
+      ElementTransformation *eltrans = fes->GetElementTransformation(els[0]);
+      dbfi[0]->AssembleElementMatrix(fe, *eltrans, elmat);
+      for (int k = 1; k < dbfi.Size(); k++)
+      {
+         dbfi[k]->AssembleElementMatrix(fe, *eltrans, elemmat);
+         elmat += elemmat;
+      }
+
+      for (int j = 0; j < groups.RowSize(g); j++)
+      {
+         fes->GetElementVDofs(els[j], vdofs);
+         mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+      }
+   }
 }
 
 void BilinearForm::ConformingAssemble()
@@ -343,12 +764,19 @@ void BilinearForm::ComputeElementMatrices()
 
    DenseMatrix tmp;
    IsoparametricTransformation eltrans;
-
+   Array<BilinearFormIntegrator*> integs;
 #ifdef MFEM_USE_OPENMP
-#pragma omp parallel for private(tmp,eltrans)
+   const int num_threads = CloneDomainIntegrators(integs);
+#pragma omp parallel for private(tmp,eltrans) num_threads(num_threads)
+#else
+   CloneDomainIntegrators(integs);
 #endif
    for (int i = 0; i < num_elements; i++)
    {
+      BilinearFormIntegrator **bfi = integs.GetData();
+#ifdef MFEM_USE_OPENMP
+      bfi += omp_get_thread_num()*dbfi.Size();
+#endif
       DenseMatrix elmat(element_matrices->GetData(i),
                         num_dofs_per_el, num_dofs_per_el);
       const FiniteElement &fe = *fes->GetFE(i);
@@ -359,15 +787,15 @@ void BilinearForm::ComputeElementMatrices()
 #endif
       fes->GetElementTransformation(i, &eltrans);
 
-      dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+      bfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
       for (int k = 1; k < dbfi.Size(); k++)
       {
-         // note: some integrators may not be thread-safe
-         dbfi[k]->AssembleElementMatrix(fe, eltrans, tmp);
+         bfi[k]->AssembleElementMatrix(fe, eltrans, tmp);
          elmat += tmp;
       }
       elmat.ClearExternalData();
    }
+   DeleteDomainIntegratorClones(integs);
 }
 
 void BilinearForm::EliminateEssentialBC (
@@ -464,6 +892,13 @@ void BilinearForm::Update (FiniteElementSpace *nfes)
    delete mat_e;
    delete mat;
    FreeElementMatrices();
+   delete elem_colors;
+   elem_colors = NULL;
+   if (static_cond)
+   {
+      delete static_cond;
+      static_cond = new StaticCondensation(fes);
+   }
 
    height = width = fes->GetVSize();
 
@@ -475,6 +910,8 @@ BilinearForm::~BilinearForm()
    delete mat_e;
    delete mat;
    delete element_matrices;
+   delete elem_colors;
+   delete static_cond;
 
    if (!extern_bfs)
    {
@@ -494,6 +931,25 @@ MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
    trial_fes = tr_fes;
    test_fes = te_fes;
    mat = NULL;
+   precompute_sparsity = 0;
+}
+
+void MixedBilinearForm::AllocMat()
+{
+   if (precompute_sparsity == 0 || skt.Size() > 0)
+   {
+      mat = new SparseMatrix(height, width);
+      return;
+   }
+
+   // the sparsity pattern is defined from the map: test dof->element->dof
+   Table trial_elem_dof, test_elem_dof, dof_elem, dof_dof;
+   GetElementToUnsignedDofTable(*trial_fes, trial_elem_dof);
+   GetElementToUnsignedDofTable(*test_fes, test_elem_dof);
+   Transpose(test_elem_dof, dof_elem, test_fes->GetNDofs());
+   mfem::Mult(dof_elem, trial_elem_dof, dof_dof);
+
+   mat = AllocVDofSparsity(dof_dof, *test_fes, *trial_fes);
 }
 
 double & MixedBilinearForm::Elem (int i, int j)
@@ -570,7 +1026,7 @@ void MixedBilinearForm::Assemble (int skip_zeros)
    Mesh *mesh = test_fes -> GetMesh();
 
    if (mat == NULL)
-      mat = new SparseMatrix(height, width);
+      AllocMat();
 
    if (dom.Size())
    {
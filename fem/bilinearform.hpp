@@ -18,10 +18,20 @@
 #include "gridfunc.hpp"
 #include "linearform.hpp"
 #include "bilininteg.hpp"
+#include "staticcond.hpp"
 
 namespace mfem
 {
 
+/** Level of assembly performed by BilinearForm::Assemble(). FULL assembles a
+    global SparseMatrix; PARTIAL only stores the data at the quadrature points
+    needed to apply the operator element-by-element (matrix-free action). */
+class AssemblyLevel
+{
+public:
+   enum Type { FULL, PARTIAL };
+};
+
 /** Class for bilinear form - "Matrix" with associated FE space and
     BLFIntegrators. */
 class BilinearForm : public Matrix
@@ -56,13 +66,56 @@ protected:
    DenseTensor *element_matrices;
 
    int precompute_sparsity;
+   int assembly;
+   int elmat_reuse;
+   StaticCondensation *static_cond;
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
+   /** Groups of elements (one row per color) such that no two elements in a
+       group share a dof; used by the multithreaded assembly. */
+   Table *elem_colors;
+   void ColorElements();
+
+   /** Return the number of threads to use for the element matrices of the
+       domain integrators and set 'integs' to the integrators of each thread:
+       thread t uses the entries starting at t*dbfi.Size(). Thread 0 uses
+       dbfi and the other threads use copies (see
+       BilinearFormIntegrator::Clone()), so that each thread has its own work
+       space. If some integrator can not be copied, only one thread is used. */
+   int CloneDomainIntegrators(Array<BilinearFormIntegrator*> &integs);
+   /// Delete the copies created by CloneDomainIntegrators()
+   void DeleteDomainIntegratorClones(Array<BilinearFormIntegrator*> &integs);
+
+   /** Assemble the domain integrators with OpenMP threads: the elements of
+       each color are processed concurrently, with thread-private element
+       transformations, matrices and integrators, and scattered directly into
+       the finalized matrix. */
+   void AssembleDomainThreaded();
+
+   /** Group the elements that have the same FiniteElement, attribute and
+       vertex (or node) coordinates relative to their first vertex, up to a
+       relative tolerance of about 1e-11 of the element size. Row k of
+       'groups' lists the elements of group k in increasing order. */
+   void GroupSimilarElements(Table &groups);
+
+   /** Assemble the domain integrators computing the element matrix only once
+       for each group of similar elements, see UseElementMatrixReuse(). */
+   void AssembleDomainSimilar(int skip_zeros);
+
+   /// Assemble the reduced matrix of the static condensation
+   void AssembleCondensed(int skip_zeros);
+
    // may be used in the construction of derived classes
    BilinearForm() : Matrix (0)
    { fes = NULL; mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
-      precompute_sparsity = 0; }
+#ifdef MFEM_USE_OPENMP
+      precompute_sparsity = 1;
+#else
+      precompute_sparsity = 0;
+#endif
+      assembly = AssemblyLevel::FULL;
+      elmat_reuse = 0; static_cond = NULL; elem_colors = NULL; }
 
 public:
    /// Creates bilinear form associated with FE space *f.
@@ -73,11 +126,50 @@ public:
    /// Get the size of the BilinearForm as a square matrix.
    int Size() const { return height; }
 
-   /** For scalar FE spaces, precompute the sparsity pattern of the matrix
-       (assuming dense element matrices) based on the types of integrators
-       present in the bilinear form. */
+   /** Precompute the sparsity pattern of the matrix (assuming dense element
+       matrices coupling all vector components) based on the types of
+       integrators present in the bilinear form. The matrix is then allocated
+       once in CSR format and assembly adds directly into it.
+
+       When MFEM is built with OpenMP, this is the default: the domain
+       integrators are then assembled by multiple threads directly into the
+       CSR matrix, each thread using its own copy of the integrators (see
+       BilinearFormIntegrator::Clone()); the coefficients are shared and must
+       be thread-safe. With UsePrecomputedSparsity(0) the element matrices
+       are instead computed by multiple threads into a DenseTensor and then
+       added to the matrix by one thread. In both cases, if some domain
+       integrator does not implement Clone(), only one thread is used. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** Select the assembly level, see AssemblyLevel. With partial assembly,
+       Assemble() only prepares the domain integrators for matrix-free
+       application; Mult() and AddMult() then act on the fly and SpMat() is not
+       available. Only domain integrators implementing AssemblePA() (currently
+       DiffusionIntegrator and MassIntegrator) are supported. */
+   void SetAssemblyLevel(int level) { assembly = level; }
+
+   int GetAssemblyLevel() const { return assembly; }
+
+   /** Compute the element matrix of the domain integrators only once for all
+       the elements that are translations of each other and have the same
+       attribute, e.g. in meshes of a box (Mesh(nx, ny, nz, type)) and their
+       uniform refinements. This is valid only if the domain integrators are
+       invariant under translations, i.e. their coefficients are constant on
+       each attribute (ConstantCoefficient, PWConstCoefficient), as with the
+       Diffusion, Mass and Elasticity integrators with such coefficients.
+       The similar elements are detected in every call to Assemble(). The
+       option is ignored on NURBS meshes. */
+   void UseElementMatrixReuse(int r = 1) { elmat_reuse = r; }
+
+   /** Eliminate the element interior dofs during assembly, see
+       StaticCondensation. Assemble() and Finalize() then build only the
+       reduced matrix, GetStaticCondensation()->GetMatrix(), and the full
+       matrix (SpMat(), Mult(), etc.) is not available. Face integrators and
+       parallel spaces (ParBilinearForm) are not supported. */
+   void EnableStaticCondensation();
+
+   StaticCondensation *GetStaticCondensation() { return static_cond; }
+
    /** Pre-allocate the internal SparseMatrix before assembly. If the flag
        'precompute sparsity' is set, the matrix is allocated in CSR format (i.e.
        finalized) and the entries are initialized with zeros. */
@@ -105,8 +197,7 @@ public:
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
 
-   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const
-   { mat -> AddMult (x, y, a); }
+   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
    void FullAddMult(const Vector &x, Vector &y) const
    { mat->AddMult(x, y); mat_e->AddMult(x, y); }
@@ -232,10 +323,20 @@ protected:
    Array<BilinearFormIntegrator*> bdr;
    Array<BilinearFormIntegrator*> skt; // trace face integrators
 
+   int precompute_sparsity;
+   // Allocate appropriate SparseMatrix and assign it to mat
+   void AllocMat();
+
 public:
    MixedBilinearForm (FiniteElementSpace *tr_fes,
                       FiniteElementSpace *te_fes);
 
+   /** Precompute the sparsity pattern of the matrix from the element-to-dof
+       tables of the trial and test spaces, so that the matrix is allocated
+       once in CSR format before assembly. Not used with trace face
+       integrators. */
+   void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
+
    virtual double& Elem (int i, int j);
 
    virtual const double& Elem (int i, int j) const;
@@ -62,9 +62,486 @@ void BilinearFormIntegrator::AssembleElementVector(
 }
 
 
+void BilinearFormIntegrator::UseGeometricFactors(Mesh *mesh)
+{
+   gf_mesh = mesh;
+   gf_last = NULL;
+   // the factors are computed for all the elements with the same rule
+   for (int i = 1; mesh && i < mesh->GetNE(); i++)
+      if (mesh->GetElementBaseGeometry(i) != mesh->GetElementBaseGeometry(0))
+      {
+         gf_mesh = NULL;
+         break;
+      }
+}
+
+const GeometricFactors *BilinearFormIntegrator::GetGeometricFactors(
+   const IntegrationRule &ir)
+{
+   if (gf_mesh == NULL)
+      return NULL;
+   if (gf_last == NULL || gf_last->IntRule != &ir)
+      gf_last = &gf_mesh->GetGeometricFactors(
+                   ir, GeometricFactors::JACOBIANS |
+                   GeometricFactors::DETERMINANTS);
+   return gf_last;
+}
+
+void BilinearFormIntegrator::AssemblePA(FiniteElementSpace &fes)
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+
+void PartialAssemblyData::Setup(FiniteElementSpace &f,
+                                const IntegrationRule *user_ir, int order)
+{
+   fes = &f;
+   ne = fes->GetNE();
+   MFEM_VERIFY(ne > 0, "the FE space has no elements");
+   MFEM_VERIFY(fes->GetVDim() == 1, "vector FE spaces are not supported");
+
+   const FiniteElement &el = *fes->GetFE(0);
+   for (int e = 1; e < ne; e++)
+      MFEM_VERIFY(fes->GetFE(e) == &el,
+                  "all elements must use the same finite element");
+   dim = el.GetDim();
+   nd = el.GetDof();
+   fes->BuildElementToDofTable();
+
+   if (user_ir)
+      ir = user_ir;
+   else if (el.Space() == FunctionSpace::rQk)
+      ir = &RefinedIntRules.Get(el.GetGeomType(), order);
+   else
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   nq = ir->GetNPoints();
+
+   const TensorBasisElement *tbe =
+      dynamic_cast<const TensorBasisElement *>(&el);
+   IntegrationRule ir1d;
+   tensor = (tbe && TensorBasisElement::Get1DRule(*ir, dim, ir1d));
+   const int mode = tensor ? DofToQuad::TENSOR : DofToQuad::FULL;
+   delete own_maps;
+   own_maps = NULL;
+   if (el.CanCacheDofToQuad(*ir))
+      maps = &el.GetDofToQuad(*ir, mode);
+   else
+      maps = own_maps = el.NewDofToQuad(*ir, mode);
+   if (tensor)
+   {
+      nd1 = maps->ndof;
+      nq1 = maps->nqpt;
+      dof_map = tbe->GetDofMap().Size() ? &tbe->GetDofMap() : NULL;
+   }
+   else
+   {
+      nd1 = nq1 = 0;
+      dof_map = NULL;
+   }
+}
+
+int PartialAssemblyData::WorkSize() const
+{
+   if (!tensor)
+      return 0;
+   if (dim == 2)
+      return 2*nq1*nd1 + 2*nq1*nq1;
+   return 2*nq1*nd1*nd1 + 3*nq1*nq1*nd1 + 3*nq1*nq1*nq1;
+}
+
+void PartialAssemblyData::GetElementVector(int e, const Vector &x,
+                                           Vector &xe) const
+{
+   const int *dofs = fes->GetElementToDofTable().GetRow(e);
+   for (int i = 0; i < nd; i++)
+   {
+      const int j = dofs[dof_map ? (*dof_map)[i] : i];
+      xe(i) = (j >= 0) ? x(j) : -x(-1-j);
+   }
+}
+
+void PartialAssemblyData::AddElementVector(int e, const Vector &ye,
+                                           Vector &y) const
+{
+   const int *dofs = fes->GetElementToDofTable().GetRow(e);
+   for (int i = 0; i < nd; i++)
+   {
+      const int j = dofs[dof_map ? (*dof_map)[i] : i];
+      if (j >= 0)
+         y(j) += ye(i);
+      else
+         y(-1-j) -= ye(i);
+   }
+}
+
+void PartialAssemblyData::MassTensor2D(const double *d, const double *x,
+                                       double *y, double *w) const
+{
+   const int D1 = nd1, Q1 = nq1;
+   const double *B = maps->B.Data();
+   double *A = w, *U = w + Q1*D1;
+
+   // A(qx,dy) = sum_dx B(qx,dx) x(dx,dy)
+   for (int dy = 0; dy < D1; dy++)
+      for (int qx = 0; qx < Q1; qx++)
+      {
+         double s = 0.0;
+         for (int dx = 0; dx < D1; dx++)
+            s += B[qx+Q1*dx]*x[dx+D1*dy];
+         A[qx+Q1*dy] = s;
+      }
+   // U(qx,qy) = d(qx,qy) sum_dy B(qy,dy) A(qx,dy)
+   for (int qy = 0; qy < Q1; qy++)
+      for (int qx = 0; qx < Q1; qx++)
+      {
+         double s = 0.0;
+         for (int dy = 0; dy < D1; dy++)
+            s += B[qy+Q1*dy]*A[qx+Q1*dy];
+         U[qx+Q1*qy] = d[qx+Q1*qy]*s;
+      }
+   // A(qx,dy) = sum_qy B(qy,dy) U(qx,qy)
+   for (int dy = 0; dy < D1; dy++)
+      for (int qx = 0; qx < Q1; qx++)
+      {
+         double s = 0.0;
+         for (int qy = 0; qy < Q1; qy++)
+            s += B[qy+Q1*dy]*U[qx+Q1*qy];
+         A[qx+Q1*dy] = s;
+      }
+   // y(dx,dy) += sum_qx B(qx,dx) A(qx,dy)
+   for (int dy = 0; dy < D1; dy++)
+      for (int dx = 0; dx < D1; dx++)
+      {
+         double s = 0.0;
+         for (int qx = 0; qx < Q1; qx++)
+            s += B[qx+Q1*dx]*A[qx+Q1*dy];
+         y[dx+D1*dy] += s;
+      }
+}
+
+void PartialAssemblyData::MassTensor3D(const double *d, const double *x,
+                                       double *y, double *w) const
+{
+   const int D1 = nd1, Q1 = nq1;
+   const double *B = maps->B.Data();
+   double *A1 = w, *A2 = A1 + Q1*D1*D1, *U = A2 + Q1*Q1*D1;
+
+   // A1(qx,dy,dz) = sum_dx B(qx,dx) x(dx,dy,dz)
+   for (int dz = 0; dz < D1; dz++)
+      for (int dy = 0; dy < D1; dy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double s = 0.0;
+            for (int dx = 0; dx < D1; dx++)
+               s += B[qx+Q1*dx]*x[dx+D1*(dy+D1*dz)];
+            A1[qx+Q1*(dy+D1*dz)] = s;
+         }
+   // A2(qx,qy,dz) = sum_dy B(qy,dy) A1(qx,dy,dz)
+   for (int dz = 0; dz < D1; dz++)
+      for (int qy = 0; qy < Q1; qy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double s = 0.0;
+            for (int dy = 0; dy < D1; dy++)
+               s += B[qy+Q1*dy]*A1[qx+Q1*(dy+D1*dz)];
+            A2[qx+Q1*(qy+Q1*dz)] = s;
+         }
+   // U(qx,qy,qz) = d(qx,qy,qz) sum_dz B(qz,dz) A2(qx,qy,dz)
+   for (int qz = 0; qz < Q1; qz++)
+      for (int qy = 0; qy < Q1; qy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double s = 0.0;
+            for (int dz = 0; dz < D1; dz++)
+               s += B[qz+Q1*dz]*A2[qx+Q1*(qy+Q1*dz)];
+            const int q = qx+Q1*(qy+Q1*qz);
+            U[q] = d[q]*s;
+         }
+   // Apply the transposed contractions in reverse order
+   for (int dz = 0; dz < D1; dz++)
+      for (int qy = 0; qy < Q1; qy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double s = 0.0;
+            for (int qz = 0; qz < Q1; qz++)
+               s += B[qz+Q1*dz]*U[qx+Q1*(qy+Q1*qz)];
+            A2[qx+Q1*(qy+Q1*dz)] = s;
+         }
+   for (int dz = 0; dz < D1; dz++)
+      for (int dy = 0; dy < D1; dy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double s = 0.0;
+            for (int qy = 0; qy < Q1; qy++)
+               s += B[qy+Q1*dy]*A2[qx+Q1*(qy+Q1*dz)];
+            A1[qx+Q1*(dy+D1*dz)] = s;
+         }
+   for (int dz = 0; dz < D1; dz++)
+      for (int dy = 0; dy < D1; dy++)
+         for (int dx = 0; dx < D1; dx++)
+         {
+            double s = 0.0;
+            for (int qx = 0; qx < Q1; qx++)
+               s += B[qx+Q1*dx]*A1[qx+Q1*(dy+D1*dz)];
+            y[dx+D1*(dy+D1*dz)] += s;
+         }
+}
+
+void PartialAssemblyData::DiffusionTensor2D(const double *d, const double *x,
+                                            double *y, double *w) const
+{
+   const int D1 = nd1, Q1 = nq1;
+   const double *B = maps->B.Data(), *G = maps->G.Data();
+   double *Ab = w, *Ag = Ab + Q1*D1, *V0 = Ag + Q1*D1, *V1 = V0 + Q1*Q1;
+
+   // Ab(qx,dy) = sum_dx B(qx,dx) x(dx,dy), Ag -- same with G
+   for (int dy = 0; dy < D1; dy++)
+      for (int qx = 0; qx < Q1; qx++)
+      {
+         double sb = 0.0, sg = 0.0;
+         for (int dx = 0; dx < D1; dx++)
+         {
+            const double xv = x[dx+D1*dy];
+            sb += B[qx+Q1*dx]*xv;
+            sg += G[qx+Q1*dx]*xv;
+         }
+         Ab[qx+Q1*dy] = sb;
+         Ag[qx+Q1*dy] = sg;
+      }
+   // reference gradient at the points, multiplied by the 2x2 matrix d
+   for (int qy = 0; qy < Q1; qy++)
+      for (int qx = 0; qx < Q1; qx++)
+      {
+         double u0 = 0.0, u1 = 0.0;
+         for (int dy = 0; dy < D1; dy++)
+         {
+            u0 += B[qy+Q1*dy]*Ag[qx+Q1*dy];
+            u1 += G[qy+Q1*dy]*Ab[qx+Q1*dy];
+         }
+         const int q = qx+Q1*qy;
+         const double *dq = d + 4*q;
+         V0[q] = dq[0]*u0 + dq[2]*u1;
+         V1[q] = dq[1]*u0 + dq[3]*u1;
+      }
+   // Ag(qx,dy) = sum_qy B(qy,dy) V0(qx,qy), Ab(qx,dy) = sum_qy G(qy,dy) V1
+   for (int dy = 0; dy < D1; dy++)
+      for (int qx = 0; qx < Q1; qx++)
+      {
+         double sg = 0.0, sb = 0.0;
+         for (int qy = 0; qy < Q1; qy++)
+         {
+            sg += B[qy+Q1*dy]*V0[qx+Q1*qy];
+            sb += G[qy+Q1*dy]*V1[qx+Q1*qy];
+         }
+         Ag[qx+Q1*dy] = sg;
+         Ab[qx+Q1*dy] = sb;
+      }
+   for (int dy = 0; dy < D1; dy++)
+      for (int dx = 0; dx < D1; dx++)
+      {
+         double s = 0.0;
+         for (int qx = 0; qx < Q1; qx++)
+            s += G[qx+Q1*dx]*Ag[qx+Q1*dy] + B[qx+Q1*dx]*Ab[qx+Q1*dy];
+         y[dx+D1*dy] += s;
+      }
+}
+
+void PartialAssemblyData::DiffusionTensor3D(const double *d, const double *x,
+                                            double *y, double *w) const
+{
+   const int D1 = nd1, Q1 = nq1;
+   const double *B = maps->B.Data(), *G = maps->G.Data();
+   double *Ab = w, *Ag = Ab + Q1*D1*D1;
+   double *Abb = Ag + Q1*D1*D1, *Abg = Abb + Q1*Q1*D1, *Agb = Abg + Q1*Q1*D1;
+   double *V0 = Agb + Q1*Q1*D1, *V1 = V0 + Q1*Q1*Q1, *V2 = V1 + Q1*Q1*Q1;
+
+   // contract in x: Ab = B_x x, Ag = G_x x
+   for (int dz = 0; dz < D1; dz++)
+      for (int dy = 0; dy < D1; dy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double sb = 0.0, sg = 0.0;
+            for (int dx = 0; dx < D1; dx++)
+            {
+               const double xv = x[dx+D1*(dy+D1*dz)];
+               sb += B[qx+Q1*dx]*xv;
+               sg += G[qx+Q1*dx]*xv;
+            }
+            Ab[qx+Q1*(dy+D1*dz)] = sb;
+            Ag[qx+Q1*(dy+D1*dz)] = sg;
+         }
+   // contract in y: Abb = B_y Ab, Abg = B_y Ag, Agb = G_y Ab
+   for (int dz = 0; dz < D1; dz++)
+      for (int qy = 0; qy < Q1; qy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double bb = 0.0, bg = 0.0, gb = 0.0;
+            for (int dy = 0; dy < D1; dy++)
+            {
+               const double ab = Ab[qx+Q1*(dy+D1*dz)];
+               const double ag = Ag[qx+Q1*(dy+D1*dz)];
+               bb += B[qy+Q1*dy]*ab;
+               bg += B[qy+Q1*dy]*ag;
+               gb += G[qy+Q1*dy]*ab;
+            }
+            const int i = qx+Q1*(qy+Q1*dz);
+            Abb[i] = bb;
+            Abg[i] = bg;
+            Agb[i] = gb;
+         }
+   // contract in z to get the reference gradient and multiply by d
+   for (int qz = 0; qz < Q1; qz++)
+      for (int qy = 0; qy < Q1; qy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double u0 = 0.0, u1 = 0.0, u2 = 0.0;
+            for (int dz = 0; dz < D1; dz++)
+            {
+               const int i = qx+Q1*(qy+Q1*dz);
+               u0 += B[qz+Q1*dz]*Abg[i];
+               u1 += B[qz+Q1*dz]*Agb[i];
+               u2 += G[qz+Q1*dz]*Abb[i];
+            }
+            const int q = qx+Q1*(qy+Q1*qz);
+            const double *dq = d + 9*q;
+            V0[q] = dq[0]*u0 + dq[3]*u1 + dq[6]*u2;
+            V1[q] = dq[1]*u0 + dq[4]*u1 + dq[7]*u2;
+            V2[q] = dq[2]*u0 + dq[5]*u1 + dq[8]*u2;
+         }
+   // transposed contraction in z (reuse Abg, Agb, Abb)
+   for (int dz = 0; dz < D1; dz++)
+      for (int qy = 0; qy < Q1; qy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double c0 = 0.0, c1 = 0.0, c2 = 0.0;
+            for (int qz = 0; qz < Q1; qz++)
+            {
+               const int q = qx+Q1*(qy+Q1*qz);
+               c0 += B[qz+Q1*dz]*V0[q];
+               c1 += B[qz+Q1*dz]*V1[q];
+               c2 += G[qz+Q1*dz]*V2[q];
+            }
+            const int i = qx+Q1*(qy+Q1*dz);
+            Abg[i] = c0;
+            Agb[i] = c1;
+            Abb[i] = c2;
+         }
+   // transposed contraction in y (reuse Ag, Ab)
+   for (int dz = 0; dz < D1; dz++)
+      for (int dy = 0; dy < D1; dy++)
+         for (int qx = 0; qx < Q1; qx++)
+         {
+            double sg = 0.0, sb = 0.0;
+            for (int qy = 0; qy < Q1; qy++)
+            {
+               const int i = qx+Q1*(qy+Q1*dz);
+               sg += B[qy+Q1*dy]*Abg[i];
+               sb += G[qy+Q1*dy]*Agb[i] + B[qy+Q1*dy]*Abb[i];
+            }
+            Ag[qx+Q1*(dy+D1*dz)] = sg;
+            Ab[qx+Q1*(dy+D1*dz)] = sb;
+         }
+   // transposed contraction in x
+   for (int dz = 0; dz < D1; dz++)
+      for (int dy = 0; dy < D1; dy++)
+         for (int dx = 0; dx < D1; dx++)
+         {
+            double s = 0.0;
+            for (int qx = 0; qx < Q1; qx++)
+            {
+               const int i = qx+Q1*(dy+D1*dz);
+               s += G[qx+Q1*dx]*Ag[i] + B[qx+Q1*dx]*Ab[i];
+            }
+            y[dx+D1*(dy+D1*dz)] += s;
+         }
+}
+
+void PartialAssemblyData::AddMultMass(const Vector &x, Vector &y) const
+{
+   Vector xe(nd), ye(nd), u(tensor ? 0 : nq), work(WorkSize());
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *d = D.GetData() + e*nq;
+      GetElementVector(e, x, xe);
+      if (tensor)
+      {
+         ye = 0.0;
+         if (dim == 2)
+            MassTensor2D(d, xe, ye, work);
+         else
+            MassTensor3D(d, xe, ye, work);
+      }
+      else
+      {
+         maps->B.Mult(xe, u);
+         for (int q = 0; q < nq; q++)
+            u(q) *= d[q];
+         maps->B.MultTranspose(u, ye);
+      }
+      AddElementVector(e, ye, y);
+   }
+}
+
+void PartialAssemblyData::AddMultDiffusion(const Vector &x, Vector &y) const
+{
+   const int dd = dim*dim;
+   Vector xe(nd), ye(nd), u(dim), v(dim), work(WorkSize());
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *d = D.GetData() + e*nq*dd;
+      GetElementVector(e, x, xe);
+      ye = 0.0;
+      if (tensor)
+      {
+         if (dim == 2)
+            DiffusionTensor2D(d, xe, ye, work);
+         else
+            DiffusionTensor3D(d, xe, ye, work);
+      }
+      else
+      {
+         for (int q = 0; q < nq; q++)
+         {
+            // u = G_q^t xe, v = D_q u, ye += G_q v
+            const double *Gq = maps->G.GetData(q), *dq = d + q*dd;
+            for (int k = 0; k < dim; k++)
+            {
+               double s = 0.0;
+               for (int i = 0; i < nd; i++)
+                  s += Gq[i+nd*k]*xe(i);
+               u(k) = s;
+            }
+            for (int k = 0; k < dim; k++)
+            {
+               double s = 0.0;
+               for (int l = 0; l < dim; l++)
+                  s += dq[k+dim*l]*u(l);
+               v(k) = s;
+            }
+            for (int k = 0; k < dim; k++)
+               for (int i = 0; i < nd; i++)
+                  ye(i) += Gq[i+nd*k]*v(k);
+         }
+      }
+      AddElementVector(e, ye, y);
+   }
+}
+
+
 void TransposeIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans, DenseMatrix &elmat)
 {
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix bfi_elmat;
+#endif
    bfi -> AssembleElementMatrix (el, Trans, bfi_elmat);
    // elmat = bfi_elmat^t
    elmat.Transpose (bfi_elmat);
@@ -74,6 +551,9 @@ void TransposeIntegrator::AssembleElementMatrix2 (
    const FiniteElement &trial_fe, const FiniteElement &test_fe,
    ElementTransformation &Trans, DenseMatrix &elmat)
 {
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix bfi_elmat;
+#endif
    bfi -> AssembleElementMatrix2 (test_fe, trial_fe, Trans, bfi_elmat);
    // elmat = bfi_elmat^t
    elmat.Transpose (bfi_elmat);
@@ -83,11 +563,20 @@ void TransposeIntegrator::AssembleFaceMatrix (
    const FiniteElement &el1, const FiniteElement &el2,
    FaceElementTransformations &Trans, DenseMatrix &elmat)
 {
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix bfi_elmat;
+#endif
    bfi -> AssembleFaceMatrix (el1, el2, Trans, bfi_elmat);
    // elmat = bfi_elmat^t
    elmat.Transpose (bfi_elmat);
 }
 
+BilinearFormIntegrator *TransposeIntegrator::Clone() const
+{
+   BilinearFormIntegrator *bfi_copy = bfi->Clone();
+   return bfi_copy ? new TransposeIntegrator(bfi_copy, 1) : NULL;
+}
+
 void LumpedIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans, DenseMatrix &elmat)
 {
@@ -107,6 +596,9 @@ void SumIntegrator::AssembleElementMatrix(
 {
    MFEM_ASSERT(integrators.Size() > 0, "empty SumIntegrator.");
 
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix elem_mat;
+#endif
    integrators[0]->AssembleElementMatrix(el, Trans, elmat);
    for (int i = 1; i < integrators.Size(); i++)
    {
@@ -115,6 +607,22 @@ void SumIntegrator::AssembleElementMatrix(
    }
 }
 
+BilinearFormIntegrator *SumIntegrator::Clone() const
+{
+   SumIntegrator *sum = new SumIntegrator(1);
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      BilinearFormIntegrator *integ = integrators[i]->Clone();
+      if (integ == NULL)
+      {
+         delete sum;
+         return NULL;
+      }
+      sum->AddIntegrator(integ);
+   }
+   return sum;
+}
+
 SumIntegrator::~SumIntegrator()
 {
    if (own_integrators)
@@ -137,6 +645,8 @@ void DiffusionIntegrator::AssembleElementMatrix
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix dshape(nd,dim), dshapedxt(nd,spaceDim), invdfdx(dim,spaceDim);
+   Vector q_ir;
+   DenseTensor mq_ir;
 #else
    dshape.SetSize(nd,dim);
    dshapedxt.SetSize(nd,spaceDim);
@@ -160,33 +670,65 @@ void DiffusionIntegrator::AssembleElementMatrix
          ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the cached basis tables for the whole rule (NULL for NURBS elements)
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+   // the cached Jacobians of the mesh, if available
+   const GeometricFactors *geom = GetGeometricFactors(*ir);
+   const int nq = ir->GetNPoints(), eq0 = Trans.ElementNo*nq;
+   DenseMatrix Jq;
+
+   // the coefficients at all the points
+   if (MQ)
+      MQ->Eval(mq_ir, Trans, *ir);
+   else if (Q)
+      Q->Eval(q_ir, Trans, *ir);
+
    elmat = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   for (int i = 0; i < nq; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
+      if (maps)
+      {
+         dshape.SetSize(nd, dim);
+         dshape = maps->G.GetData(i);
+      }
+      else
+         el.CalcDShape(ip, dshape);
 
-      Trans.SetIntPoint(&ip);
+      const DenseMatrix *J = &Jq;
+      if (geom)
+      {
+         Jq.UseExternalData(geom->J.GetData() + (eq0+i)*spaceDim*dim,
+                            spaceDim, dim);
+         w = geom->detJ(eq0+i);
+      }
+      else
+      {
+         Trans.SetIntPoint(&ip);
+         J = &Trans.Jacobian();
+         w = Trans.Weight();
+      }
       // Compute invdfdx = / adj(J),         if J is square
       //                   \ adj(J^t.J).J^t, otherwise
-      CalcAdjugate(Trans.Jacobian(), invdfdx);
-      w = Trans.Weight();
+      CalcAdjugate(*J, invdfdx);
       w = ip.weight / (square ? w : w*w*w);
       Mult(dshape, invdfdx, dshapedxt);
       if (!MQ)
       {
          if (Q)
-            w *= Q->Eval(Trans, ip);
+            w *= q_ir(i);
          AddMult_a_AAt(w, dshapedxt, elmat);
       }
       else
       {
-         MQ->Eval(invdfdx, Trans, ip);
-         invdfdx *= w;
-         Mult(dshapedxt, invdfdx, dshape);
+         DenseMatrix &K = mq_ir(i);
+         K *= w;
+         Mult(dshapedxt, K, dshape);
          AddMultABt(dshape, dshapedxt, elmat);
       }
    }
+   if (geom)
+      Jq.ClearExternalData();
 }
 
 void DiffusionIntegrator::AssembleElementMatrix2(
@@ -204,6 +746,8 @@ void DiffusionIntegrator::AssembleElementMatrix2(
    DenseMatrix dshape(tr_nd, dim), dshapedxt(tr_nd, spaceDim);
    DenseMatrix te_dshape(te_nd, dim), te_dshapedxt(te_nd, spaceDim);
    DenseMatrix invdfdx(dim, spaceDim);
+   Vector q_ir;
+   DenseTensor mq_ir;
 #else
    dshape.SetSize(tr_nd, dim);
    dshapedxt.SetSize(tr_nd, spaceDim);
@@ -228,12 +772,32 @@ void DiffusionIntegrator::AssembleElementMatrix2(
          ir = &IntRules.Get(trial_fe.GetGeomType(), order);
    }
 
+   if (MQ)
+      MQ->Eval(mq_ir, Trans, *ir);
+   else if (Q)
+      Q->Eval(q_ir, Trans, *ir);
+
+   const DofToQuad *tr_maps = trial_fe.GetFullDofToQuad(*ir);
+   const DofToQuad *te_maps = test_fe.GetFullDofToQuad(*ir);
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      trial_fe.CalcDShape(ip, dshape);
-      test_fe.CalcDShape(ip, te_dshape);
+      if (tr_maps)
+      {
+         dshape.SetSize(tr_nd, dim);
+         dshape = tr_maps->G.GetData(i);
+      }
+      else
+         trial_fe.CalcDShape(ip, dshape);
+      if (te_maps)
+      {
+         te_dshape.SetSize(te_nd, dim);
+         te_dshape = te_maps->G.GetData(i);
+      }
+      else
+         test_fe.CalcDShape(ip, te_dshape);
 
       Trans.SetIntPoint(&ip);
       CalcAdjugate(Trans.Jacobian(), invdfdx);
@@ -245,15 +809,15 @@ void DiffusionIntegrator::AssembleElementMatrix2(
       if (!MQ)
       {
          if (Q)
-            w *= Q->Eval(Trans, ip);
+            w *= q_ir(i);
          dshapedxt *= w;
          AddMultABt(te_dshapedxt, dshapedxt, elmat);
       }
       else
       {
-         MQ->Eval(invdfdx, Trans, ip);
-         invdfdx *= w;
-         Mult(te_dshapedxt, invdfdx, te_dshape);
+         DenseMatrix &K = mq_ir(i);
+         K *= w;
+         Mult(te_dshapedxt, K, te_dshape);
          AddMultABt(te_dshape, dshapedxt, elmat);
       }
    }
@@ -438,6 +1002,68 @@ double DiffusionIntegrator::ComputeFluxEnergy
    return energy;
 }
 
+void DiffusionIntegrator::AssemblePA(FiniteElementSpace &fes)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   const int dim = el.GetDim();
+   int order;
+   if (el.Space() == FunctionSpace::Pk)
+      order = 2*el.GetOrder() - 2;
+   else
+      order = 2*el.GetOrder() + dim - 1;
+
+   if (pa == NULL)
+      pa = new PartialAssemblyData;
+   pa->Setup(fes, IntRule, order);
+
+   const IntegrationRule &ir = pa->GetIntRule();
+   const int ne = pa->GetNE(), nq = pa->GetNQ(), dd = dim*dim;
+   const GeometricFactors &geom = fes.GetMesh()->GetGeometricFactors(
+      ir, GeometricFactors::JACOBIANS | GeometricFactors::DETERMINANTS);
+   MFEM_VERIFY(geom.sdim == dim, "surface meshes are not supported");
+   DenseMatrix J, adj(dim), amq(dim), Dq;
+   Vector q_ir;
+   DenseTensor mq_ir;
+   pa->D.SetSize(ne*nq*dd);
+   for (int e = 0; e < ne; e++)
+   {
+      // the transformation is only needed by the coefficients
+      if (MQ)
+         MQ->Eval(mq_ir, *fes.GetElementTransformation(e), ir);
+      else if (Q)
+         Q->Eval(q_ir, *fes.GetElementTransformation(e), ir);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         const int eq = e*nq + q;
+         J.UseExternalData(geom.J.GetData() + eq*dd, dim, dim);
+         CalcAdjugate(J, adj);
+         const double w = ip.weight / geom.detJ(eq);
+         // D_q = w adj(J) Q adj(J)^t
+         Dq.UseExternalData(pa->D.GetData() + eq*dd, dim, dim);
+         if (MQ)
+         {
+            DenseMatrix &mq = mq_ir(q);
+            mq *= w;
+            Mult(adj, mq, amq);
+            MultABt(amq, adj, Dq);
+         }
+         else
+         {
+            Mult_a_AAt(Q ? w*q_ir(q) : w, adj, Dq);
+         }
+      }
+   }
+   J.ClearExternalData();
+   Dq.ClearExternalData();
+}
+
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(pa, "AssemblePA() has not been called");
+   pa->AddMultDiffusion(x, y);
+}
+
 
 void MassIntegrator::AssembleElementMatrix
 ( const FiniteElement &el, ElementTransformation &Trans,
@@ -448,7 +1074,11 @@ void MassIntegrator::AssembleElementMatrix
    double w;
 
    elmat.SetSize(nd);
+#ifdef MFEM_THREAD_SAFE
+   Vector shape(nd), q_ir;
+#else
    shape.SetSize(nd);
+#endif
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -462,16 +1092,35 @@ void MassIntegrator::AssembleElementMatrix
          ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the cached basis tables for the whole rule (NULL for NURBS elements)
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+   // the cached Jacobian determinants of the mesh, if available
+   const GeometricFactors *geom = GetGeometricFactors(*ir);
+   const double *detJ = NULL;
+   if (geom)
+      detJ = geom->detJ.GetData() + Trans.ElementNo*ir->GetNPoints();
+
+   if (Q)
+      Q->Eval(q_ir, Trans, *ir);
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcShape(ip, shape);
+      if (maps)
+         maps->B.GetRow(i, shape);
+      else
+         el.CalcShape(ip, shape);
 
-      Trans.SetIntPoint (&ip);
-      w = Trans.Weight() * ip.weight;
+      if (detJ)
+         w = detJ[i] * ip.weight;
+      else
+      {
+         Trans.SetIntPoint (&ip);
+         w = Trans.Weight() * ip.weight;
+      }
       if (Q)
-         w *= Q -> Eval(Trans, ip);
+         w *= q_ir(i);
 
       AddMult_a_VVt(w, shape, elmat);
    }
@@ -487,8 +1136,12 @@ void MassIntegrator::AssembleElementMatrix2(
    double w;
 
    elmat.SetSize (te_nd, tr_nd);
+#ifdef MFEM_THREAD_SAFE
+   Vector shape(tr_nd), te_shape(te_nd), q_ir;
+#else
    shape.SetSize (tr_nd);
    te_shape.SetSize (te_nd);
+#endif
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -498,23 +1151,72 @@ void MassIntegrator::AssembleElementMatrix2(
       ir = &IntRules.Get(trial_fe.GetGeomType(), order);
    }
 
+   if (Q)
+      Q->Eval(q_ir, Trans, *ir);
+
+   const DofToQuad *tr_maps = trial_fe.GetFullDofToQuad(*ir);
+   const DofToQuad *te_maps = test_fe.GetFullDofToQuad(*ir);
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      trial_fe.CalcShape(ip, shape);
-      test_fe.CalcShape(ip, te_shape);
+      if (tr_maps)
+         tr_maps->B.GetRow(i, shape);
+      else
+         trial_fe.CalcShape(ip, shape);
+      if (te_maps)
+         te_maps->B.GetRow(i, te_shape);
+      else
+         test_fe.CalcShape(ip, te_shape);
 
       Trans.SetIntPoint (&ip);
       w = Trans.Weight() * ip.weight;
       if (Q)
-         w *= Q -> Eval(Trans, ip);
+         w *= q_ir(i);
 
       te_shape *= w;
       AddMultVWt(te_shape, shape, elmat);
    }
 }
 
+void MassIntegrator::AssemblePA(FiniteElementSpace &fes)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   const int order =
+      2*el.GetOrder() + fes.GetElementTransformation(0)->OrderW();
+
+   if (pa == NULL)
+      pa = new PartialAssemblyData;
+   pa->Setup(fes, IntRule, order);
+
+   const IntegrationRule &ir = pa->GetIntRule();
+   const int ne = pa->GetNE(), nq = pa->GetNQ();
+   const GeometricFactors &geom = fes.GetMesh()->GetGeometricFactors(
+      ir, GeometricFactors::DETERMINANTS);
+   Vector q_ir;
+   pa->D.SetSize(ne*nq);
+   for (int e = 0; e < ne; e++)
+   {
+      const double *detJ = geom.detJ.GetData() + e*nq;
+      double *d = pa->D.GetData() + e*nq;
+      for (int q = 0; q < nq; q++)
+         d[q] = detJ[q] * ir.IntPoint(q).weight;
+      if (Q)
+      {
+         Q->Eval(q_ir, *fes.GetElementTransformation(e), ir);
+         for (int q = 0; q < nq; q++)
+            d[q] *= q_ir(q);
+      }
+   }
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(pa, "AssemblePA() has not been called");
+   pa->AddMultMass(x, y);
+}
+
 
 void ConvectionIntegrator::AssembleElementMatrix(
    const FiniteElement &el, ElementTransformation &Trans, DenseMatrix &elmat)
@@ -523,11 +1225,16 @@ void ConvectionIntegrator::AssembleElementMatrix(
    int dim = el.GetDim();
 
    elmat.SetSize(nd);
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix dshape(nd,dim), adjJ(dim), Q_ir;
+   Vector shape(nd), vec2(dim), BdFidxT(nd);
+#else
    dshape.SetSize(nd,dim);
    adjJ.SetSize(dim);
    shape.SetSize(nd);
    vec2.SetSize(dim);
    BdFidxT.SetSize(nd);
+#endif
 
    Vector vec1;
 
@@ -540,6 +1247,11 @@ void ConvectionIntegrator::AssembleElementMatrix(
 
    Q.Eval(Q_ir, Trans, *ir);
 
+   // the cached Jacobians of the mesh, if available
+   const GeometricFactors *geom = GetGeometricFactors(*ir);
+   const int eq0 = Trans.ElementNo*ir->GetNPoints();
+   DenseMatrix Jq;
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
@@ -547,8 +1259,17 @@ void ConvectionIntegrator::AssembleElementMatrix(
       el.CalcDShape(ip, dshape);
       el.CalcShape(ip, shape);
 
-      Trans.SetIntPoint(&ip);
-      CalcAdjugate(Trans.Jacobian(), adjJ);
+      if (geom)
+      {
+         Jq.UseExternalData(geom->J.GetData() + (eq0+i)*geom->sdim*dim,
+                            geom->sdim, dim);
+         CalcAdjugate(Jq, adjJ);
+      }
+      else
+      {
+         Trans.SetIntPoint(&ip);
+         CalcAdjugate(Trans.Jacobian(), adjJ);
+      }
       Q_ir.GetColumnReference(i, vec1);
       vec1 *= alpha * ip.weight;
 
@@ -557,6 +1278,8 @@ void ConvectionIntegrator::AssembleElementMatrix(
 
       AddMultVWt(shape, BdFidxT, elmat);
    }
+   if (geom)
+      Jq.ClearExternalData();
 }
 
 
@@ -567,10 +1290,15 @@ void GroupConvectionIntegrator::AssembleElementMatrix(
    int dim = el.GetDim();
 
    elmat.SetSize(nd);
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix dshape(nd,dim), adjJ(dim), Q_nodal, grad(nd,dim);
+   Vector shape(nd);
+#else
    dshape.SetSize(nd,dim);
    adjJ.SetSize(dim);
    shape.SetSize(nd);
    grad.SetSize(nd,dim);
+#endif
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -625,8 +1353,13 @@ void VectorMassIntegrator::AssembleElementMatrix
    vdim = (VQ) ? (VQ -> GetVDim()) : ((MQ) ? (MQ -> GetVDim()) : (dim));
 
    elmat.SetSize(nd*vdim);
+#ifdef MFEM_THREAD_SAFE
+   Vector shape(nd), vec;
+   DenseMatrix partelmat(nd), mcoeff;
+#else
    shape.SetSize(nd);
    partelmat.SetSize(nd);
+#endif
    if (VQ)
       vec.SetSize(vdim);
    else if (MQ)
@@ -693,9 +1426,14 @@ void VectorMassIntegrator::AssembleElementMatrix2(
    vdim = (VQ) ? (VQ -> GetVDim()) : ((MQ) ? (MQ -> GetVDim()) : (dim));
 
    elmat.SetSize(te_nd*vdim, tr_nd*vdim);
+#ifdef MFEM_THREAD_SAFE
+   Vector shape(tr_nd), te_shape(te_nd), vec;
+   DenseMatrix partelmat(te_nd, tr_nd), mcoeff;
+#else
    shape.SetSize(tr_nd);
    te_shape.SetSize(te_nd);
    partelmat.SetSize(te_nd, tr_nd);
+#endif
    if (VQ)
       vec.SetSize(vdim);
    else if (MQ)
@@ -844,11 +1582,16 @@ void DerivativeIntegrator::AssembleElementMatrix2 (
    double det;
 
    elmat.SetSize (test_nd,trial_nd);
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix dshape(trial_nd,dim), dshapedxt(trial_nd,dim), invdfdx(dim);
+   Vector shape(test_nd), dshapedxi(trial_nd);
+#else
    dshape.SetSize (trial_nd,dim);
    dshapedxt.SetSize(trial_nd,dim);
    dshapedxi.SetSize(trial_nd);
    invdfdx.SetSize(dim);
    shape.SetSize (test_nd);
+#endif
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -914,11 +1657,17 @@ void CurlCurlIntegrator::AssembleElementMatrix
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the cached reference curls (NULL for NURBS elements)
+   const DofToQuad *maps = (dim == 3) ? el.GetFullDofToQuad(*ir) : NULL;
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcCurlShape(ip, Curlshape);
+      if (maps)
+         Curlshape = maps->C.GetData(i);
+      else
+         el.CalcCurlShape(ip, Curlshape);
 
       Trans.SetIntPoint (&ip);
 
@@ -1042,6 +1791,26 @@ double VectorCurlCurlIntegrator::GetElementEnergy(
 }
 
 
+// Map the reference vector shape functions 'ref' to the physical element at
+// the integration point of Trans, as in VectorFiniteElement::CalcVShape()
+static void MapVShape(int map_type, const DenseMatrix &ref,
+                      ElementTransformation &Trans, DenseMatrix &Jinv,
+                      DenseMatrix &shape)
+{
+   const DenseMatrix &J = Trans.Jacobian();
+   if (map_type == FiniteElement::H_DIV)
+   {
+      MultABt(ref, J, shape);
+      shape *= (1.0 / Trans.Weight());
+   }
+   else
+   {
+      Jinv.SetSize(J.Width(), J.Height());
+      CalcInverse(J, Jinv);
+      Mult(ref, Jinv, shape);
+   }
+}
+
 void VectorFEMassIntegrator::AssembleElementMatrix(
    const FiniteElement &el,
    ElementTransformation &Trans,
@@ -1054,7 +1823,7 @@ void VectorFEMassIntegrator::AssembleElementMatrix(
 
 #ifdef MFEM_THREAD_SAFE
    Vector D(VQ ? VQ->GetVDim() : 0);
-   DenseMatrix vshape(dof, dim);
+   DenseMatrix vshape(dof, dim), vshape_ref(dof, dim), Jinv;
    DenseMatrix K(MQ ? MQ->GetVDim() : 0, MQ ? MQ->GetVDim() : 0);
 #else
    vshape.SetSize(dof,dim);
@@ -1074,13 +1843,23 @@ void VectorFEMassIntegrator::AssembleElementMatrix(
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the cached reference shape functions (NULL for NURBS elements)
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Trans.SetIntPoint (&ip);
 
-      el.CalcVShape(Trans, vshape);
+      if (maps)
+      {
+         vshape_ref.SetSize(dof, dim);
+         vshape_ref = maps->V.GetData(i);
+         MapVShape(el.GetMapType(), vshape_ref, Trans, Jinv, vshape);
+      }
+      else
+         el.CalcVShape(Trans, vshape);
 
       w = ip.weight * Trans.Weight();
       if (MQ)
@@ -1175,11 +1954,16 @@ void VectorDivergenceIntegrator::AssembleElementMatrix2(
    int test_dof = test_fe.GetDof();
    double c;
 
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix dshape(trial_dof, dim), gshape(trial_dof, dim), Jadj(dim);
+   Vector divshape(dim*trial_dof), shape(test_dof);
+#else
    dshape.SetSize (trial_dof, dim);
    gshape.SetSize (trial_dof, dim);
    Jadj.SetSize (dim);
    divshape.SetSize (dim*trial_dof);
    shape.SetSize (test_dof);
+#endif
 
    elmat.SetSize (test_dof, dim*trial_dof);
 
@@ -1239,13 +2023,19 @@ void DivDivIntegrator::AssembleElementMatrix(
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the cached reference divergences (NULL for NURBS elements)
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+
    elmat = 0.0;
 
    for (int i = 0; i < ir -> GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
-      el.CalcDivShape (ip, divshape);
+      if (maps)
+         maps->D.GetRow(i, divshape);
+      else
+         el.CalcDivShape (ip, divshape);
 
       Trans.SetIntPoint (&ip);
       c = ip.weight / Trans.Weight();
@@ -1271,10 +2061,14 @@ void VectorDiffusionIntegrator::AssembleElementMatrix(
 
    elmat.SetSize (dim * dof);
 
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix Jinv(dim), dshape(dof, dim), gshape(dof, dim), pelmat(dof);
+#else
    Jinv.  SetSize (dim);
    dshape.SetSize (dof, dim);
    gshape.SetSize (dof, dim);
    pelmat.SetSize (dof);
+#endif
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
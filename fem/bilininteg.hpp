@@ -18,14 +18,96 @@
 namespace mfem
 {
 
+class FiniteElementSpace;
+
+/** Data used by the integrators that support partial assembly: the quadrature
+    rule, the values and reference gradients of the basis functions at the
+    quadrature points and the integrator-specific quadrature point data, D.
+    For tensor-product elements on quadrilaterals and hexahedra only the 1D
+    factors of the basis are stored and the operators are applied by sum
+    factorization in O(p^(dim+1)) operations per element. All elements of the
+    FE space must use the same (scalar) finite element. */
+class PartialAssemblyData
+{
+protected:
+   FiniteElementSpace *fes;
+   const IntegrationRule *ir;
+   int dim, ne, nd, nq;
+
+   /** Basis values and reference gradients at the quadrature points; in the
+       tensor-product case only the 1D factors (nq1 x nd1) are used. */
+   const DofToQuad *maps;
+   /// Uncached tables for a user rule, see FiniteElement::CanCacheDofToQuad()
+   DofToQuad *own_maps;
+   bool tensor;
+   int nd1, nq1;
+   /// Maps lexicographic to native dof ordering; NULL for the identity
+   const Array<int> *dof_map;
+
+   void GetElementVector(int e, const Vector &x, Vector &xe) const;
+   void AddElementVector(int e, const Vector &ye, Vector &y) const;
+
+   // Sum factorization kernels: y += A_e x for one element, where x and y use
+   // the lexicographic dof ordering and 'w' is work space of size WorkSize()
+   void MassTensor2D(const double *d, const double *x, double *y,
+                     double *w) const;
+   void MassTensor3D(const double *d, const double *x, double *y,
+                     double *w) const;
+   void DiffusionTensor2D(const double *d, const double *x, double *y,
+                          double *w) const;
+   void DiffusionTensor3D(const double *d, const double *x, double *y,
+                          double *w) const;
+   int WorkSize() const;
+
+public:
+   /** Quadrature point data: ne x nq blocks of size 1 (mass-type) or dim x dim
+       (diffusion-type, column-major). */
+   Vector D;
+
+   PartialAssemblyData()
+      : fes(NULL), ir(NULL), maps(NULL), own_maps(NULL), tensor(false),
+        dof_map(NULL) { }
+
+   /** Setup the basis data for the given FE space. If 'user_ir' is NULL, the
+       rule of the given order is used. Tensor-product elements use the sum
+       factorization kernels when the rule is a tensor-product rule. */
+   void Setup(FiniteElementSpace &f, const IntegrationRule *user_ir,
+              int order);
+
+   const IntegrationRule &GetIntRule() const { return *ir; }
+   int GetDim() const { return dim; }
+   int GetNE() const { return ne; }
+   int GetNQ() const { return nq; }
+   bool IsTensor() const { return tensor; }
+
+   /// y += A x, where D holds w*det(J)*Q at each point
+   void AddMultMass(const Vector &x, Vector &y) const;
+
+   /// y += A x, where D holds w/det(J)*adj(J)*Q*adj(J)^t at each point
+   void AddMultDiffusion(const Vector &x, Vector &y) const;
+
+   ~PartialAssemblyData() { delete own_maps; }
+};
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
 protected:
    const IntegrationRule *IntRule;
 
+   /// Mesh whose geometric factors are used, see UseGeometricFactors()
+   Mesh *gf_mesh;
+   /// The factors of gf_mesh for the last rule used
+   const GeometricFactors *gf_last;
+
    BilinearFormIntegrator(const IntegrationRule *ir = NULL)
-   { IntRule = ir; }
+   { IntRule = ir; gf_mesh = NULL; gf_last = NULL; }
+
+   /** Return the geometric factors (Jacobians and determinants) of the mesh
+       set by UseGeometricFactors() at the points of 'ir', or NULL if there is
+       no such mesh. The data of the element of a transformation T is at
+       T.ElementNo. */
+   const GeometricFactors *GetGeometricFactors(const IntegrationRule &ir);
 
 public:
    /// Given a particular Finite Element computes the element matrix elmat.
@@ -68,7 +150,31 @@ public:
                                     ElementTransformation &Trans,
                                     Vector &flux) { return 0.0; }
 
-   void SetIntRule(const IntegrationRule *ir) { IntRule = ir; }
+   /** Setup the integrator for partial assembly on the given FE space: only
+       the data at the quadrature points is computed and stored, see
+       BilinearForm::SetAssemblyLevel(). */
+   virtual void AssemblePA(FiniteElementSpace &fes);
+
+   /** Perform the action y += A x of the operator set up with AssemblePA() on
+       the global (unassembled) vectors of the FE space. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /** Return a new integrator with the same coefficients and rule but with
+       its own work space, or NULL if copying is not supported. The copies are
+       used by the multithreaded assembly in BilinearForm, one per thread, and
+       are deleted by the caller; the coefficients remain shared. */
+   virtual BilinearFormIntegrator *Clone() const { return NULL; }
+
+   void SetIntRule(const IntegrationRule *ir) { IntRule = ir; gf_last = NULL; }
+
+   /** Use the cached geometric factors of the given mesh, see
+       Mesh::GetGeometricFactors(), instead of the Jacobians of the element
+       transformations passed to AssembleElementMatrix(), which must then be
+       the transformations of the elements of the mesh. Passing NULL, or a
+       mesh with elements of different geometries, disables this. Set by
+       BilinearForm::Assemble() for its domain integrators; used by the
+       Mass, Diffusion and Convection integrators. */
+   void UseGeometricFactors(Mesh *mesh);
 
    virtual ~BilinearFormIntegrator() { }
 };
@@ -79,7 +185,9 @@ private:
    int own_bfi;
    BilinearFormIntegrator *bfi;
 
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix bfi_elmat;
+#endif
 
 public:
    TransposeIntegrator (BilinearFormIntegrator *_bfi, int _own_bfi = 1)
@@ -97,6 +205,7 @@ public:
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+   virtual BilinearFormIntegrator *Clone() const;
    virtual ~TransposeIntegrator() { if (own_bfi) delete bfi; }
 };
 
@@ -140,7 +249,9 @@ class SumIntegrator : public BilinearFormIntegrator
 {
 private:
    int own_integrators;
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix elem_mat;
+#endif
    Array<BilinearFormIntegrator*> integrators;
 
 public:
@@ -153,6 +264,8 @@ public:
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
 
+   virtual BilinearFormIntegrator *Clone() const;
+
    virtual ~SumIntegrator();
 };
 
@@ -165,19 +278,23 @@ private:
 #ifndef MFEM_THREAD_SAFE
    DenseMatrix dshape, dshapedxt, invdfdx, mq;
    DenseMatrix te_dshape, te_dshapedxt;
+   Vector q_ir;
+   DenseTensor mq_ir;
 #endif
    Coefficient *Q;
    MatrixCoefficient *MQ;
 
+   PartialAssemblyData *pa;
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
-   DiffusionIntegrator() { Q = NULL; MQ = NULL; }
+   DiffusionIntegrator() { Q = NULL; MQ = NULL; pa = NULL; }
 
    /// Construct a diffusion integrator with a scalar coefficient q
-   DiffusionIntegrator (Coefficient &q) : Q(&q) { MQ = NULL; }
+   DiffusionIntegrator (Coefficient &q) : Q(&q) { MQ = NULL; pa = NULL; }
 
    /// Construct a diffusion integrator with a matrix coefficient q
-   DiffusionIntegrator (MatrixCoefficient &q) : MQ(&q) { Q = NULL; }
+   DiffusionIntegrator (MatrixCoefficient &q) : MQ(&q) { Q = NULL; pa = NULL; }
 
    /** Given a particular Finite Element
        computes the element stiffness matrix elmat. */
@@ -202,21 +319,37 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux);
+
+   virtual void AssemblePA(FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual BilinearFormIntegrator *Clone() const
+   {
+      DiffusionIntegrator *c = new DiffusionIntegrator(*this);
+      c->pa = NULL;
+      return c;
+   }
+
+   virtual ~DiffusionIntegrator() { delete pa; }
 };
 
 /** Class for local mass matrix assemblying a(u,v) := (Q u, v) */
 class MassIntegrator: public BilinearFormIntegrator
 {
 private:
-   Vector shape, te_shape;
+#ifndef MFEM_THREAD_SAFE
+   Vector shape, te_shape, q_ir;
+#endif
    Coefficient *Q;
 
+   PartialAssemblyData *pa;
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir) { Q = NULL; }
+      : BilinearFormIntegrator(ir) { Q = NULL; pa = NULL; }
    /// Construct a mass integrator with coefficient q
    MassIntegrator(Coefficient &q, const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir), Q(&q) { }
+      : BilinearFormIntegrator(ir), Q(&q) { pa = NULL; }
 
    /** Given a particular Finite Element
        computes the element mass matrix elmat. */
@@ -227,6 +360,18 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual void AssemblePA(FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual BilinearFormIntegrator *Clone() const
+   {
+      MassIntegrator *c = new MassIntegrator(*this);
+      c->pa = NULL;
+      return c;
+   }
+
+   virtual ~MassIntegrator() { delete pa; }
 };
 
 class BoundaryMassIntegrator : public MassIntegrator
@@ -239,8 +384,10 @@ public:
 class ConvectionIntegrator : public BilinearFormIntegrator
 {
 private:
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix dshape, adjJ, Q_ir;
    Vector shape, vec2, BdFidxT;
+#endif
    VectorCoefficient &Q;
    double alpha;
 
@@ -250,14 +397,19 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new ConvectionIntegrator(*this); }
 };
 
 /// alpha (q . grad u, v) using the "group" FE discretization
 class GroupConvectionIntegrator : public BilinearFormIntegrator
 {
 private:
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix dshape, adjJ, Q_nodal, grad;
    Vector shape;
+#endif
    VectorCoefficient &Q;
    double alpha;
 
@@ -267,6 +419,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new GroupConvectionIntegrator(*this); }
 };
 
 /** Class for integrating the bilinear form a(u,v) := (Q u, v),
@@ -275,9 +430,11 @@ public:
 class VectorMassIntegrator: public BilinearFormIntegrator
 {
 private:
+#ifndef MFEM_THREAD_SAFE
    Vector shape, te_shape, vec;
    DenseMatrix partelmat;
    DenseMatrix mcoeff;
+#endif
    Coefficient *Q;
    VectorCoefficient *VQ;
    MatrixCoefficient *MQ;
@@ -311,6 +468,9 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new VectorMassIntegrator(*this); }
 };
 
 
@@ -370,8 +530,10 @@ class DerivativeIntegrator : public BilinearFormIntegrator
 private:
    Coefficient & Q;
    int xi;
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix dshape, dshapedxt, invdfdx;
    Vector shape, dshapedxi;
+#endif
 public:
    DerivativeIntegrator(Coefficient &q, int i) : Q(q), xi(i) { }
    virtual void AssembleElementMatrix(const FiniteElement &el,
@@ -382,6 +544,9 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new DerivativeIntegrator(*this); }
 };
 
 /// Integrator for (curl u, curl v) for Nedelec elements
@@ -403,6 +568,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new CurlCurlIntegrator(*this); }
 };
 
 /** Integrator for (curl u, curl v) for FE spaces defined by 'dim' copies of a
@@ -444,7 +612,7 @@ private:
    Vector shape;
    Vector D;
    DenseMatrix K;
-   DenseMatrix vshape;
+   DenseMatrix vshape, vshape_ref, Jinv;
 #endif
 
 public:
@@ -463,6 +631,9 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new VectorFEMassIntegrator(*this); }
 };
 
 /** Integrator for (Q div u, p) where u=(v1,...,vn) and all
@@ -473,11 +644,13 @@ class VectorDivergenceIntegrator : public BilinearFormIntegrator
 private:
    Coefficient *Q;
 
+#ifndef MFEM_THREAD_SAFE
    Vector shape;
    Vector divshape;
    DenseMatrix dshape;
    DenseMatrix gshape;
    DenseMatrix Jadj;
+#endif
 
 public:
    VectorDivergenceIntegrator() { Q = NULL; }
@@ -507,6 +680,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new DivDivIntegrator(*this); }
 };
 
 /** Integrator for (Q grad u, grad v) = sum_i (Q grad u_i, grad v_i)
@@ -516,10 +692,12 @@ class VectorDiffusionIntegrator : public BilinearFormIntegrator
 private:
    Coefficient *Q;
 
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix Jinv;
    DenseMatrix dshape;
    DenseMatrix gshape;
    DenseMatrix pelmat;
+#endif
 
 public:
    VectorDiffusionIntegrator() { Q = NULL; }
@@ -528,6 +706,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new VectorDiffusionIntegrator(*this); }
 };
 
 /** Integrator for the linear elasticity form:
@@ -557,6 +738,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+
+   virtual BilinearFormIntegrator *Clone() const
+   { return new ElasticityIntegrator(*this); }
 };
 
 /** Integrator for the DG form:
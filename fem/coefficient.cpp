@@ -21,6 +21,18 @@ namespace mfem
 
 using namespace std;
 
+void Coefficient::Eval(Vector &V, ElementTransformation &T,
+                       const IntegrationRule &ir)
+{
+   V.SetSize(ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      T.SetIntPoint(&ip);
+      V(i) = Eval(T, ip);
+   }
+}
+
 double PWConstCoefficient::Eval(ElementTransformation & T,
                                 const IntegrationPoint & ip)
 {
@@ -42,12 +54,42 @@ double FunctionCoefficient::Eval(ElementTransformation & T,
       return (*TDFunction)(transip, GetTime());
 }
 
+void FunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
+                               const IntegrationRule &ir)
+{
+   DenseMatrix x;
+   Vector transip;
+
+   T.Transform(ir, x);
+
+   V.SetSize(ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      x.GetColumnReference(i, transip);
+      if (Function)
+         V(i) = (*Function)(transip);
+      else
+         V(i) = (*TDFunction)(transip, GetTime());
+   }
+}
+
 double GridFunctionCoefficient::Eval (ElementTransformation &T,
                                       const IntegrationPoint &ip)
 {
    return GridF -> GetValue (T.ElementNo, ip, Component);
 }
 
+void GridFunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
+                                   const IntegrationRule &ir)
+{
+   // the face-neighbor elements of a ParGridFunction are only handled by the
+   // virtual GetValue()
+   if (T.ElementNo < GridF->FESpace()->GetNE())
+      GridF->GetValues(T.ElementNo, ir, V, Component);
+   else
+      Coefficient::Eval(V, T, ir);
+}
+
 double TransformedCoefficient::Eval(ElementTransformation &T,
                                     const IntegrationPoint &ip)
 {
@@ -62,6 +104,21 @@ double TransformedCoefficient::Eval(ElementTransformation &T,
    }
 }
 
+void RestrictedCoefficient::Eval(Vector &V, ElementTransformation &T,
+                                 const IntegrationRule &ir)
+{
+   if (active_attr[T.Attribute-1])
+   {
+      c->SetTime(GetTime());
+      c->Eval(V, T, ir);
+   }
+   else
+   {
+      V.SetSize(ir.GetNPoints());
+      V = 0.0;
+   }
+}
+
 void VectorCoefficient::Eval(DenseMatrix &M, ElementTransformation &T,
                              const IntegrationRule &ir)
 {
@@ -93,6 +150,35 @@ void VectorFunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
       V *= Q->Eval(T, ip, GetTime());
 }
 
+void VectorFunctionCoefficient::Eval(DenseMatrix &M, ElementTransformation &T,
+                                     const IntegrationRule &ir)
+{
+   DenseMatrix x;
+   Vector transip, Mi;
+
+   T.Transform(ir, x);
+
+   M.SetSize(vdim, ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      x.GetColumnReference(i, transip);
+      M.GetColumnReference(i, Mi);
+      if (Function)
+         (*Function)(transip, Mi);
+      else
+         (*TDFunction)(transip, GetTime(), Mi);
+   }
+   if (Q)
+   {
+      Vector q;
+      Q->SetTime(GetTime());
+      Q->Eval(q, T, ir);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+         for (int j = 0; j < vdim; j++)
+            M(j,i) *= q(i);
+   }
+}
+
 VectorArrayCoefficient::VectorArrayCoefficient (int dim)
    : VectorCoefficient(dim), Coeff(dim)
 {
@@ -176,6 +262,37 @@ void MatrixFunctionCoefficient::Eval(DenseMatrix &K, ElementTransformation &T,
       (*TDFunction)(transip, GetTime(), K);
 }
 
+void MatrixFunctionCoefficient::Eval(DenseTensor &K, ElementTransformation &T,
+                                     const IntegrationRule &ir)
+{
+   DenseMatrix x;
+   Vector transip;
+
+   T.Transform(ir, x);
+
+   K.SetSize(vdim, vdim, ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      x.GetColumnReference(i, transip);
+      if (Function)
+         (*Function)(transip, K(i));
+      else
+         (*TDFunction)(transip, GetTime(), K(i));
+   }
+}
+
+void MatrixCoefficient::Eval(DenseTensor &K, ElementTransformation &T,
+                             const IntegrationRule &ir)
+{
+   K.SetSize(vdim, vdim, ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      T.SetIntPoint(&ip);
+      Eval(K(i), T, ip);
+   }
+}
+
 MatrixArrayCoefficient::MatrixArrayCoefficient (int dim)
    : MatrixCoefficient (dim)
 {
@@ -193,6 +310,8 @@ void MatrixArrayCoefficient::Eval (DenseMatrix &K, ElementTransformation &T,
 {
    int i, j;
 
+   K.SetSize(vdim);
+
    for (i = 0; i < vdim; i++)
       for (j = 0; j < vdim; j++)
          K(i,j) = Coeff[i*vdim+j] -> Eval(T, ip, GetTime());
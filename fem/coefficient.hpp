@@ -49,6 +49,13 @@ public:
       return Eval(T, ip);
    }
 
+   /** Evaluate the coefficient at all the points of the rule; V is resized to
+       the number of points. The general implementation calls the Eval method
+       for one IntegrationPoint; derived classes can overload it with a more
+       efficient implementation. The integration point of T is changed. */
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~Coefficient() { }
 };
 
@@ -66,6 +73,10 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return(constant); }
+
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir)
+   { V.SetSize(ir.GetNPoints()); V = constant; }
 };
 
 /// class for piecewise constant coefficient
@@ -97,6 +108,10 @@ public:
    /// Evaluate the coefficient function
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir)
+   { V.SetSize(ir.GetNPoints()); V = constants(T.Attribute-1); }
 };
 
 /// class for C-function coefficient
@@ -124,6 +139,10 @@ public:
    /// Evaluate coefficient
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /// Evaluate the function at all the points, transformed together
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 class GridFunction;
@@ -146,6 +165,10 @@ public:
 
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /// Evaluate the GridFunction at all the points, see GridFunction::GetValues
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 class TransformedCoefficient : public Coefficient
@@ -205,6 +228,9 @@ public:
 
    virtual double Eval(ElementTransformation &T, const IntegrationPoint &ip)
    { return active_attr[T.Attribute-1] ? c->Eval(T, ip, GetTime()) : 0.0; }
+
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 class VectorCoefficient
@@ -272,10 +298,13 @@ public:
       TDFunction = TDF;
    }
 
-   using VectorCoefficient::Eval;
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip);
 
+   /// Evaluate the function at all the points, transformed together
+   virtual void Eval(DenseMatrix &M, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~VectorFunctionCoefficient() { }
 };
 
@@ -364,6 +393,12 @@ public:
    virtual void Eval(DenseMatrix &K, ElementTransformation &T,
                      const IntegrationPoint &ip) = 0;
 
+   /** Evaluate the coefficient at all the points of the rule: K(i) is the
+       matrix at point i. The general implementation calls the Eval method for
+       one IntegrationPoint. The integration point of T is changed. */
+   virtual void Eval(DenseTensor &K, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~MatrixCoefficient() { }
 };
 
@@ -394,6 +429,10 @@ public:
    virtual void Eval(DenseMatrix &K, ElementTransformation &T,
                      const IntegrationPoint &ip);
 
+   /// Evaluate the function at all the points, transformed together
+   virtual void Eval(DenseTensor &K, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~MatrixFunctionCoefficient() { }
 };
 
@@ -413,6 +452,7 @@ public:
    double Eval(int i, int j, ElementTransformation &T, IntegrationPoint &ip)
    { return Coeff[i*vdim+j] -> Eval(T, ip, GetTime()); }
 
+   using MatrixCoefficient::Eval;
    virtual void Eval(DenseMatrix &K, ElementTransformation &T,
                      const IntegrationPoint &ip);
 
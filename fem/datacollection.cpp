@@ -13,13 +13,20 @@
 #include "picojson.h"
 
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <deque>
 #include <cerrno>      // errno
 #ifndef _WIN32
 #include <sys/stat.h>  // mkdir
+#include <unistd.h>    // link, unlink
 #else
 #include <direct.h>    // _mkdir
 #define mkdir(dir, mode) _mkdir(dir)
 #endif
+#ifdef MFEM_USE_PTHREADS
+#include <pthread.h>
+#endif
 
 namespace mfem
 {
@@ -53,6 +60,211 @@ int to_int(string str)
    return i;
 }
 
+// Make 'dst' a hard link to 'src' or, if that fails, a copy of 'src'.
+static bool LinkOrCopyFile(const string &src, const string &dst)
+{
+   if (src == dst)
+      return true;
+#ifndef _WIN32
+   unlink(dst.c_str());
+   if (link(src.c_str(), dst.c_str()) == 0)
+      return true;
+#endif
+   ifstream in(src.c_str(), ios::in | ios::binary);
+   ofstream out(dst.c_str(), ios::out | ios::binary);
+   out << in.rdbuf();
+   return (in && out);
+}
+
+// A snapshot of the mesh and the fields saved by an asynchronous
+// DataCollection::Save().
+class DataCollectionJob
+{
+public:
+   bool binary;
+   string mesh_name;
+   string mesh_data; // the printed mesh, used when mesh_link is empty
+   string mesh_link; // file with the same mesh
+   vector<string> field_names;
+   vector<GridFunction *> fields; // owned copies of the field data
+
+   /// Write the files, return the error state
+   int Write() const;
+
+   ~DataCollectionJob()
+   {
+      for (size_t i = 0; i < fields.size(); i++)
+         delete fields[i];
+   }
+};
+
+int DataCollectionJob::Write() const
+{
+   int error = DataCollection::NO_ERROR;
+   if (mesh_link.empty())
+   {
+      ofstream mesh_file(mesh_name.c_str(), ios::out | ios::binary);
+      mesh_file.write(mesh_data.data(), mesh_data.size());
+      if (!mesh_file)
+      {
+         error = DataCollection::WRITE_ERROR;
+         MFEM_WARNING("Error writing mesh to file: " << mesh_name);
+      }
+   }
+   else if (!LinkOrCopyFile(mesh_link, mesh_name))
+   {
+      error = DataCollection::WRITE_ERROR;
+      MFEM_WARNING("Error writing mesh to file: " << mesh_name);
+   }
+
+   for (size_t i = 0; i < fields.size(); i++)
+   {
+      ofstream field_file(field_names[i].c_str(), binary ?
+                          ios::out | ios::binary : ios::out);
+      if (binary)
+         fields[i]->GridFunction::SaveBinary(field_file);
+      else
+         fields[i]->GridFunction::Save(field_file);
+      if (!field_file)
+      {
+         error = DataCollection::WRITE_ERROR;
+         MFEM_WARNING("Error writting field to file: " << field_names[i]);
+      }
+   }
+   return error;
+}
+
+/** Queue of DataCollectionJob%s processed in order by a background thread.
+    Without MFEM_USE_PTHREADS, the jobs are processed in Push(). */
+class DataCollectionWriter
+{
+private:
+   deque<DataCollectionJob *> queue;
+   int max_pending, num_pending;
+   int error;
+#ifdef MFEM_USE_PTHREADS
+   bool stop;
+   pthread_t thread;
+   pthread_mutex_t mutex;
+   pthread_cond_t cond;
+
+   static void *Run(void *writer);
+#endif
+
+public:
+   DataCollectionWriter(int max_pending_);
+
+   /// Take ownership of 'job' and queue it, waiting while the queue is full
+   void Push(DataCollectionJob *job);
+
+   /// Wait until all queued jobs are done
+   void Wait();
+
+   /// Return and reset the error state of the processed jobs
+   int GetError();
+
+   ~DataCollectionWriter();
+};
+
+DataCollectionWriter::DataCollectionWriter(int max_pending_)
+{
+   max_pending = std::max(max_pending_, 1);
+   num_pending = 0;
+   error = DataCollection::NO_ERROR;
+#ifdef MFEM_USE_PTHREADS
+   stop = false;
+   pthread_mutex_init(&mutex, NULL);
+   pthread_cond_init(&cond, NULL);
+   int err = pthread_create(&thread, NULL, Run, this);
+   MFEM_VERIFY(err == 0, "unable to create the writer thread");
+#endif
+}
+
+#ifdef MFEM_USE_PTHREADS
+void *DataCollectionWriter::Run(void *writer)
+{
+   DataCollectionWriter &w = *static_cast<DataCollectionWriter *>(writer);
+   pthread_mutex_lock(&w.mutex);
+   while (1)
+   {
+      while (w.queue.empty() && !w.stop)
+         pthread_cond_wait(&w.cond, &w.mutex);
+      if (w.queue.empty())
+         break;
+      DataCollectionJob *job = w.queue.front();
+      w.queue.pop_front();
+
+      pthread_mutex_unlock(&w.mutex);
+      int err = job->Write();
+      delete job;
+      pthread_mutex_lock(&w.mutex);
+
+      if (err)
+         w.error = err;
+      w.num_pending--;
+      pthread_cond_broadcast(&w.cond);
+   }
+   pthread_mutex_unlock(&w.mutex);
+   return NULL;
+}
+#endif
+
+void DataCollectionWriter::Push(DataCollectionJob *job)
+{
+#ifdef MFEM_USE_PTHREADS
+   pthread_mutex_lock(&mutex);
+   while (num_pending >= max_pending)
+      pthread_cond_wait(&cond, &mutex);
+   queue.push_back(job);
+   num_pending++;
+   pthread_cond_broadcast(&cond);
+   pthread_mutex_unlock(&mutex);
+#else
+   int err = job->Write();
+   delete job;
+   if (err)
+      error = err;
+#endif
+}
+
+void DataCollectionWriter::Wait()
+{
+#ifdef MFEM_USE_PTHREADS
+   pthread_mutex_lock(&mutex);
+   while (num_pending > 0)
+      pthread_cond_wait(&cond, &mutex);
+   pthread_mutex_unlock(&mutex);
+#endif
+}
+
+int DataCollectionWriter::GetError()
+{
+#ifdef MFEM_USE_PTHREADS
+   pthread_mutex_lock(&mutex);
+#endif
+   int err = error;
+   error = DataCollection::NO_ERROR;
+#ifdef MFEM_USE_PTHREADS
+   pthread_mutex_unlock(&mutex);
+#endif
+   return err;
+}
+
+DataCollectionWriter::~DataCollectionWriter()
+{
+#ifdef MFEM_USE_PTHREADS
+   pthread_mutex_lock(&mutex);
+   stop = true;
+   pthread_cond_broadcast(&cond);
+   pthread_mutex_unlock(&mutex);
+   // the thread finishes the queued jobs before it exits
+   pthread_join(thread, NULL);
+   pthread_cond_destroy(&cond);
+   pthread_mutex_destroy(&mutex);
+#endif
+}
+
+
 // class DataCollection implementation
 
 DataCollection::DataCollection(const char *collection_name)
@@ -66,6 +278,9 @@ DataCollection::DataCollection(const char *collection_name)
    cycle = -1;
    time = 0.0;
    pad_digits = pad_digits_default;
+   format = ASCII_FORMAT;
+   writer = NULL;
+   static_mesh = false;
    error = NO_ERROR;
 }
 
@@ -89,6 +304,9 @@ DataCollection::DataCollection(const char *collection_name, Mesh *_mesh)
    cycle = -1;
    time = 0.0;
    pad_digits = pad_digits_default;
+   format = ASCII_FORMAT;
+   writer = NULL;
+   static_mesh = false;
    error = NO_ERROR;
 }
 
@@ -143,26 +361,48 @@ void DataCollection::Save()
       mesh_name = dir_name + "/mesh";
    else
       mesh_name = dir_name + "/mesh." + to_padded_string(myid, pad_digits);
-   ofstream mesh_file(mesh_name.c_str());
-   mesh->Print(mesh_file);
-   if (!mesh_file)
+   const bool binary = (format == BINARY_FORMAT);
+   const bool link_mesh = (static_mesh && !static_mesh_name.empty());
+
+   if (writer)
    {
-      error = WRITE_ERROR;
-      MFEM_WARNING("Error writing mesh to file: " << mesh_name);
+      SaveAsync(dir_name, mesh_name, link_mesh);
+      return;
+   }
+
+   if (link_mesh)
+   {
+      if (!LinkOrCopyFile(static_mesh_name, mesh_name))
+      {
+         error = WRITE_ERROR;
+         MFEM_WARNING("Error writing mesh to file: " << mesh_name);
+      }
    }
-   mesh_file.close();
+   else
+   {
+      ofstream mesh_file(mesh_name.c_str(), binary ? ios::out | ios::binary :
+                         ios::out);
+      PrintMesh(mesh_file);
+      if (!mesh_file)
+      {
+         error = WRITE_ERROR;
+         MFEM_WARNING("Error writing mesh to file: " << mesh_name);
+      }
+   }
+   if (static_mesh)
+      static_mesh_name = mesh_name;
 
    string field_name;
    for (map<string,GridFunction*>::iterator it = field_map.begin();
         it != field_map.end(); ++it)
    {
-      if (serial)
-         field_name = dir_name + "/" + it->first;
+      field_name = GetFieldFileName(dir_name, it->first);
+      ofstream field_file(field_name.c_str(), binary ?
+                          ios::out | ios::binary : ios::out);
+      if (binary)
+         (it->second)->SaveBinary(field_file);
       else
-         field_name = dir_name + "/" + it->first + "." +
-            to_padded_string(myid, pad_digits);
-      ofstream field_file(field_name.c_str());
-      (it->second)->Save(field_file);
+         (it->second)->Save(field_file);
       if (!field_file)
       {
          error = WRITE_ERROR;
@@ -171,8 +411,89 @@ void DataCollection::Save()
    }
 }
 
+void DataCollection::PrintMesh(std::ostream &out) const
+{
+   if (format == BINARY_FORMAT && !mesh->NURBSext)
+      mesh->PrintBinary(out);
+   else
+      mesh->Print(out);
+}
+
+string DataCollection::GetFieldFileName(const string &dir_name,
+                                        const string &field_name) const
+{
+   if (serial)
+      return dir_name + "/" + field_name;
+   return dir_name + "/" + field_name + "." +
+      to_padded_string(myid, pad_digits);
+}
+
+void DataCollection::SaveAsync(const string &dir_name,
+                               const string &mesh_name, bool link_mesh)
+{
+   DataCollectionJob *job = new DataCollectionJob;
+   job->binary = (format == BINARY_FORMAT);
+   job->mesh_name = mesh_name;
+   if (link_mesh)
+   {
+      job->mesh_link = static_mesh_name;
+   }
+   else
+   {
+      ostringstream mesh_stream;
+      PrintMesh(mesh_stream);
+      job->mesh_data = mesh_stream.str();
+   }
+   if (static_mesh)
+      static_mesh_name = mesh_name;
+
+   for (map<string,GridFunction*>::iterator it = field_map.begin();
+        it != field_map.end(); ++it)
+   {
+      GridFunction *gf = it->second;
+      GridFunction *copy = new GridFunction(gf->FESpace());
+      copy->Vector::operator=(*gf);
+#ifdef MFEM_USE_MPI
+      // apply the sign changes of ParGridFunction::Save() to the copy
+      ParGridFunction *pgf = dynamic_cast<ParGridFunction*>(gf);
+      if (pgf)
+      {
+         for (int i = 0; i < copy->Size(); i++)
+            if (pgf->ParFESpace()->GetDofSign(i) < 0)
+               (*copy)(i) = -(*copy)(i);
+      }
+#endif
+      job->field_names.push_back(GetFieldFileName(dir_name, it->first));
+      job->fields.push_back(copy);
+   }
+
+   writer->Push(job);
+   int err = writer->GetError();
+   if (err)
+      error = err;
+}
+
+void DataCollection::SetAsync(bool async, int max_pending)
+{
+   WaitForSaves();
+   delete writer;
+   writer = async ? new DataCollectionWriter(max_pending) : NULL;
+}
+
+void DataCollection::WaitForSaves()
+{
+   if (writer)
+   {
+      writer->Wait();
+      int err = writer->GetError();
+      if (err)
+         error = err;
+   }
+}
+
 void DataCollection::DeleteData()
 {
+   WaitForSaves();
    if (own_data)
       delete mesh;
    mesh = NULL;
@@ -194,6 +515,7 @@ void DataCollection::DeleteAll()
 
 DataCollection::~DataCollection()
 {
+   delete writer; // finishes the pending saves
    if (own_data)
    {
       delete mesh;
@@ -300,7 +622,8 @@ void VisItDataCollection::LoadMesh()
 {
    string mesh_fname = name + "_" + to_padded_string(cycle, pad_digits) +
       "/mesh." + to_padded_string(myid, pad_digits);
-   ifstream file(mesh_fname.c_str());
+   // the file may be in either the ASCII or the binary format
+   ifstream file(mesh_fname.c_str(), ios::in | ios::binary);
    if (!file)
    {
       error = READ_ERROR;
@@ -324,7 +647,7 @@ void VisItDataCollection::LoadFields()
         it != field_info_map.end(); ++it)
    {
       string fname = path_left + it->first + path_right;
-      ifstream file(fname.c_str());
+      ifstream file(fname.c_str(), ios::in | ios::binary);
       if (!file)
       {
          error = READ_ERROR;
@@ -20,6 +20,8 @@
 namespace mfem
 {
 
+class DataCollectionWriter;
+
 /** A class for collecting finite element data that is part of the same
     simulation. Currently, this class groups together several grid functions
     (fields) and the mesh that they are defined on. */
@@ -53,14 +55,34 @@ protected:
    /// Default value for pad_digits
    static const int pad_digits_default = 6;
 
+   /// Output format of the mesh and fields, see SetFormat()
+   int format;
+
    /// Should the collection delete its mesh and fields
    bool own_data;
 
+   /// Background writer used in asynchronous mode, see SetAsync()
+   DataCollectionWriter *writer;
+
+   /// Is the mesh static? See SetStaticMesh()
+   bool static_mesh;
+   /// File with the last copy of the static mesh (empty if not written yet)
+   std::string static_mesh_name;
+
    /// Error state
    int error;
 
    /// Create an empty collection with the given name.
    DataCollection(const char *collection_name);
+   /// Print the mesh using the current format
+   void PrintMesh(std::ostream &out) const;
+   /// Name of the file for the given field in the directory 'dir_name'
+   std::string GetFieldFileName(const std::string &dir_name,
+                                const std::string &field_name) const;
+   /// Queue a snapshot of the mesh and the fields to the writer
+   void SaveAsync(const std::string &dir_name, const std::string &mesh_name,
+                  bool link_mesh);
+
    /// Delete data owned by the DataCollection keeping field information
    void DeleteData();
    /// Delete data owned by the DataCollection including field information
@@ -97,6 +119,33 @@ public:
    /// Set the number of digits used for the cycle and MPI rank in filenames
    void SetPadDigits(int digits) { pad_digits = digits; }
 
+   /// Output formats of the mesh and fields
+   enum { ASCII_FORMAT = 0, BINARY_FORMAT = 1 };
+
+   /** Set the format used by Save(). In BINARY_FORMAT the mesh is written with
+       Mesh::PrintBinary() (except for NURBS meshes) and the fields with
+       GridFunction::SaveBinary(); both formats are recognized when reading. */
+   void SetFormat(int fmt) { format = fmt; }
+
+   /** Enable or disable the asynchronous mode of Save(). In this mode Save()
+       copies the mesh and the field data into a snapshot which is written by a
+       background thread; at most 'max_pending' snapshots are kept, when there
+       are more, Save() waits for the writer. The finite element spaces of the
+       fields must not change until the pending snapshots are written, see
+       WaitForSaves(). Without MFEM_USE_PTHREADS, the snapshots are written
+       before Save() returns. */
+   void SetAsync(bool async, int max_pending = 2);
+   /// Is the asynchronous mode of Save() enabled?
+   bool IsAsync() const { return (writer != NULL); }
+   /** Wait until all snapshots of the asynchronous Save() are written and
+       update the error state with the result. */
+   void WaitForSaves();
+
+   /** Declare that the mesh does not change between calls to Save(). The mesh
+       is then written only once; the mesh files of later cycles are hard links
+       to (or copies of, when links are not supported) the first one. */
+   void SetStaticMesh(bool s) { static_mesh = s; static_mesh_name.clear(); }
+
    /** Save the collection to disk. By default, everything is saved in a
        directory with name "collection_name" or "collection_name_cycle" for
        time-dependent simulations. */
@@ -108,7 +157,8 @@ public:
    /// Errors returned by Error()
    enum { NO_ERROR = 0, READ_ERROR = 1, WRITE_ERROR = 2 };
 
-   /// Get the current error state
+   /** Get the current error state. In asynchronous mode, write errors are
+       reported after the next Save() or WaitForSaves(). */
    int Error() const { return error; }
    /// Reset the error state
    void ResetError(int err = NO_ERROR) { error = err; }
@@ -25,6 +25,140 @@ FiniteElement::FiniteElement(int D, int G, int Do, int O, int F)
    Dim = D ; GeomType = G ; Dof = Do ; Order = O ; FuncSpace = F;
    RangeType = SCALAR;
    MapType = VALUE;
+   dof2quad_list = NULL;
+}
+
+DofToQuad *FiniteElement::FindDofToQuad(const IntegrationRule &ir,
+                                        int mode) const
+{
+   DofToQuad *d2q;
+#ifdef MFEM_USE_OPENMP
+#pragma omp atomic read
+#endif
+   d2q = dof2quad_list;
+#ifdef MFEM_USE_OPENMP
+#pragma omp flush
+#endif
+   for ( ; d2q; d2q = d2q->next)
+      if (d2q->IntRule == &ir && d2q->mode == mode)
+         return d2q;
+   return NULL;
+}
+
+DofToQuad *FiniteElement::ComputeDofToQuad(const IntegrationRule &ir) const
+{
+   const int nq = ir.GetNPoints();
+   DofToQuad *d2q = new DofToQuad;
+   d2q->FE = this;
+   d2q->IntRule = &ir;
+   d2q->mode = DofToQuad::FULL;
+   d2q->ndof = Dof;
+   d2q->nqpt = nq;
+
+   if (RangeType == VECTOR)
+   {
+      d2q->V.SetSize(Dof, Dim, nq);
+      // the curls are only implemented in 3D
+      const bool curl = (MapType == H_CURL && Dim == 3);
+      if (curl)
+         d2q->C.SetSize(Dof, Dim, nq);
+      if (MapType == H_DIV)
+         d2q->D.SetSize(nq, Dof);
+
+      Vector divshape(Dof);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         CalcVShape(ip, d2q->V(q));
+         if (curl)
+            CalcCurlShape(ip, d2q->C(q));
+         if (MapType == H_DIV)
+         {
+            CalcDivShape(ip, divshape);
+            for (int i = 0; i < Dof; i++)
+               d2q->D(q,i) = divshape(i);
+         }
+      }
+      return d2q;
+   }
+
+   d2q->B.SetSize(nq, Dof);
+   d2q->G.SetSize(Dof, Dim, nq);
+
+   Vector shape(Dof);
+   for (int q = 0; q < nq; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      CalcShape(ip, shape);
+      for (int i = 0; i < Dof; i++)
+         d2q->B(q,i) = shape(i);
+      CalcDShape(ip, d2q->G(q));
+   }
+   return d2q;
+}
+
+DofToQuad *FiniteElement::NewDofToQuad(const IntegrationRule &ir,
+                                       int mode) const
+{
+   MFEM_VERIFY(mode == DofToQuad::FULL,
+               "DofToQuad::TENSOR is not supported by this element");
+   return ComputeDofToQuad(ir);
+}
+
+bool FiniteElement::CanCacheDofToQuad(const IntegrationRule &ir) const
+{
+   return (IntRules.Contains(GeomType, ir) ||
+           RefinedIntRules.Contains(GeomType, ir));
+}
+
+const DofToQuad &FiniteElement::GetDofToQuad(const IntegrationRule &ir,
+                                             int mode) const
+{
+   DofToQuad *d2q = FindDofToQuad(ir, mode);
+   if (d2q)
+      return *d2q;
+
+   // a rule owned by the caller may be destroyed and another one created at
+   // the same address, so only the global rules are cached
+   MFEM_VERIFY(CanCacheDofToQuad(ir), "the DofToQuad tables are cached only "
+               "for the rules of IntRules and RefinedIntRules, use "
+               "NewDofToQuad() for other rules");
+#ifdef MFEM_USE_OPENMP
+#pragma omp critical (DofToQuad)
+#endif
+   {
+      d2q = FindDofToQuad(ir, mode);
+      if (d2q == NULL)
+      {
+         d2q = NewDofToQuad(ir, mode);
+         d2q->next = dof2quad_list;
+#ifdef MFEM_USE_OPENMP
+#pragma omp flush
+#pragma omp atomic write
+#endif
+         dof2quad_list = d2q;
+      }
+   }
+   return *d2q;
+}
+
+const DofToQuad *FiniteElement::GetFullDofToQuad(
+   const IntegrationRule &ir) const
+{
+   const DofToQuad *d2q = FindDofToQuad(ir, DofToQuad::FULL);
+   if (d2q == NULL && CanCacheDofToQuad(ir))
+      d2q = &GetDofToQuad(ir, DofToQuad::FULL);
+   return d2q;
+}
+
+FiniteElement::~FiniteElement()
+{
+   while (dof2quad_list)
+   {
+      DofToQuad *d2q = dof2quad_list;
+      dof2quad_list = d2q->next;
+      delete d2q;
+   }
 }
 
 void FiniteElement::CalcVShape (
@@ -6267,6 +6401,121 @@ Poly_1D::~Poly_1D()
 }
 
 Poly_1D poly1d;
+
+
+bool TensorBasisElement::Get1DRule(const IntegrationRule &ir, int dim,
+                                   IntegrationRule &ir1d)
+{
+   const int nq = ir.GetNPoints();
+   int nq1 = (int) floor(pow((double) nq, 1.0/dim) + 0.5);
+   if (nq1 < 1 || (dim == 2 ? nq1*nq1 : nq1*nq1*nq1) != nq)
+      return false;
+
+   ir1d.SetSize(nq1);
+   for (int i = 0; i < nq1; i++)
+   {
+      ir1d.IntPoint(i).x = ir.IntPoint(i).x;
+      ir1d.IntPoint(i).weight = 0.0;
+   }
+   for (int q = 0; q < nq; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      const int qx = q % nq1, qy = (q / nq1) % nq1, qz = q / (nq1*nq1);
+      if (ip.x != ir1d.IntPoint(qx).x || ip.y != ir1d.IntPoint(qy).x ||
+          (dim == 3 && ip.z != ir1d.IntPoint(qz).x))
+         return false;
+      // the weights of the reference segment rules sum to 1
+      ir1d.IntPoint(qx).weight += ip.weight;
+   }
+   // the weights must also be the products of the 1D weights
+   for (int q = 0; q < nq; q++)
+   {
+      const int qx = q % nq1, qy = (q / nq1) % nq1, qz = q / (nq1*nq1);
+      double w = ir1d.IntPoint(qx).weight * ir1d.IntPoint(qy).weight;
+      if (dim == 3)
+         w *= ir1d.IntPoint(qz).weight;
+      if (fabs(ir.IntPoint(q).weight - w) > 1e-12*fabs(w))
+         return false;
+   }
+   return true;
+}
+
+DofToQuad *TensorBasisElement::NewTensorDofToQuad(
+   const FiniteElement &fe, const IntegrationRule &ir, int mode) const
+{
+   DofToQuad *d2q;
+   const int dim = fe.GetDim();
+   IntegrationRule ir1d;
+   if (!Get1DRule(ir, dim, ir1d))
+   {
+      MFEM_VERIFY(mode == DofToQuad::FULL,
+                  "DofToQuad::TENSOR requires a tensor-product rule");
+      d2q = fe.ComputeDofToQuad(ir);
+   }
+   else
+   {
+      const int nd1 = fe.GetOrder() + 1, nq1 = ir1d.GetNPoints();
+      DenseMatrix B1d(nq1, nd1), G1d(nq1, nd1);
+      Vector shape1d(nd1), dshape1d(nd1);
+      for (int i = 0; i < nq1; i++)
+      {
+         basis1d.Eval(ir1d.IntPoint(i).x, shape1d, dshape1d);
+         for (int j = 0; j < nd1; j++)
+         {
+            B1d(i,j) = shape1d(j);
+            G1d(i,j) = dshape1d(j);
+         }
+      }
+
+      d2q = new DofToQuad;
+      d2q->FE = &fe;
+      d2q->IntRule = &ir;
+      d2q->mode = mode;
+      if (mode == DofToQuad::TENSOR)
+      {
+         d2q->ndof = nd1;
+         d2q->nqpt = nq1;
+         d2q->B = B1d;
+         d2q->G.SetSize(nq1, nd1, 1);
+         d2q->G(0) = G1d.Data();
+      }
+      else
+      {
+         // products of the 1D factors, O(1) work per table entry
+         const int nd = fe.GetDof(), nq = ir.GetNPoints();
+         const int nz1 = (dim == 3) ? nd1 : 1;
+         const int nqz = (dim == 3) ? nq1 : 1;
+         d2q->ndof = nd;
+         d2q->nqpt = nq;
+         d2q->B.SetSize(nq, nd);
+         d2q->G.SetSize(nd, dim, nq);
+         for (int qz = 0, q = 0; qz < nqz; qz++)
+            for (int qy = 0; qy < nq1; qy++)
+               for (int qx = 0; qx < nq1; qx++, q++)
+               {
+                  DenseMatrix &Gq = d2q->G(q);
+                  for (int iz = 0, o = 0; iz < nz1; iz++)
+                  {
+                     const double bz = (dim == 3) ? B1d(qz,iz) : 1.0;
+                     const double gz = (dim == 3) ? G1d(qz,iz) : 0.0;
+                     for (int iy = 0; iy < nd1; iy++)
+                        for (int ix = 0; ix < nd1; ix++, o++)
+                        {
+                           const int i = dof_map.Size() ? dof_map[o] : o;
+                           const double bx = B1d(qx,ix), by = B1d(qy,iy);
+                           d2q->B(q,i) = bx*by*bz;
+                           Gq(i,0) = G1d(qx,ix)*by*bz;
+                           Gq(i,1) = bx*G1d(qy,iy)*bz;
+                           if (dim == 3)
+                              Gq(i,2) = bx*by*gz;
+                        }
+                  }
+               }
+      }
+   }
+   return d2q;
+}
+
 Array2D<int> Poly_1D::binom;
 
 
@@ -6348,8 +6597,10 @@ void H1_SegmentElement::ProjectDelta(int vertex, Vector &dofs) const
 H1_QuadrilateralElement::H1_QuadrilateralElement(const int p)
    : NodalFiniteElement(2, Geometry::SQUARE, (p + 1)*(p + 1), p,
                         FunctionSpace::Qk),
-     basis1d(poly1d.ClosedBasis(p)), dof_map((p + 1)*(p + 1))
+     TensorBasisElement(poly1d.ClosedBasis(p))
 {
+   dof_map.SetSize((p + 1)*(p + 1));
+
    const double *cp = poly1d.ClosedPoints(p);
 
    const int p1 = p + 1;
@@ -6470,8 +6721,10 @@ void H1_QuadrilateralElement::ProjectDelta(int vertex, Vector &dofs) const
 H1_HexahedronElement::H1_HexahedronElement(const int p)
    : NodalFiniteElement(3, Geometry::CUBE, (p + 1)*(p + 1)*(p + 1), p,
                         FunctionSpace::Qk),
-     basis1d(poly1d.ClosedBasis(p)), dof_map((p + 1)*(p + 1)*(p + 1))
+     TensorBasisElement(poly1d.ClosedBasis(p))
 {
+   dof_map.SetSize((p + 1)*(p + 1)*(p + 1));
+
    const double *cp = poly1d.ClosedPoints(p);
 
    const int p1 = p + 1;
@@ -7324,7 +7577,9 @@ void L2Pos_SegmentElement::ProjectDelta(int vertex, Vector &dofs) const
 
 L2_QuadrilateralElement::L2_QuadrilateralElement(const int p, const int _type)
    : NodalFiniteElement(2, Geometry::SQUARE, (p + 1)*(p + 1), p,
-                        FunctionSpace::Qk)
+                        FunctionSpace::Qk),
+     TensorBasisElement(_type == 0 ? poly1d.OpenBasis(p) :
+                        poly1d.ClosedBasis(p))
 {
    const double *op;
 
@@ -7332,12 +7587,10 @@ L2_QuadrilateralElement::L2_QuadrilateralElement(const int p, const int _type)
    switch (type)
    {
    case 0:
-      basis1d = &poly1d.OpenBasis(p);
       op = poly1d.OpenPoints(p);
       break;
    case 1:
    default:
-      basis1d = &poly1d.ClosedBasis(p);
       op = poly1d.ClosedPoints(p);
    }
 
@@ -7362,8 +7615,8 @@ void L2_QuadrilateralElement::CalcShape(const IntegrationPoint &ip,
    Vector shape_x(p+1), shape_y(p+1);
 #endif
 
-   basis1d->Eval(ip.x, shape_x);
-   basis1d->Eval(ip.y, shape_y);
+   basis1d.Eval(ip.x, shape_x);
+   basis1d.Eval(ip.y, shape_y);
 
    for (int o = 0, j = 0; j <= p; j++)
       for (int i = 0; i <= p; i++)
@@ -7379,8 +7632,8 @@ void L2_QuadrilateralElement::CalcDShape(const IntegrationPoint &ip,
    Vector shape_x(p+1), shape_y(p+1), dshape_x(p+1), dshape_y(p+1);
 #endif
 
-   basis1d->Eval(ip.x, shape_x, dshape_x);
-   basis1d->Eval(ip.y, shape_y, dshape_y);
+   basis1d.Eval(ip.x, shape_x, dshape_x);
+   basis1d.Eval(ip.y, shape_y, dshape_y);
 
    for (int o = 0, j = 0; j <= p; j++)
       for (int i = 0; i <= p; i++)
@@ -7508,7 +7761,9 @@ void L2Pos_QuadrilateralElement::ProjectDelta(int vertex, Vector &dofs) const
 
 L2_HexahedronElement::L2_HexahedronElement(const int p, const int _type)
    : NodalFiniteElement(3, Geometry::CUBE, (p + 1)*(p + 1)*(p + 1), p,
-                        FunctionSpace::Qk)
+                        FunctionSpace::Qk),
+     TensorBasisElement(_type == 0 ? poly1d.OpenBasis(p) :
+                        poly1d.ClosedBasis(p))
 {
    const double *op;
 
@@ -7516,12 +7771,10 @@ L2_HexahedronElement::L2_HexahedronElement(const int p, const int _type)
    switch (type)
    {
    case 0:
-      basis1d = &poly1d.OpenBasis(p);
       op = poly1d.OpenPoints(p);
       break;
    case 1:
    default:
-      basis1d = &poly1d.ClosedBasis(p);
       op = poly1d.ClosedPoints(p);
    }
 
@@ -7549,9 +7802,9 @@ void L2_HexahedronElement::CalcShape(const IntegrationPoint &ip,
    Vector shape_x(p+1), shape_y(p+1), shape_z(p+1);
 #endif
 
-   basis1d->Eval(ip.x, shape_x);
-   basis1d->Eval(ip.y, shape_y);
-   basis1d->Eval(ip.z, shape_z);
+   basis1d.Eval(ip.x, shape_x);
+   basis1d.Eval(ip.y, shape_y);
+   basis1d.Eval(ip.z, shape_z);
 
    for (int o = 0, k = 0; k <= p; k++)
       for (int j = 0; j <= p; j++)
@@ -7569,9 +7822,9 @@ void L2_HexahedronElement::CalcDShape(const IntegrationPoint &ip,
    Vector dshape_x(p+1), dshape_y(p+1), dshape_z(p+1);
 #endif
 
-   basis1d->Eval(ip.x, shape_x, dshape_x);
-   basis1d->Eval(ip.y, shape_y, dshape_y);
-   basis1d->Eval(ip.z, shape_z, dshape_z);
+   basis1d.Eval(ip.x, shape_x, dshape_x);
+   basis1d.Eval(ip.y, shape_y, dshape_y);
+   basis1d.Eval(ip.z, shape_z, dshape_z);
 
    for (int o = 0, k = 0; k <= p; k++)
       for (int j = 0; j <= p; j++)
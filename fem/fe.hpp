@@ -37,6 +37,49 @@ class ElementTransformation;
 class Coefficient;
 class VectorCoefficient;
 class KnotVector;
+class FiniteElement;
+
+/** Values and reference gradients (or, for vector elements, the reference
+    vector values, curls and divergences) of the shape functions of a
+    FiniteElement evaluated at all points of an IntegrationRule, see
+    FiniteElement::GetDofToQuad(). */
+class DofToQuad
+{
+public:
+   /** FULL: the tables are indexed by the native dofs and all points of the
+       rule. TENSOR: only the 1D factors of a tensor-product basis at the 1D
+       points of a tensor-product rule are stored; they are indexed by the 1D
+       dofs and points, see TensorBasisElement. */
+   enum Mode { FULL, TENSOR };
+
+   const FiniteElement *FE;
+   const IntegrationRule *IntRule;
+   int mode;
+
+   /// Number of dofs and points: total in FULL mode, 1D in TENSOR mode
+   int ndof, nqpt;
+
+   /// Shape function values: B(q,i) = phi_i(x_q), size nqpt x ndof
+   DenseMatrix B;
+
+   /** FULL: G(q) is the ndof x dim matrix of reference gradients at point q,
+       as returned by CalcDShape(). TENSOR: G(0) is the nqpt x ndof matrix of
+       1D derivatives. */
+   DenseTensor G;
+
+   /** Vector elements (FULL mode only; B and G are empty): V(q) is the
+       ndof x dim matrix of reference shape functions at point q, as returned
+       by CalcVShape(). For H_CURL elements in 3D, C(q) holds the reference
+       curls (see CalcCurlShape()), and for H_DIV elements D(q,i) is the
+       reference divergence of shape function i (see CalcDivShape()). */
+   DenseTensor V, C;
+   DenseMatrix D;
+
+   /// Next table in the cache of the FiniteElement, see GetDofToQuad()
+   DofToQuad *next;
+
+   DofToQuad() : next(NULL) { }
+};
 
 /// Abstract class for Finite Elements
 class FiniteElement
@@ -45,6 +88,20 @@ protected:
    int Dim, GeomType, Dof, Order, FuncSpace, RangeType, MapType;
    IntegrationRule Nodes;
 
+   /** Cached DofToQuad tables, see GetDofToQuad(), linked through
+       DofToQuad::next. New tables are only prepended, and the tables are not
+       modified or removed while the element exists. */
+   mutable DofToQuad *dof2quad_list;
+
+   /** Return the cached table for the given rule and mode or NULL. This does
+       not lock and may be called concurrently with GetDofToQuad(). */
+   DofToQuad *FindDofToQuad(const IntegrationRule &ir, int mode) const;
+
+   /// Compute (without caching) the DofToQuad::FULL table using CalcDShape()
+   DofToQuad *ComputeDofToQuad(const IntegrationRule &ir) const;
+
+   friend class TensorBasisElement;
+
 public:
    /// Enumeration for RangeType
    enum { SCALAR, VECTOR };
@@ -109,6 +166,31 @@ public:
                            DenseMatrix &dshape) const = 0;
    const IntegrationRule & GetNodes() const { return Nodes; }
 
+   /** Compute the values and reference gradients of all (scalar) shape
+       functions at all points of the given IntegrationRule; the caller owns
+       the result. Mode DofToQuad::TENSOR is supported by the elements derived
+       from TensorBasisElement on tensor-product rules. Not available for
+       NURBS elements. */
+   virtual DofToQuad *NewDofToQuad(const IntegrationRule &ir, int mode) const;
+
+   /** Return true if the tables for the rule can be cached, i.e. if the rule
+       is one of the rules of IntRules or RefinedIntRules, which are never
+       modified or destroyed. */
+   bool CanCacheDofToQuad(const IntegrationRule &ir) const;
+
+   /** Return the tables of NewDofToQuad() for a rule with CanCacheDofToQuad().
+       The tables are computed on the first call and cached with the element
+       (i.e. shared by all mesh elements using it), keyed by the address of
+       the rule. */
+   const DofToQuad &GetDofToQuad(const IntegrationRule &ir, int mode) const;
+
+   /** Return the cached DofToQuad::FULL table for the given rule, or NULL if
+       the rule can not be cached or the element does not support the tables.
+       The integrators use the tables in place of the Calc...Shape() methods
+       when they are available. For vector elements only V, C and D are set
+       and B and G are empty, so users of B and G must check GetRangeType(). */
+   virtual const DofToQuad *GetFullDofToQuad(const IntegrationRule &ir) const;
+
    // virtual functions for finite elements on vector spaces
 
    /** This virtual function evaluates the values of all components of
@@ -190,7 +272,7 @@ public:
                            ElementTransformation &Trans,
                            DenseMatrix &div) const;
 
-   virtual ~FiniteElement () { }
+   virtual ~FiniteElement ();
 };
 
 class NodalFiniteElement : public FiniteElement
@@ -1295,6 +1377,43 @@ public:
 extern Poly_1D poly1d;
 
 
+/** Mixin for elements on quadrilaterals and hexahedra whose shape functions
+    are tensor products of a 1D basis. Provides the 1D factors needed by sum
+    factorization kernels. */
+class TensorBasisElement
+{
+protected:
+   Poly_1D::Basis &basis1d;
+   /** Map from the lexicographic to the native dof ordering; empty if the
+       native ordering is lexicographic. */
+   Array<int> dof_map;
+
+   /// Implementation of NewDofToQuad() for tensor-product elements
+   DofToQuad *NewTensorDofToQuad(const FiniteElement &fe,
+                                 const IntegrationRule &ir, int mode) const;
+
+public:
+   TensorBasisElement(Poly_1D::Basis &b) : basis1d(b) { }
+
+   /** If 'ir' is the tensor product (in dimension 'dim', with x varying
+       fastest) of a rule with the same points and weights in each direction
+       (with weights summing to 1, as for the reference segment), set 'ir1d'
+       to that 1D rule and return true; otherwise return false. The weights
+       are compared with a relative tolerance of 1e-12. */
+   static bool Get1DRule(const IntegrationRule &ir, int dim,
+                         IntegrationRule &ir1d);
+
+   /// Return the 1D basis whose tensor product defines the shape functions
+   const Poly_1D::Basis &GetBasis1D() const { return basis1d; }
+
+   /** Map from the lexicographic to the native dof ordering; empty if the
+       native ordering is lexicographic. */
+   const Array<int> &GetDofMap() const { return dof_map; }
+
+   virtual ~TensorBasisElement() { }
+};
+
+
 class H1_SegmentElement : public NodalFiniteElement
 {
 private:
@@ -1312,14 +1431,13 @@ public:
 };
 
 
-class H1_QuadrilateralElement : public NodalFiniteElement
+class H1_QuadrilateralElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, dshape_x, dshape_y;
 #endif
-   Array<int> dof_map;
 
 public:
    H1_QuadrilateralElement(const int p);
@@ -1327,18 +1445,18 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
-   const Array<int> &GetDofMap() const { return dof_map; }
+   virtual DofToQuad *NewDofToQuad(const IntegrationRule &ir, int mode) const
+   { return NewTensorDofToQuad(*this, ir, mode); }
 };
 
 
-class H1_HexahedronElement : public NodalFiniteElement
+class H1_HexahedronElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, shape_z, dshape_x, dshape_y, dshape_z;
 #endif
-   Array<int> dof_map;
 
 public:
    H1_HexahedronElement(const int p);
@@ -1346,7 +1464,8 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
-   const Array<int> &GetDofMap() const { return dof_map; }
+   virtual DofToQuad *NewDofToQuad(const IntegrationRule &ir, int mode) const
+   { return NewTensorDofToQuad(*this, ir, mode); }
 };
 
 class H1Pos_SegmentElement : public PositiveFiniteElement
@@ -1478,11 +1597,11 @@ public:
 };
 
 
-class L2_QuadrilateralElement : public NodalFiniteElement
+class L2_QuadrilateralElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int type;
-   Poly_1D::Basis *basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, dshape_x, dshape_y;
 #endif
@@ -1493,6 +1612,8 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
+   virtual DofToQuad *NewDofToQuad(const IntegrationRule &ir, int mode) const
+   { return NewTensorDofToQuad(*this, ir, mode); }
 };
 
 
@@ -1512,11 +1633,11 @@ public:
 };
 
 
-class L2_HexahedronElement : public NodalFiniteElement
+class L2_HexahedronElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int type;
-   Poly_1D::Basis *basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, shape_z, dshape_x, dshape_y, dshape_z;
 #endif
@@ -1527,6 +1648,8 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
+   virtual DofToQuad *NewDofToQuad(const IntegrationRule &ir, int mode) const
+   { return NewTensorDofToQuad(*this, ir, mode); }
 };
 
 
@@ -1949,6 +2072,15 @@ public:
    void                 SetElement (int e)    const { elem = e; }
    Array <KnotVector*> &KnotVectors()         const { return kv; }
    Vector              &Weights    ()         const { return weights; }
+
+   /// NURBS shape functions differ between elements and cannot be cached
+   virtual DofToQuad *NewDofToQuad(const IntegrationRule &ir, int mode) const
+   {
+      MFEM_ABORT("DofToQuad is not supported by NURBS elements");
+      return NULL;
+   }
+   virtual const DofToQuad *GetFullDofToQuad(const IntegrationRule &ir) const
+   { return NULL; }
 };
 
 class NURBS1DFiniteElement : public NURBSFiniteElement
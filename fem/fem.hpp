@@ -29,8 +29,10 @@
 #include "gridfunc.hpp"
 #include "linearform.hpp"
 #include "nonlinearform.hpp"
+#include "staticcond.hpp"
 #include "bilinearform.hpp"
 #include "datacollection.hpp"
+#include "multigrid.hpp"
 
 #ifdef MFEM_USE_MPI
 #include <mpi.h>
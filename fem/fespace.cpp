@@ -197,6 +197,123 @@ void FiniteElementSpace::BuildDofToArrays()
    }
 }
 
+void FiniteElementSpace::PermuteDofs(Array<int> &dofs) const
+{
+   for (int i = 0; i < dofs.Size(); i++)
+   {
+      const int d = dofs[i];
+      dofs[i] = (d >= 0) ? dof_perm[d] : -1-dof_perm[-1-d];
+   }
+}
+
+void FiniteElementSpace::CheckReorderDofs() const
+{
+   MFEM_VERIFY(!NURBSext && !cP, "dof reordering is not supported for NURBS"
+               " or non-conforming spaces");
+   MFEM_VERIFY(mesh->GetNodalFESpace() != this,
+               "the mesh nodal space can not be reordered");
+#ifdef MFEM_USE_MPI
+   // the shared dofs and the parallel numbering of ParFiniteElementSpace are
+   // built from the natural numbering
+   MFEM_VERIFY(dynamic_cast<const ParFiniteElementSpace *>(this) == NULL,
+               "dof reordering is not supported for parallel spaces");
+#endif
+}
+
+void FiniteElementSpace::ReorderDofs(const Array<int> &perm)
+{
+   CheckReorderDofs();
+   MFEM_VERIFY(perm.Size() == ndofs, "invalid permutation size: "
+               << perm.Size() << ", expected: " << ndofs);
+
+   Array<int> marker(ndofs);
+   marker = 0;
+   for (int i = 0; i < ndofs; i++)
+   {
+      MFEM_VERIFY(perm[i] >= 0 && perm[i] < ndofs && !marker[perm[i]],
+                  "the array is not a permutation");
+      marker[perm[i]] = 1;
+   }
+
+   // compose with the current reordering, if any
+   if (dof_perm.Size() == 0)
+   {
+      perm.Copy(dof_perm);
+   }
+   else
+   {
+      for (int i = 0; i < ndofs; i++)
+      {
+         dof_perm[i] = perm[dof_perm[i]];
+      }
+   }
+
+   delete elem_dof;
+   elem_dof = NULL;
+   dof_elem_array.DeleteAll();
+   dof_ldof_array.DeleteAll();
+   BuildElementToDofTable();
+}
+
+void FiniteElementSpace::ReorderDofsRCM()
+{
+   CheckReorderDofs();
+   BuildElementToDofTable();
+
+   // element-to-dof table without the orientation signs
+   Table el_dof;
+   const int nnz = elem_dof->Size_of_connections();
+   el_dof.SetDims(elem_dof->Size(), nnz);
+   for (int i = 0; i <= elem_dof->Size(); i++)
+   {
+      el_dof.GetI()[i] = elem_dof->GetI()[i];
+   }
+   for (int j = 0; j < nnz; j++)
+   {
+      const int d = elem_dof->GetJ()[j];
+      el_dof.GetJ()[j] = (d >= 0) ? d : -1-d;
+   }
+
+   Table dof_el, dof_dof;
+   Transpose(el_dof, dof_el, ndofs);
+   mfem::Mult(dof_el, el_dof, dof_dof);
+
+   Array<int> perm;
+   ReverseCuthillMcKee(dof_dof, perm);
+   ReorderDofs(perm);
+}
+
+void FiniteElementSpace::ReorderDofsByElements(const Array<int> &elem_order)
+{
+   CheckReorderDofs();
+   MFEM_VERIFY(elem_order.Size() == mesh->GetNE(), "invalid element ordering");
+
+   Array<int> perm(ndofs), dofs;
+   perm = -1;
+   int cnt = 0;
+   for (int k = 0; k < elem_order.Size(); k++)
+   {
+      GetElementDofs(elem_order[k], dofs);
+      for (int j = 0; j < dofs.Size(); j++)
+      {
+         const int d = (dofs[j] >= 0) ? dofs[j] : -1-dofs[j];
+         if (perm[d] < 0)
+         {
+            perm[d] = cnt++;
+         }
+      }
+   }
+   // dofs not associated with any element keep their relative order
+   for (int i = 0; i < ndofs; i++)
+   {
+      if (perm[i] < 0)
+      {
+         perm[i] = cnt++;
+      }
+   }
+   ReorderDofs(perm);
+}
+
 DenseMatrix * FiniteElementSpace::LocalInterpolation
 (int k, int num_c_dofs, RefinementType type, Array<int> &rows)
 {
@@ -549,6 +666,7 @@ FiniteElementSpace::FiniteElementSpace(FiniteElementSpace &fes)
    bdrElem_dof = fes.bdrElem_dof;
    Swap(dof_elem_array, fes.dof_elem_array);
    Swap(dof_ldof_array, fes.dof_ldof_array);
+   Swap(dof_perm, fes.dof_perm);
 
    NURBSext = fes.NURBSext;
    own_ext = 0;
@@ -808,6 +926,10 @@ void FiniteElementSpace::GetElementDofs (int i, Array<int> &dofs) const
       {
          dofs[ne+j] = k + j;
       }
+      if (dof_perm.Size())
+      {
+         PermuteDofs(dofs);
+      }
    }
 }
 
@@ -882,6 +1004,10 @@ void FiniteElementSpace::GetBdrElementDofs(int i, Array<int> &dofs) const
                dofs[ne+j] = nvdofs+nedofs+fdofs[iF]+ind[j];
          }
       }
+      if (dof_perm.Size())
+      {
+         PermuteDofs(dofs);
+      }
    }
 }
 
@@ -920,6 +1046,8 @@ void FiniteElementSpace::GetFaceDofs(int i, Array<int> &dofs) const
    if (nf > 0)
       for (j = nvdofs+nedofs+fdofs[i], k = 0; k < nf; j++, k++)
          dofs[ne+k] = j;
+   if (dof_perm.Size())
+      PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
@@ -939,6 +1067,8 @@ void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
    nv *= 2;
    for (j = 0, k = nvdofs+i*ne; j < ne; j++, k++)
       dofs[nv+j] = k;
+   if (dof_perm.Size())
+      PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
@@ -949,6 +1079,8 @@ void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
    dofs.SetSize(nv);
    for (j = 0; j < nv; j++)
       dofs[j] = i*nv+j;
+   if (dof_perm.Size())
+      PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
@@ -961,6 +1093,10 @@ void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k + j;
    }
+   if (dof_perm.Size())
+   {
+      PermuteDofs(dofs);
+   }
 }
 
 void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
@@ -971,6 +1107,8 @@ void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
    dofs.SetSize (ne);
    for (j = 0, k = nvdofs+i*ne; j < ne; j++, k++)
       dofs[j] = k;
+   if (dof_perm.Size())
+      PermuteDofs(dofs);
 }
 
 const FiniteElement *FiniteElementSpace::GetBE (int i) const
@@ -1042,6 +1180,7 @@ void FiniteElementSpace::Destructor()
 
    dof_elem_array.DeleteAll();
    dof_ldof_array.DeleteAll();
+   dof_perm.DeleteAll();
 
    if (NURBSext)
    {
@@ -86,6 +86,11 @@ protected:
    Table *bdrElem_dof;
    Array<int> dof_elem_array, dof_ldof_array;
 
+   /** Optional renumbering of the dofs: dof_perm[i] is the index of the i-th
+       dof of the natural (vertex, edge, face, interior) numbering. Empty if
+       the dofs have not been reordered. */
+   Array<int> dof_perm;
+
    NURBSExtension *NURBSext;
    int own_ext;
 
@@ -101,6 +106,12 @@ protected:
 
    void UpdateNURBS();
 
+   /// Map natural dof indices (possibly sign-encoded) to reordered ones.
+   void PermuteDofs(Array<int> &dofs) const;
+
+   /// Verify that the dofs of the space can be reordered, see ReorderDofs().
+   void CheckReorderDofs() const;
+
    void Constructor();
    void Destructor();   // does not destroy 'RefData'
 
@@ -254,6 +265,26 @@ public:
 
    void BuildDofToArrays();
 
+   /** Renumber the dofs of the space: dof i (in the current numbering)
+       becomes dof perm[i]. All dof queries (and hence GridFunction,
+       LinearForm and BilinearForm) use the new numbering afterwards, so this
+       should be called before any such objects are created. Reordering is
+       not supported for NURBS, non-conforming, parallel, or mesh nodal
+       spaces, and is reset by Update(). */
+   void ReorderDofs(const Array<int> &perm);
+
+   /** Reorder the dofs with the reverse Cuthill-McKee algorithm applied to
+       the dof-to-dof connectivity, reducing the bandwidth of the assembled
+       matrices. */
+   void ReorderDofsRCM();
+
+   /** Number the dofs in the order they are first encountered when visiting
+       the elements in the given order, e.g. from
+       Mesh::GetHilbertElementOrdering(). */
+   void ReorderDofsByElements(const Array<int> &elem_order);
+
+   bool DofsReordered() const { return (dof_perm.Size() > 0); }
+
    const Table &GetElementToDofTable() const { return *elem_dof; }
 
    int GetElementForDof(int i) { return dof_elem_array[i]; }
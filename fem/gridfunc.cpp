@@ -47,7 +47,20 @@ GridFunction::GridFunction(Mesh *m, std::istream &input)
    input >> ordering;
    input.getline(buff, bufflen); // read the empty line
    fes = new FiniteElementSpace(m, fec, vdim, ordering);
-   Vector::Load(input, fes->GetVSize());
+   input >> std::ws;
+   if (input.peek() == 'b')
+   {
+      input.getline(buff, bufflen); // 'binary'
+      int bom = 0; // byte order mark, see SaveBinary()
+      input.read(reinterpret_cast<char *>(&bom), sizeof(bom));
+      MFEM_VERIFY(input && bom == 1,
+                  "invalid binary GridFunction or byte order mismatch");
+      Vector::LoadBinary(input, fes->GetVSize());
+   }
+   else
+   {
+      Vector::Load(input, fes->GetVSize());
+   }
 }
 
 GridFunction::GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces)
@@ -1258,11 +1271,16 @@ double GridFunction::ComputeL2Error(
          ir = irs[fe->GetGeomType()];
       else
          ir = &(IntRules.Get(fe->GetGeomType(), intorder));
+      // use the cached basis tables for the default rules
+      const DofToQuad *maps = irs ? NULL : fe->GetFullDofToQuad(*ir);
       fes->GetElementVDofs(i, vdofs);
       for (j = 0; j < ir->GetNPoints(); j++)
       {
          const IntegrationPoint &ip = ir->IntPoint(j);
-         fe->CalcShape(ip, shape);
+         if (maps)
+            maps->B.GetRow(j, shape);
+         else
+            fe->CalcShape(ip, shape);
          for (d = 0; d < fes->GetVDim(); d++)
          {
             a = 0;
@@ -1805,6 +1823,15 @@ void GridFunction::Save(std::ostream &out) const
       Vector::Print(out, fes->GetVDim());
 }
 
+void GridFunction::SaveBinary(std::ostream &out) const
+{
+   fes->Save(out);
+   out << "binary\n";
+   const int bom = 1; // byte order mark
+   out.write(reinterpret_cast<const char *>(&bom), sizeof(bom));
+   Vector::PrintBinary(out);
+}
+
 void GridFunction::SaveVTK(std::ostream &out, const std::string &field_name, int ref)
 {
    Mesh *mesh = fes->GetMesh();
@@ -254,6 +254,12 @@ public:
    /// Save the GridFunction to an output stream.
    virtual void Save(std::ostream &out) const;
 
+   /** Save the GridFunction with the data written as raw doubles in the native
+       byte order, preceded by the int 1 as a byte order mark. The result can
+       be read back with the constructor GridFunction(Mesh *, std::istream &)
+       on a machine with the same byte order. */
+   virtual void SaveBinary(std::ostream &out) const;
+
    /** Write the GridFunction in VTK format. Note that Mesh::PrintVTK must be
        called first. The parameter ref must match the one used in
        Mesh::PrintVTK. */
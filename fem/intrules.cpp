@@ -239,6 +239,27 @@ void IntegrationRules::Set(int GeomType, int Order, IntegrationRule &IntRule)
    (*ir_array)[Order] = &IntRule;
 }
 
+bool IntegrationRules::Contains(int GeomType, const IntegrationRule &ir) const
+{
+   const Array<IntegrationRule *> *ir_array;
+
+   switch (GeomType)
+   {
+   case Geometry::POINT:       ir_array = &PointIntRules; break;
+   case Geometry::SEGMENT:     ir_array = &SegmentIntRules; break;
+   case Geometry::TRIANGLE:    ir_array = &TriangleIntRules; break;
+   case Geometry::SQUARE:      ir_array = &SquareIntRules; break;
+   case Geometry::TETRAHEDRON: ir_array = &TetrahedronIntRules; break;
+   case Geometry::CUBE:        ir_array = &CubeIntRules; break;
+   default: return false;
+   }
+
+   for (int i = 0; i < ir_array->Size(); i++)
+      if ((*ir_array)[i] == &ir)
+         return true;
+   return false;
+}
+
 void IntegrationRules::DeleteIntRuleArray(Array<IntegrationRule *> &ir_array)
 {
    int i;
@@ -254,6 +254,9 @@ public:
 
    void Set(int GeomType, int Order, IntegrationRule &IntRule);
 
+   /// Returns true if 'ir' is one of the rules for GeomType in the container.
+   bool Contains(int GeomType, const IntegrationRule &ir) const;
+
    void SetOwnRules(int o) { own_rules = o; }
 
    /// Destroys an IntegrationRules object
@@ -41,14 +41,21 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
       ir = &IntRules.Get(el.GetGeomType(), oa * el.GetOrder() + ob);
    }
 
+   Q.Eval(Qvals, Tr, *ir);
+   // the cached shape functions (NULL for NURBS elements)
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
+      double val = Tr.Weight() * Qvals(i);
 
-      el.CalcShape(ip, shape);
+      if (maps)
+         maps->B.GetRow(i, shape);
+      else
+         el.CalcShape(ip, shape);
 
       add(elvect, ip.weight * val, shape, elvect);
    }
@@ -70,14 +77,20 @@ void BoundaryLFIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
 
+   Q.Eval(Qvals, Tr, *ir);
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
+      double val = Tr.Weight() * Qvals(i);
 
-      el.CalcShape(ip, shape);
+      if (maps)
+         maps->B.GetRow(i, shape);
+      else
+         el.CalcShape(ip, shape);
 
       add(elvect, ip.weight * val, shape, elvect);
    }
@@ -173,6 +186,9 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
 
+   Q.Eval(Qvals, Tr, *ir);
+   const DofToQuad *maps = el.GetFullDofToQuad(*ir);
+
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
@@ -180,12 +196,14 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
       Tr.SetIntPoint (&ip);
       val = Tr.Weight();
 
-      el.CalcShape(ip, shape);
-      Q.Eval (Qvec, Tr, ip);
+      if (maps)
+         maps->B.GetRow(i, shape);
+      else
+         el.CalcShape(ip, shape);
 
       for (int k = 0; k < vdim; k++)
       {
-         cf = val * Qvec(k);
+         cf = val * Qvals(k,i);
 
          for (int s = 0; s < dof; s++)
             elvect(dof*k+s) += ip.weight * cf * shape(s);
@@ -200,7 +218,6 @@ void VectorBoundaryLFIntegrator::AssembleRHSElementVect(
    int dof  = el.GetDof();
 
    shape.SetSize(dof);
-   vec.SetSize(vdim);
 
    elvect.SetSize(dof * vdim);
    elvect = 0.0;
@@ -212,17 +229,18 @@ void VectorBoundaryLFIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
 
+   Q.Eval(Qvals, Tr, *ir);
+
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
-      Q.Eval(vec, Tr, ip);
       Tr.SetIntPoint (&ip);
-      vec *= Tr.Weight() * ip.weight;
+      const double w = Tr.Weight() * ip.weight;
       el.CalcShape(ip, shape);
       for (int k = 0; k < vdim; k++)
          for (int s = 0; s < dof; s++)
-            elvect(dof*k+s) += vec(k) * shape(s);
+            elvect(dof*k+s) += w * Qvals(k,i) * shape(s);
    }
 }
 
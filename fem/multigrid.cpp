@@ -0,0 +1,282 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class GeometricMultigrid
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+void GeometricMultigrid::Init(FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(fes.GetNURBSext() == NULL && fes.GetMesh()->ncmesh == NULL,
+               "only conforming, non-NURBS meshes are supported");
+
+   fespace = &fes;
+   coarse_solver = NULL;
+   own_coarse = false;
+   coarse_cg = NULL;
+   coarse_amg = NULL;
+}
+
+void GeometricMultigrid::RecordRefinement()
+{
+   Mesh *mesh = fespace->GetMesh();
+
+   MFEM_VERIFY(mesh->GetState() != Mesh::NORMAL,
+               "Mesh must be in two-level state, please call "
+               "Mesh::UseTwoLevelState before refining.");
+
+   ClearOperators(true);
+
+   FiniteElementSpace *cfes = fespace->SaveUpdate();
+
+   // the interpolation between the levels, as in UpdateAndInterpolate()
+   SparseMatrix *R = fespace->GlobalRestrictionMatrix(cfes, 0);
+   R->Finalize();
+
+   delete cfes;
+   mesh->SetState(Mesh::TWO_LEVEL_FINE);
+
+   SparseMatrix *Pl = Transpose(*R);
+   delete R;
+
+   // The essential dofs are eliminated from the coarse spaces and the coarse
+   // corrections do not change the essential dofs on the fine level. A coarse
+   // dof is essential if its basis function does not vanish on the essential
+   // boundary, i.e. if it is interpolated to some fine essential dof. (The
+   // boundary faces are not available in TWO_LEVEL_COARSE state in 3D.)
+   if (ess_bdr.Size())
+   {
+      Array<int> fmarker, cmarker(Pl->Width());
+      fespace->GetEssentialVDofs(ess_bdr, fmarker);
+      cmarker = 0;
+
+      int *I = Pl->GetI(), *J = Pl->GetJ();
+      double *V = Pl->GetData();
+      for (int i = 0; i < Pl->Height(); i++)
+         if (fmarker[i] < 0)
+            for (int j = I[i]; j < I[i+1]; j++)
+               if (fabs(V[j]) > 1e-12)
+                  cmarker[J[j]] = -1;
+      for (int i = 0; i < Pl->Height(); i++)
+         for (int j = I[i]; j < I[i+1]; j++)
+            if (fmarker[i] < 0 || cmarker[J[j]] < 0)
+               V[j] = 0.0;
+   }
+
+   P.Append(Pl);
+}
+
+void GeometricMultigrid::UniformRefinement()
+{
+   Mesh *mesh = fespace->GetMesh();
+   mesh->UseTwoLevelState(1);
+   mesh->UniformRefinement();
+   RecordRefinement();
+}
+
+void GeometricMultigrid::SetSmoother(int l, Solver &s, bool own)
+{
+   MFEM_VERIFY(0 < l && l < GetNumLevels(), "invalid level " << l);
+
+   if (S.Size() != GetNumLevels())
+   {
+      S.SetSize(GetNumLevels());
+      own_S.SetSize(GetNumLevels());
+      user_S.SetSize(GetNumLevels());
+      S = NULL;
+      own_S = false;
+      user_S = false;
+   }
+   if (own_S[l])
+      delete S[l];
+   S[l] = &s;
+   own_S[l] = own;
+   user_S[l] = true;
+   s.iterative_mode = true;
+}
+
+void GeometricMultigrid::SetCoarseSolver(Solver &s, bool own)
+{
+   if (coarse_cg)
+   {
+      delete coarse_cg;
+      delete coarse_amg;
+      coarse_cg = NULL;
+      coarse_amg = NULL;
+   }
+   if (own_coarse)
+      delete coarse_solver;
+   coarse_solver = &s;
+   own_coarse = own;
+   s.iterative_mode = false;
+   if (A.Size() > 0)
+      s.SetOperator(*A[0]);
+}
+
+void GeometricMultigrid::SetOperator(const Operator &op)
+{
+   const SparseMatrix *Af = dynamic_cast<const SparseMatrix *>(&op);
+   MFEM_VERIFY(Af != NULL, "the operator must be a SparseMatrix");
+   MFEM_VERIFY(Af->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(Af->Height() == fespace->GetVSize() &&
+               Af->Width() == fespace->GetVSize(),
+               "the operator does not match the finest space; was the last "
+               "refinement recorded?");
+
+   ClearOperators(false);
+
+   const int L = GetNumLevels();
+   height = width = Af->Height();
+
+   A.SetSize(L);
+   A_own.SetSize(L);
+   A_own = NULL;
+   A[L-1] = Af;
+   for (int l = L-2; l >= 0; l--)
+   {
+      // Galerkin product; the rows and columns of the eliminated essential
+      // dofs are zero and get a unit diagonal
+      A_own[l] = RAP(*P[l], *A[l+1], *P[l]);
+      A_own[l]->EliminateZeroRows();
+      A[l] = A_own[l];
+   }
+
+   if (S.Size() != L)
+   {
+      S.SetSize(L);
+      own_S.SetSize(L);
+      user_S.SetSize(L);
+      S = NULL;
+      own_S = false;
+      user_S = false;
+   }
+   for (int l = 1; l < L; l++)
+      if (S[l] == NULL)
+      {
+         S[l] = new DSmoother(*A[l], 1, 1.0, 2);
+         S[l]->iterative_mode = true;
+         own_S[l] = true;
+      }
+
+   if (coarse_solver == NULL)
+   {
+      coarse_amg = new AMGSolver(*A[0]);
+      coarse_cg = new CGSolver;
+      coarse_cg->SetRelTol(1e-12);
+      coarse_cg->SetAbsTol(0.0);
+      coarse_cg->SetMaxIter(500);
+      coarse_cg->SetPrintLevel(-1);
+      coarse_cg->SetPreconditioner(*coarse_amg);
+      coarse_cg->SetOperator(*A[0]);
+      coarse_cg->iterative_mode = false;
+      coarse_solver = coarse_cg;
+   }
+   else
+   {
+      coarse_solver->SetOperator(*A[0]);
+   }
+
+   X.SetSize(L);
+   B.SetSize(L);
+   Res.SetSize(L);
+   for (int l = 0; l < L; l++)
+   {
+      X[l] = (l < L-1) ? new Vector(A[l]->Height()) : NULL;
+      B[l] = (l < L-1) ? new Vector(A[l]->Height()) : NULL;
+      Res[l] = (l > 0) ? new Vector(A[l]->Height()) : NULL;
+   }
+}
+
+void GeometricMultigrid::ClearOperators(bool smoothers)
+{
+   for (int l = 0; l < A_own.Size(); l++)
+      delete A_own[l];
+   A.SetSize(0);
+   A_own.SetSize(0);
+
+   // the default smoothers depend on the operators
+   for (int l = 0; l < S.Size(); l++)
+      if (!user_S[l] || smoothers)
+      {
+         if (own_S[l])
+            delete S[l];
+         S[l] = NULL;
+         own_S[l] = false;
+         user_S[l] = false;
+      }
+
+   if (coarse_cg)
+   {
+      delete coarse_cg;
+      delete coarse_amg;
+      coarse_cg = NULL;
+      coarse_amg = NULL;
+      coarse_solver = NULL;
+   }
+
+   for (int l = 0; l < X.Size(); l++)
+   {
+      delete X[l];
+      delete B[l];
+      delete Res[l];
+   }
+   X.SetSize(0);
+   B.SetSize(0);
+   Res.SetSize(0);
+}
+
+void GeometricMultigrid::Cycle(int l, const Vector &b, Vector &x) const
+{
+   if (l == 0)
+   {
+      coarse_solver->Mult(b, x);
+      return;
+   }
+
+   Vector &r = *Res[l];
+
+   // pre-smoothing
+   S[l]->Mult(b, x);
+
+   // coarse-grid correction
+   A[l]->Mult(x, r);
+   subtract(b, r, r);
+   P[l-1]->MultTranspose(r, *B[l-1]);
+   *X[l-1] = 0.0;
+   Cycle(l-1, *B[l-1], *X[l-1]);
+   P[l-1]->AddMult(*X[l-1], x);
+
+   // post-smoothing
+   S[l]->Mult(b, x);
+}
+
+void GeometricMultigrid::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(A.Size() > 0, "the operator is not set");
+
+   if (!iterative_mode)
+      x = 0.0;
+   Cycle(A.Size()-1, b, x);
+}
+
+GeometricMultigrid::~GeometricMultigrid()
+{
+   ClearOperators(true);
+   if (own_coarse)
+      delete coarse_solver;
+   for (int l = 0; l < P.Size(); l++)
+      delete P[l];
+}
+
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIGRID
+#define MFEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../linalg/linalg.hpp"
+#include "fespace.hpp"
+
+namespace mfem
+{
+
+/** Geometric multigrid preconditioner for a FiniteElementSpace on a mesh that
+    is refined (conformingly) after the construction of the solver. The
+    refinement sequence is recorded level by level: the prolongation between
+    two consecutive levels is the interpolation used to transfer
+    GridFunctions after refinement (see
+    FiniteElementSpace::GlobalRestrictionMatrix), with the essential boundary
+    dofs removed from the coarse spaces. The coarse-level operators are
+    Galerkin products of the fine-level SparseMatrix.
+
+    Each application of the solver is one V-cycle. The default smoother is
+    two sweeps of l1-Jacobi on every level and the coarsest level is solved
+    with AMG-preconditioned CG; any Solver (e.g. a matrix-free one) can be
+    used as a smoother instead, see SetSmoother(). With symmetric smoothers the
+    cycle is symmetric and can be used as a preconditioner in CGSolver.
+
+    Typical use:
+
+    FiniteElementSpace fespace(mesh, fec);   // on the coarse mesh
+    GeometricMultigrid mg(fespace, ess_bdr);
+    for (int l = 0; l < levels; l++)
+       mg.UniformRefinement();               // refines mesh and fespace
+    ... assemble and eliminate the system A X = B on the fine space ...
+    mg.SetOperator(A);
+    pcg.SetPreconditioner(mg); */
+class GeometricMultigrid : public Solver
+{
+protected:
+   FiniteElementSpace *fespace;
+   Array<int> ess_bdr;
+
+   /// Prolongations from level l to l+1; level 0 is the coarsest level
+   Array<SparseMatrix *> P;
+
+   Array<const SparseMatrix *> A;
+   Array<SparseMatrix *> A_own;  ///< the Galerkin operators
+   Array<Solver *> S;
+   Array<bool> own_S, user_S;  ///< user_S: set with SetSmoother()
+
+   Solver *coarse_solver;
+   bool own_coarse;
+   CGSolver *coarse_cg;
+   AMGSolver *coarse_amg;
+
+   mutable Array<Vector *> X, B, Res;
+
+   void Init(FiniteElementSpace &fes);
+   /// Delete the operators, and the user smoothers if 'smoothers' is true
+   void ClearOperators(bool smoothers);
+
+   void Cycle(int l, const Vector &b, Vector &x) const;
+
+public:
+   /// Start the hierarchy with the given space on the (coarsest) mesh
+   GeometricMultigrid(FiniteElementSpace &fes) { Init(fes); }
+
+   /** Same as above; the dofs on the boundary attributes marked in
+       'bdr_attr_is_ess' are removed from all the levels. */
+   GeometricMultigrid(FiniteElementSpace &fes,
+                      const Array<int> &bdr_attr_is_ess)
+   { Init(fes); bdr_attr_is_ess.Copy(ess_bdr); }
+
+   /** Add a level after the mesh of the space was refined in two-level state
+       (see Mesh::UseTwoLevelState). This replaces the call to
+       FiniteElementSpace::Update(); GridFunctions on the space must still be
+       updated by the caller. */
+   void RecordRefinement();
+
+   /// Refine the mesh uniformly and record the new level
+   void UniformRefinement();
+
+   int GetNumLevels() const { return P.Size()+1; }
+
+   /// The prolongation from level l to level l+1
+   const SparseMatrix &GetProlongation(int l) const { return *P[l]; }
+
+   /// The operator on level l, available after SetOperator()
+   const SparseMatrix &GetLevelOperator(int l) const { return *A[l]; }
+
+   /** Use S as the smoother on level l > 0 (finest level: GetNumLevels()-1)
+       instead of l1-Jacobi. Only S.Mult() is used, with S.iterative_mode set
+       to true, so S can be matrix-free, but it must already be set up for the
+       operator of the level. The user smoothers are reset by
+       RecordRefinement(). */
+   void SetSmoother(int l, Solver &s, bool own = false);
+
+   /** Use the given solver on the coarsest level. Its operator is set to the
+       coarsest-level operator, here and by every call to SetOperator(). */
+   void SetCoarseSolver(Solver &s, bool own = false);
+
+   /** Set the fine-level operator, a SparseMatrix on the current (finest)
+       space, and compute the coarse-level operators. */
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply one V-cycle to A x = b
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~GeometricMultigrid();
+};
+
+}
+
+#endif
@@ -16,6 +16,8 @@
 #include "fem.hpp"
 #include <iostream>
 #include <limits>
+#include <sstream>
+#include <string>
 using namespace std;
 
 namespace mfem
@@ -61,6 +63,33 @@ ParGridFunction::ParGridFunction(ParMesh *pmesh, GridFunction *gf, int * partiti
    }
 }
 
+static const char *pgf_checkpoint_header =
+   "MFEM ParGridFunction checkpoint v1.0";
+
+void ParGridFunction::LoadLocal(ParMesh *pmesh, std::istream &input)
+{
+   GridFunction gf(pmesh, input);
+
+   fec = FiniteElementCollection::New(gf.FESpace()->FEColl()->Name());
+   fes = pfes = new ParFiniteElementSpace(pmesh, fec, gf.FESpace()->GetVDim(),
+                                          gf.FESpace()->GetOrdering());
+   Vector::operator=(gf);
+
+   // undo the sign changes applied by Save() and SaveBinary()
+   for (int i = 0; i < size; i++)
+      if (pfes->GetDofSign(i) < 0)
+         data[i] = -data[i];
+}
+
+ParGridFunction::ParGridFunction(ParMesh *pmesh, const char *checkpoint_file)
+{
+   string block;
+   ReadSharedFile(pmesh->GetComm(), checkpoint_file, pgf_checkpoint_header,
+                  block);
+   istringstream input(block);
+   LoadLocal(pmesh, input);
+}
+
 void ParGridFunction::Update(ParFiniteElementSpace *f)
 {
    face_nbr_data.Destroy();
@@ -260,6 +289,27 @@ void ParGridFunction::Save(std::ostream &out) const
          data[i] = -data[i];
 }
 
+void ParGridFunction::SaveBinary(std::ostream &out) const
+{
+   for (int i = 0; i < size; i++)
+      if (pfes->GetDofSign(i) < 0)
+         data[i] = -data[i];
+
+   GridFunction::SaveBinary(out);
+
+   for (int i = 0; i < size; i++)
+      if (pfes->GetDofSign(i) < 0)
+         data[i] = -data[i];
+}
+
+void ParGridFunction::SaveCheckpoint(const char *filename) const
+{
+   ostringstream out;
+   SaveBinary(out);
+   WriteSharedFile(pfes->GetComm(), filename, pgf_checkpoint_header,
+                   out.str());
+}
+
 void ParGridFunction::SaveAsOne(std::ostream &out)
 {
    int i, p;
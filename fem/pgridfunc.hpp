@@ -35,6 +35,10 @@ protected:
 
    Vector face_nbr_data;
 
+   /** Read the local data written by SaveBinary() (or Save()) and create the
+       owned ParFiniteElementSpace on 'pmesh'. */
+   void LoadLocal(ParMesh *pmesh, std::istream &input);
+
 public:
    ParGridFunction() { pfes = NULL; }
 
@@ -52,6 +56,15 @@ public:
        If partitioning == NULL (default), the data from 'gf' is NOT copied. */
    ParGridFunction(ParMesh *pmesh, GridFunction *gf, int * partitioning = NULL);
 
+   /** Construct a ParGridFunction on 'pmesh' from the local data in 'input',
+       as written by Save() or SaveBinary() on the same rank. */
+   ParGridFunction(ParMesh *pmesh, std::istream &input)
+   { LoadLocal(pmesh, input); }
+
+   /** Restart from a file written by SaveCheckpoint(); 'pmesh' must be
+       restarted from the matching ParMesh checkpoint. */
+   ParGridFunction(ParMesh *pmesh, const char *checkpoint_file);
+
    ParGridFunction &operator=(double value)
    { GridFunction::operator=(value); return *this; }
 
@@ -186,6 +199,13 @@ public:
        the local dofs. */
    virtual void Save(std::ostream &out) const;
 
+   /// Binary version of Save(), see GridFunction::SaveBinary().
+   virtual void SaveBinary(std::ostream &out) const;
+
+   /** Write the local portions of all ranks into one shared binary file
+       using MPI-IO, see ParMesh::SaveCheckpoint(). */
+   void SaveCheckpoint(const char *filename) const;
+
    /// Merge the local grid functions
    void SaveAsOne(std::ostream &out = std::cout);
 
@@ -0,0 +1,293 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class StaticCondensation
+
+#include "fem.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace mfem
+{
+
+// LU factorization with partial pivoting of the n x n matrix A (by columns)
+static void LUFactor(int n, double *A, int *piv)
+{
+   for (int k = 0; k < n; k++)
+   {
+      int p = k;
+      for (int i = k+1; i < n; i++)
+         if (fabs(A[i+n*k]) > fabs(A[p+n*k]))
+            p = i;
+      MFEM_VERIFY(A[p+n*k] != 0.0, "the interior block is singular");
+      piv[k] = p;
+      if (p != k)
+         for (int j = 0; j < n; j++)
+            std::swap(A[k+n*j], A[p+n*j]);
+
+      const double d = 1.0/A[k+n*k];
+      for (int i = k+1; i < n; i++)
+         A[i+n*k] *= d;
+      for (int j = k+1; j < n; j++)
+      {
+         const double a = A[k+n*j];
+         if (a != 0.0)
+            for (int i = k+1; i < n; i++)
+               A[i+n*j] -= A[i+n*k]*a;
+      }
+   }
+}
+
+// Overwrite the n x m matrix X (by columns) with A^{-1} X, given the factors
+// computed by LUFactor()
+static void LUSolve(int n, const double *LU, const int *piv, int m, double *X)
+{
+   for (int c = 0; c < m; c++)
+   {
+      double *x = X + n*c;
+      for (int i = 0; i < n; i++)
+         std::swap(x[i], x[piv[i]]);
+      for (int j = 0; j < n; j++)
+      {
+         const double xj = x[j];
+         for (int i = j+1; i < n; i++)
+            x[i] -= LU[i+n*j]*xj;
+      }
+      for (int j = n-1; j >= 0; j--)
+      {
+         x[j] /= LU[j+n*j];
+         const double xj = x[j];
+         for (int i = 0; i < j; i++)
+            x[i] -= LU[i+n*j]*xj;
+      }
+   }
+}
+
+StaticCondensation::StaticCondensation(FiniteElementSpace *fespace)
+{
+   fes = fespace;
+   S = NULL;
+
+   MFEM_VERIFY(fes->GetNURBSext() == NULL &&
+               fes->GetConformingProlongation() == NULL,
+               "only conforming, non-NURBS spaces are supported");
+#ifdef MFEM_USE_MPI
+   // the reduced matrix is not connected to the parallel assembly, see
+   // ParBilinearForm::ParallelAssemble()
+   MFEM_VERIFY(dynamic_cast<ParFiniteElementSpace *>(fes) == NULL,
+               "static condensation is not supported for parallel spaces");
+#endif
+
+   const int vsize = fes->GetVSize(), ne = fes->GetNE();
+   Array<int> vdofs;
+
+   vdof_to_rdof.SetSize(vsize);
+   vdof_to_rdof = 0;
+   for (int el = 0; el < ne; el++)
+   {
+      fes->GetElementInteriorVDofs(el, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+         vdof_to_rdof[vdofs[j]] = -1;
+   }
+   for (int v = 0; v < vsize; v++)
+      if (vdof_to_rdof[v] == 0)
+         vdof_to_rdof[v] = rdof_to_vdof.Append(v) - 1;
+
+   A_ptr.SetSize(ne+1);
+   i_ptr.SetSize(ne+1);
+   A_ptr[0] = i_ptr[0] = 0;
+   for (int el = 0; el < ne; el++)
+   {
+      fes->GetElementInteriorVDofs(el, vdofs);
+      const int ni = vdofs.Size();
+      fes->GetElementVDofs(el, vdofs);
+      const int nx = vdofs.Size() - ni;
+      A_ptr[el+1] = A_ptr[el] + ni*(ni + 2*nx);
+      i_ptr[el+1] = i_ptr[el] + ni;
+   }
+   A_data.SetSize(A_ptr[ne]);
+   ipiv.SetSize(i_ptr[ne]);
+}
+
+void StaticCondensation::SplitElementVDofs(
+   int el, Array<int> &i_loc, Array<int> &i_vdofs,
+   Array<int> &e_loc, Array<int> &e_rdofs) const
+{
+   Array<int> vdofs;
+   fes->GetElementVDofs(el, vdofs);
+
+   i_loc.SetSize(0);
+   i_vdofs.SetSize(0);
+   e_loc.SetSize(0);
+   e_rdofs.SetSize(0);
+   for (int j = 0; j < vdofs.Size(); j++)
+   {
+      const int v = vdofs[j];
+      const int r = vdof_to_rdof[(v >= 0) ? v : -1-v];
+      if (r < 0)
+      {
+         i_loc.Append(j);
+         i_vdofs.Append(v);
+      }
+      else
+      {
+         e_loc.Append(j);
+         e_rdofs.Append((v >= 0) ? r : -1-r);
+      }
+   }
+}
+
+void StaticCondensation::SolveInterior(int el, int ni, Vector &b_i) const
+{
+   LUSolve(ni, A_data.GetData() + A_ptr[el], ipiv.GetData() + i_ptr[el], 1,
+           b_i.GetData());
+}
+
+void StaticCondensation::Init()
+{
+   delete S;
+   S = new SparseMatrix(GetNExDofs());
+}
+
+void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat,
+                                        int skip_zeros)
+{
+   Array<int> i_loc, i_vdofs, e_loc, e_rdofs;
+   SplitElementVDofs(el, i_loc, i_vdofs, e_loc, e_rdofs);
+   const int ni = i_loc.Size(), nx = e_loc.Size();
+   MFEM_ASSERT(ni == i_ptr[el+1] - i_ptr[el], "invalid interior dofs");
+
+   double *A_ii = A_data.GetData() + A_ptr[el];
+   double *A_ie = A_ii + ni*ni;
+   double *A_ei = A_ie + ni*nx;
+   for (int j = 0; j < ni; j++)
+      for (int i = 0; i < ni; i++)
+         A_ii[i+ni*j] = elmat(i_loc[i], i_loc[j]);
+   for (int j = 0; j < nx; j++)
+      for (int i = 0; i < ni; i++)
+         A_ie[i+ni*j] = elmat(i_loc[i], e_loc[j]);
+   for (int j = 0; j < ni; j++)
+      for (int i = 0; i < nx; i++)
+         A_ei[i+nx*j] = elmat(e_loc[i], i_loc[j]);
+
+   // A_ie := A_ii^{-1} A_ie
+   LUFactor(ni, A_ii, ipiv.GetData() + i_ptr[el]);
+   LUSolve(ni, A_ii, ipiv.GetData() + i_ptr[el], nx, A_ie);
+
+   // the Schur complement A_ee - A_ei A_ii^{-1} A_ie of the element
+   DenseMatrix S_e(nx);
+   for (int j = 0; j < nx; j++)
+      for (int i = 0; i < nx; i++)
+      {
+         double s = elmat(e_loc[i], e_loc[j]);
+         for (int k = 0; k < ni; k++)
+            s -= A_ei[i+nx*k]*A_ie[k+ni*j];
+         S_e(i,j) = s;
+      }
+   S->AddSubMatrix(e_rdofs, e_rdofs, S_e, skip_zeros);
+}
+
+void StaticCondensation::AssembleBdrMatrix(int el, const DenseMatrix &elmat,
+                                           int skip_zeros)
+{
+   Array<int> rdofs;
+   fes->GetBdrElementVDofs(el, rdofs);
+   for (int j = 0; j < rdofs.Size(); j++)
+   {
+      const int v = rdofs[j];
+      const int r = vdof_to_rdof[(v >= 0) ? v : -1-v];
+      MFEM_ASSERT(r >= 0, "boundary element with interior dofs");
+      rdofs[j] = (v >= 0) ? r : -1-r;
+   }
+   S->AddSubMatrix(rdofs, rdofs, elmat, skip_zeros);
+}
+
+void StaticCondensation::ReduceRHS(const Vector &b, Vector &sc_b) const
+{
+   Array<int> i_loc, i_vdofs, e_loc, e_rdofs;
+   Vector b_i, y;
+
+   sc_b.SetSize(GetNExDofs());
+   for (int r = 0; r < rdof_to_vdof.Size(); r++)
+      sc_b(r) = b(rdof_to_vdof[r]);
+
+   for (int el = 0; el < fes->GetNE(); el++)
+   {
+      SplitElementVDofs(el, i_loc, i_vdofs, e_loc, e_rdofs);
+      const int ni = i_loc.Size(), nx = e_loc.Size();
+      if (ni == 0)
+         continue;
+
+      b.GetSubVector(i_vdofs, b_i);
+      SolveInterior(el, ni, b_i);
+
+      // sc_b_e -= A_ei A_ii^{-1} b_i
+      const double *A_ei = A_data.GetData() + A_ptr[el] + ni*(ni + nx);
+      y.SetSize(nx);
+      y = 0.0;
+      for (int k = 0; k < ni; k++)
+         for (int i = 0; i < nx; i++)
+            y(i) += A_ei[i+nx*k]*b_i(k);
+      sc_b.AddElementVector(e_rdofs, -1.0, y);
+   }
+}
+
+void StaticCondensation::ReduceSolution(const Vector &x, Vector &sc_x) const
+{
+   sc_x.SetSize(GetNExDofs());
+   for (int r = 0; r < rdof_to_vdof.Size(); r++)
+      sc_x(r) = x(rdof_to_vdof[r]);
+}
+
+void StaticCondensation::EliminateEssentialBC(
+   const Array<int> &bdr_attr_is_ess, const Vector &sc_x, Vector &sc_b, int d)
+{
+   Array<int> ess_vdofs;
+   fes->GetEssentialVDofs(bdr_attr_is_ess, ess_vdofs);
+   for (int v = 0; v < ess_vdofs.Size(); v++)
+      if (ess_vdofs[v] < 0)
+      {
+         const int r = vdof_to_rdof[v];
+         MFEM_ASSERT(r >= 0, "essential interior dof");
+         S->EliminateRowCol(r, sc_x(r), sc_b, d);
+      }
+}
+
+void StaticCondensation::ComputeSolution(const Vector &b, const Vector &sc_x,
+                                         Vector &x) const
+{
+   Array<int> i_loc, i_vdofs, e_loc, e_rdofs;
+   Vector x_i, x_e;
+
+   x.SetSize(fes->GetVSize());
+   for (int r = 0; r < rdof_to_vdof.Size(); r++)
+      x(rdof_to_vdof[r]) = sc_x(r);
+
+   for (int el = 0; el < fes->GetNE(); el++)
+   {
+      SplitElementVDofs(el, i_loc, i_vdofs, e_loc, e_rdofs);
+      const int ni = i_loc.Size(), nx = e_loc.Size();
+      if (ni == 0)
+         continue;
+
+      // x_i = A_ii^{-1} b_i - (A_ii^{-1} A_ie) x_e
+      b.GetSubVector(i_vdofs, x_i);
+      SolveInterior(el, ni, x_i);
+      sc_x.GetSubVector(e_rdofs, x_e);
+      const double *A_ie = A_data.GetData() + A_ptr[el] + ni*ni;
+      for (int j = 0; j < nx; j++)
+         for (int k = 0; k < ni; k++)
+            x_i(k) -= A_ie[k+ni*j]*x_e(j);
+      x.SetSubVector(i_vdofs, x_i);
+   }
+}
+
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_STATICCOND
+#define MFEM_STATICCOND
+
+#include "../config/config.hpp"
+#include "../linalg/linalg.hpp"
+#include "fespace.hpp"
+
+namespace mfem
+{
+
+/** Static condensation of the element interior dofs (see
+    FiniteElementSpace::GetElementInteriorDofs) of a BilinearForm. Each element
+    matrix is split into interior (i) and exposed (e) blocks, the interior
+    block A_ii is factored and only the Schur complement
+    S = A_ee - A_ei A_ii^{-1} A_ie is assembled into the global matrix on the
+    exposed (vertex, edge and face) dofs. The element factors are stored, so
+    that the right-hand side can be reduced and the interior part of the
+    solution recovered element by element.
+
+    The exposed vdofs are numbered in increasing order of the vdofs of the
+    space. Typical use, through BilinearForm::EnableStaticCondensation():
+
+    a.EnableStaticCondensation();
+    a.Assemble();
+    StaticCondensation &sc = *a.GetStaticCondensation();
+    sc.ReduceRHS(b, sc_b);
+    sc.ReduceSolution(x, sc_x);         // initial guess and b.c. values
+    sc.EliminateEssentialBC(ess_bdr, sc_x, sc_b);
+    a.Finalize();
+    ... solve sc.GetMatrix() sc_x = sc_b ...
+    sc.ComputeSolution(b, sc_x, x); */
+class StaticCondensation
+{
+protected:
+   FiniteElementSpace *fes;
+
+   /// Index of each vdof in the reduced system, or -1 for interior vdofs
+   Array<int> vdof_to_rdof;
+   /// The vdofs of the reduced system
+   Array<int> rdof_to_vdof;
+
+   SparseMatrix *S;
+
+   /** For each element: the LU factors of A_ii, the matrix A_ii^{-1} A_ie and
+       the matrix A_ei, stored by columns starting at A_data[A_ptr[el]], and
+       the pivots of A_ii starting at ipiv[i_ptr[el]]. */
+   Array<int> A_ptr, i_ptr;
+   Array<double> A_data;
+   Array<int> ipiv;
+
+   /** Split the vdofs of the element into the interior vdofs and the
+       (sign-encoded) reduced indices of the exposed vdofs, with their
+       positions in the element vdofs. */
+   void SplitElementVDofs(int el, Array<int> &i_loc, Array<int> &i_vdofs,
+                          Array<int> &e_loc, Array<int> &e_rdofs) const;
+
+   /// Compute A_ii^{-1} b_i for the interior values b_i of element el
+   void SolveInterior(int el, int ni, Vector &b_i) const;
+
+public:
+   StaticCondensation(FiniteElementSpace *fespace);
+
+   /// Number of exposed vdofs, the size of the reduced system
+   int GetNExDofs() const { return rdof_to_vdof.Size(); }
+
+   /// The vdofs of the reduced system
+   const Array<int> &GetExposedVDofs() const { return rdof_to_vdof; }
+
+   /// Start a new assembly, deleting the reduced matrix
+   void Init();
+
+   /** Condense the full element matrix of element el (on its vdofs) and add
+       its Schur complement to the reduced matrix. */
+   void AssembleMatrix(int el, const DenseMatrix &elmat, int skip_zeros = 1);
+
+   /// Add the matrix of boundary element el, which has no interior dofs
+   void AssembleBdrMatrix(int el, const DenseMatrix &elmat,
+                          int skip_zeros = 1);
+
+   /// Finalize the reduced matrix
+   void Finalize(int skip_zeros = 1) { S->Finalize(skip_zeros); }
+
+   /// The reduced (Schur complement) matrix
+   SparseMatrix &GetMatrix() { return *S; }
+   const SparseMatrix &GetMatrix() const { return *S; }
+
+   /** Compute the reduced right-hand side sc_b = b_e - A_ei A_ii^{-1} b_i
+       from the full right-hand side b. */
+   void ReduceRHS(const Vector &b, Vector &sc_b) const;
+
+   /// Restrict the full vector x to the exposed vdofs
+   void ReduceSolution(const Vector &x, Vector &sc_x) const;
+
+   /** Eliminate the essential b.c. (whose dofs are always exposed) from the
+       reduced system, with the values given in sc_x. If d == 0 the diagonal
+       at the ess. b.c. is set to 1.0, otherwise leave it the same. */
+   void EliminateEssentialBC(const Array<int> &bdr_attr_is_ess,
+                             const Vector &sc_x, Vector &sc_b, int d = 0);
+
+   /** Compute the full solution x from the solution sc_x of the reduced
+       system and the full right-hand side b: x_e = sc_x and
+       x_i = A_ii^{-1} (b_i - A_ie x_e). */
+   void ComputeSolution(const Vector &b, const Vector &sc_x, Vector &x) const;
+
+   ~StaticCondensation() { delete S; }
+};
+
+}
+
+#endif
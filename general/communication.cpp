@@ -20,6 +20,8 @@
 #include "sets.hpp"
 #include "communication.hpp"
 #include <iostream>
+#include <climits>
+#include <cstring>
 using namespace std;
 
 namespace mfem
@@ -467,6 +469,109 @@ template void GroupCommunicator::Sum<double>(OpData<double>);
 template void GroupCommunicator::Min<double>(OpData<double>);
 template void GroupCommunicator::Max<double>(OpData<double>);
 
+
+// Layout of the shared files: header string, number of ranks (plus one
+// reserved int), block offsets, blocks
+static const int shared_file_header_size = 64;
+static const MPI_Offset shared_file_index_start =
+   shared_file_header_size + 2*sizeof(int);
+
+void WriteSharedFile(MPI_Comm comm, const char *filename, const char *header,
+                     const std::string &block)
+{
+   int myid, np;
+   MPI_Comm_rank(comm, &myid);
+   MPI_Comm_size(comm, &np);
+
+   MFEM_VERIFY(strlen(header) < (size_t) shared_file_header_size,
+               "header is too long: " << header);
+   MFEM_VERIFY(block.size() <= (size_t) INT_MAX,
+               "data block is too large: " << block.size());
+
+   // each rank computes the offset of its block; rank 0 writes the index
+   long long size = block.size(), offset = 0, total = 0;
+   MPI_Exscan(&size, &offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+   if (myid == 0)
+      offset = 0;
+   MPI_Reduce(&size, &total, 1, MPI_LONG_LONG, MPI_SUM, 0, comm);
+   long long *offsets = (myid == 0) ? new long long[np+1] : NULL;
+   MPI_Gather(&offset, 1, MPI_LONG_LONG, offsets, 1, MPI_LONG_LONG, 0, comm);
+
+   MPI_File fh;
+   MPI_Status status;
+   int err = MPI_File_open(comm, const_cast<char *>(filename),
+                           MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                           &fh);
+   MFEM_VERIFY(err == MPI_SUCCESS, "unable to open file: " << filename);
+   MPI_File_set_size(fh, 0);
+
+   if (myid == 0)
+   {
+      char head[shared_file_header_size];
+      memset(head, 0, sizeof(head));
+      strcpy(head, header);
+      int info[2] = { np, 0 };
+      offsets[np] = total;
+      MPI_File_write_at(fh, 0, head, shared_file_header_size, MPI_CHAR,
+                        &status);
+      MPI_File_write_at(fh, shared_file_header_size, info, 2, MPI_INT,
+                        &status);
+      MPI_File_write_at(fh, shared_file_index_start, offsets, np+1,
+                        MPI_LONG_LONG, &status);
+      delete [] offsets;
+   }
+
+   const MPI_Offset data_start =
+      shared_file_index_start + (np+1)*sizeof(long long);
+   err = MPI_File_write_at_all(fh, data_start + offset,
+                               const_cast<char *>(block.data()), int(size),
+                               MPI_BYTE, &status);
+   MFEM_VERIFY(err == MPI_SUCCESS, "error writing file: " << filename);
+   MPI_File_close(&fh);
+}
+
+void ReadSharedFile(MPI_Comm comm, const char *filename, const char *header,
+                    std::string &block)
+{
+   int myid, np;
+   MPI_Comm_rank(comm, &myid);
+   MPI_Comm_size(comm, &np);
+
+   MPI_File fh;
+   MPI_Status status;
+   int err = MPI_File_open(comm, const_cast<char *>(filename), MPI_MODE_RDONLY,
+                           MPI_INFO_NULL, &fh);
+   MFEM_VERIFY(err == MPI_SUCCESS, "unable to open file: " << filename);
+
+   char head[shared_file_header_size];
+   int info[2];
+   MPI_File_read_at_all(fh, 0, head, shared_file_header_size, MPI_CHAR,
+                        &status);
+   MPI_File_read_at_all(fh, shared_file_header_size, info, 2, MPI_INT,
+                        &status);
+   head[shared_file_header_size-1] = '\0';
+   MFEM_VERIFY(strcmp(head, header) == 0, "invalid header in file "
+               << filename << ": '" << head << "', expected: '" << header
+               << "'");
+   MFEM_VERIFY(info[0] == np, "the file " << filename << " was written by "
+               << info[0] << " ranks, the current number of ranks is " << np);
+
+   // only the two offsets of the local block are needed
+   long long range[2];
+   MPI_File_read_at_all(fh, shared_file_index_start + myid*sizeof(long long),
+                        range, 2, MPI_LONG_LONG, &status);
+
+   const MPI_Offset data_start =
+      shared_file_index_start + (np+1)*sizeof(long long);
+   const int size = int(range[1] - range[0]);
+   block.resize(size);
+   err = MPI_File_read_at_all(fh, data_start + range[0],
+                              size ? &block[0] : NULL, size, MPI_BYTE,
+                              &status);
+   MFEM_VERIFY(err == MPI_SUCCESS, "error reading file: " << filename);
+   MPI_File_close(&fh);
+}
+
 }
 
 #endif
@@ -20,6 +20,7 @@
 #include "array.hpp"
 #include "table.hpp"
 #include "sets.hpp"
+#include <string>
 
 namespace mfem
 {
@@ -133,6 +134,19 @@ public:
    ~GroupCommunicator();
 };
 
+
+/** Collectively write one data block per rank into the single shared file
+    'filename' using MPI-IO. The file contains the given header string (at
+    most 63 characters), the number of ranks, the offsets of the blocks (an
+    index of size NRanks+1) and then the blocks in rank order. */
+void WriteSharedFile(MPI_Comm comm, const char *filename, const char *header,
+                     const std::string &block);
+
+/** Collectively read the block of the calling rank from a file written by
+    WriteSharedFile() with the same header and the same number of ranks. */
+void ReadSharedFile(MPI_Comm comm, const char *filename, const char *header,
+                    std::string &block);
+
 }
 
 #endif
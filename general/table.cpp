@@ -16,6 +16,7 @@
 
 #include "array.hpp"
 #include "table.hpp"
+#include "sort_pairs.hpp"
 #include "error.hpp"
 
 namespace mfem
@@ -276,7 +277,7 @@ void Table::Copy(Table & copy) const
    int * j_copy = new int[I[size]];
 
    memcpy(i_copy, I, sizeof(int)*(size+1) );
-   memcpy(j_copy, J, sizeof(int)*size);
+   memcpy(j_copy, J, sizeof(int)*I[size]);
 
    copy.SetIJ(i_copy, j_copy, size);
 }
@@ -422,6 +423,120 @@ Table * Mult (const Table &A, const Table &B)
    return C;
 }
 
+// Breadth-first search from 'root' storing the visited vertices in 'q' in
+// level order; returns the number of levels and the start of the last one.
+static int RCM_BFS(const int *I, const int *J, int root, const int *done,
+                   int stamp, int *mark, int *q, int &nq, int &last)
+{
+   int head = 0, levels = 0;
+   nq = 0;
+   q[nq++] = root;
+   mark[root] = stamp;
+   while (head < nq)
+   {
+      const int end = nq;
+      last = head;
+      levels++;
+      for ( ; head < end; head++)
+      {
+         const int v = q[head];
+         for (int j = I[v]; j < I[v+1]; j++)
+         {
+            const int w = J[j];
+            if (!done[w] && mark[w] != stamp)
+            {
+               mark[w] = stamp;
+               q[nq++] = w;
+            }
+         }
+      }
+   }
+   return levels;
+}
+
+void ReverseCuthillMcKee(const Table &adj, Array<int> &perm)
+{
+   const int n = adj.Size();
+   const int *I = adj.GetI(), *J = adj.GetJ();
+
+   Array<int> deg(n), done(n), mark(n), q(n), order(n);
+   for (int i = 0; i < n; i++)
+   {
+      deg[i] = I[i+1] - I[i];
+   }
+   done = 0;
+   mark = -1;
+
+   // visit the components starting from vertices of increasing degree
+   Array<Pair<int,int> > start(n);
+   for (int i = 0; i < n; i++)
+   {
+      start[i].one = deg[i];
+      start[i].two = i;
+   }
+   SortPairs<int,int>(start, n);
+
+   int cnt = 0, stamp = 0;
+   for (int s = 0; s < n; s++)
+   {
+      int root = start[s].two;
+      if (done[root]) { continue; }
+
+      // find a pseudo-peripheral root of this component
+      int nq, last;
+      int ecc = RCM_BFS(I, J, root, done, stamp++, mark, q, nq, last);
+      for (int it = 0; it < 8; it++)
+      {
+         int cand = q[last];
+         for (int k = last + 1; k < nq; k++)
+         {
+            if (deg[q[k]] < deg[cand]) { cand = q[k]; }
+         }
+         int nq2, last2;
+         int ecc2 = RCM_BFS(I, J, cand, done, stamp++, mark, q, nq2, last2);
+         if (ecc2 <= ecc) { break; }
+         root = cand;
+         ecc = ecc2;
+         last = last2;
+         nq = nq2;
+      }
+
+      // Cuthill-McKee: BFS with neighbors visited by increasing degree
+      int head = cnt;
+      order[cnt++] = root;
+      done[root] = 1;
+      for ( ; head < cnt; head++)
+      {
+         const int v = order[head], first = cnt;
+         for (int j = I[v]; j < I[v+1]; j++)
+         {
+            const int w = J[j];
+            if (!done[w])
+            {
+               done[w] = 1;
+               order[cnt++] = w;
+            }
+         }
+         for (int k = first + 1; k < cnt; k++)
+         {
+            const int w = order[k];
+            int l = k;
+            for ( ; l > first && deg[order[l-1]] > deg[w]; l--)
+            {
+               order[l] = order[l-1];
+            }
+            order[l] = w;
+         }
+      }
+   }
+
+   perm.SetSize(n);
+   for (int k = 0; k < n; k++)
+   {
+      perm[order[n-1-k]] = k;
+   }
+}
+
 STable::STable (int dim, int connections_per_row) :
    Table(dim, connections_per_row)
 {}
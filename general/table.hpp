@@ -136,6 +136,11 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A = -1);
 void Mult (const Table &A, const Table &B, Table &C);
 Table * Mult (const Table &A, const Table &B);
 
+/** Compute the reverse Cuthill-McKee ordering of the symmetric graph with
+    adjacency table 'adj' (diagonal entries are ignored). On return,
+    perm[i] is the new index of vertex i. */
+void ReverseCuthillMcKee(const Table &adj, Array<int> &perm);
+
 
 /** Data type STable. STable is similar to Table, but it's for symmetric
     connectivity, i.e. TYPE I is equivalent to TYPE II. In the first
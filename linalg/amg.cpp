@@ -0,0 +1,511 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the smoothed aggregation AMG preconditioner
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "amg.hpp"
+
+namespace mfem
+{
+
+using namespace std;
+
+// Node and component of unknown i, for n = nn*bs unknowns in blocks of bs
+static inline int NodeOf(int i, int bs, int nn, bool bynodes)
+{ return bynodes ? i % nn : i / bs; }
+
+static inline int CompOf(int i, int bs, int nn, bool bynodes)
+{ return bynodes ? i / nn : i % bs; }
+
+static inline int DofOf(int a, int c, int bs, int nn, bool bynodes)
+{ return bynodes ? c*nn + a : a*bs + c; }
+
+// Inverse diagonal of A, with zeros for the zero diagonal entries
+static void DiagInv(const SparseMatrix &A, Vector &dinv)
+{
+   A.GetDiag(dinv);
+   for (int i = 0; i < dinv.Size(); i++)
+      dinv(i) = (dinv(i) != 0.0) ? 1.0/dinv(i) : 0.0;
+}
+
+void AMGSolver::Init()
+{
+   vdim = 1;
+   bynodes = false;
+   coords = NULL;
+   theta = 0.0;
+   max_coarse = 300;
+   max_levels = 20;
+   smoother = CHEBYSHEV;
+   degree = 2;
+   cycle = V_CYCLE;
+   print_level = 0;
+   Ac_inv = NULL;
+}
+
+void AMGSolver::Clear()
+{
+   for (int l = 1; l < A.Size(); l++)
+      delete A[l];
+   for (int l = 0; l < P.Size(); l++)
+   {
+      delete P[l];
+      delete R[l];
+   }
+   for (int l = 0; l < S.Size(); l++)
+   {
+      delete S[l];
+      delete D[l];
+   }
+   for (int l = 0; l < X.Size(); l++)
+   {
+      delete X[l];
+      delete B[l];
+      delete Res[l];
+   }
+   A.SetSize(0);
+   P.SetSize(0);
+   R.SetSize(0);
+   S.SetSize(0);
+   D.SetSize(0);
+   X.SetSize(0);
+   B.SetSize(0);
+   Res.SetSize(0);
+   delete Ac_inv;
+   Ac_inv = NULL;
+}
+
+void AMGSolver::SetOperator(const Operator &op)
+{
+   const SparseMatrix *a = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(a != NULL && a->Finalized(),
+               "AMGSolver::SetOperator : not a finalized SparseMatrix!");
+   MFEM_VERIFY(a->Height() == a->Width(),
+               "AMGSolver::SetOperator : the matrix is not square!");
+
+   Clear();
+   height = width = a->Height();
+   A.Append(a);
+   Setup();
+}
+
+void AMGSolver::Setup()
+{
+   const int n = A[0]->Height();
+   const int nn = n/vdim;
+   MFEM_VERIFY(nn*vdim == n, "AMGSolver : the size " << n
+               << " is not a multiple of vdim = " << vdim);
+
+   // near null space on the fine level
+   DenseMatrix Bf, Bc;
+   if (coords == NULL)
+   {
+      Bf.SetSize(n, vdim);
+      Bf = 0.0;
+      for (int i = 0; i < n; i++)
+         Bf(i, CompOf(i, vdim, nn, bynodes)) = 1.0;
+   }
+   else
+   {
+      MFEM_VERIFY(vdim == 2 || vdim == 3, "AMGSolver : the rigid body modes "
+                  "require vdim = 2 or 3 (see SetSystemsOptions)");
+      MFEM_VERIFY(coords->Size() == n, "AMGSolver : invalid coordinates");
+      Bf.SetSize(n, (vdim == 2) ? 3 : 6);
+      Bf = 0.0;
+      for (int i = 0; i < n; i++)
+      {
+         const int a = NodeOf(i, vdim, nn, bynodes);
+         const int c = CompOf(i, vdim, nn, bynodes);
+         double x[3];
+         for (int d = 0; d < vdim; d++)
+            x[d] = (*coords)(DofOf(a, d, vdim, nn, bynodes));
+         Bf(i, c) = 1.0;
+         if (vdim == 2)
+         {
+            Bf(i, 2) = (c == 0) ? -x[1] : x[0];
+         }
+         else
+         {
+            // rotations around the x, y and z axes
+            if (c == 0) { Bf(i, 4) =  x[2]; Bf(i, 5) = -x[1]; }
+            if (c == 1) { Bf(i, 3) = -x[2]; Bf(i, 5) =  x[0]; }
+            if (c == 2) { Bf(i, 3) =  x[1]; Bf(i, 4) = -x[0]; }
+         }
+      }
+   }
+
+   int bs = vdim;
+   bool order_bynodes = bynodes;
+   Vector dinv;
+   for (int l = 0; true; l++)
+   {
+      const SparseMatrix &Al = *A[l];
+      DiagInv(Al, dinv);
+      double lambda;
+      if (smoother == L1_JACOBI)
+      {
+         Vector *l1 = new Vector(Al.Height());
+         for (int i = 0; i < Al.Height(); i++)
+         {
+            const double s = Al.GetRowNorml1(i);
+            (*l1)(i) = (s != 0.0) ? 1.0/s : 0.0;
+         }
+         D.Append(l1);
+         S.Append(NULL);
+         lambda = EstimateMaxEigenvalue(Al, dinv);
+      }
+      else
+      {
+         ChebyshevSmoother *cheb =
+            new ChebyshevSmoother(Al, degree, 1.0/30.0);
+         cheb->iterative_mode = true;
+         D.Append(NULL);
+         S.Append(cheb);
+         lambda = cheb->GetMaxEigenvalue();
+      }
+
+      if (Al.Height() <= max_coarse || l+1 >= max_levels ||
+          !Coarsen(bs, order_bynodes, Bf, dinv, lambda, Bc))
+         break;
+
+      // the coarse unknowns are ordered by aggregate
+      Bf = Bc;
+      bs = Bf.Width();
+      order_bynodes = false;
+   }
+
+   const int L = A.Size();
+   for (int l = 0; l < L; l++)
+   {
+      const int s = A[l]->Height();
+      X.Append(new Vector(s));
+      B.Append(new Vector(s));
+      Res.Append(new Vector(s));
+   }
+
+   // direct solver on the coarsest level, unless the coarsening stagnated
+   const SparseMatrix &Al = *A[L-1];
+   if (Al.Height() <= max_coarse)
+   {
+      const int s = Al.Height();
+      const int *I = Al.GetI(), *J = Al.GetJ();
+      const double *data = Al.GetData();
+      Ac.SetSize(s);
+      Ac = 0.0;
+      for (int i = 0; i < s; i++)
+         for (int k = I[i]; k < I[i+1]; k++)
+            Ac(i, J[k]) += data[k];
+      // unknowns decoupled by the aggregation (dropped modes)
+      for (int i = 0; i < s; i++)
+         if (Ac(i, i) == 0.0)
+            Ac(i, i) = 1.0;
+      Ac_inv = new DenseMatrixInverse(Ac);
+   }
+
+   if (print_level > 0)
+   {
+      int nnz0 = A[0]->NumNonZeroElems(), nnz = 0;
+      cout << "AMG hierarchy:\n"
+           << " level        rows         nnz\n";
+      for (int l = 0; l < L; l++)
+      {
+         nnz += A[l]->NumNonZeroElems();
+         cout << setw(6) << l << setw(12) << A[l]->Height()
+              << setw(12) << A[l]->NumNonZeroElems() << '\n';
+      }
+      cout << "operator complexity: " << double(nnz)/nnz0 << endl;
+   }
+}
+
+bool AMGSolver::Coarsen(int bs, bool order_bynodes, const DenseMatrix &Bf,
+                        const Vector &dinv, double lambda, DenseMatrix &Bc)
+{
+   const SparseMatrix &Af = *A.Last();
+   const int n = Af.Height(), nn = n/bs, nb = Bf.Width();
+   const int *I = Af.GetI(), *J = Af.GetJ();
+   const double *data = Af.GetData();
+
+   // squared Frobenius norms of the diagonal blocks
+   Vector nd(nn);
+   nd = 0.0;
+   for (int i = 0; i < n; i++)
+   {
+      const int a = NodeOf(i, bs, nn, order_bynodes);
+      for (int k = I[i]; k < I[i+1]; k++)
+         if (NodeOf(J[k], bs, nn, order_bynodes) == a)
+            nd(a) += data[k]*data[k];
+   }
+
+   // strong connections between the nodes: ||A_ab|| >= theta
+   // sqrt(||A_aa|| ||A_bb||), with the strength stored in SV. The nodes
+   // without any off-diagonal entries (e.g. eliminated essential boundary
+   // conditions) are left out of the coarse space.
+   Array<int> SI(nn+1), SJ, marker(nn), nbrs, agg(nn);
+   Array<double> SV;
+   Vector val(nn);
+   marker = -1;
+   SI[0] = 0;
+   for (int a = 0; a < nn; a++)
+   {
+      nbrs.SetSize(0);
+      agg[a] = -2;
+      for (int c = 0; c < bs; c++)
+      {
+         const int i = DofOf(a, c, bs, nn, order_bynodes);
+         for (int k = I[i]; k < I[i+1]; k++)
+         {
+            const int b = NodeOf(J[k], bs, nn, order_bynodes);
+            if (b == a)
+               continue;
+            if (marker[b] != a)
+            {
+               marker[b] = a;
+               val(b) = 0.0;
+               nbrs.Append(b);
+            }
+            val(b) += data[k]*data[k];
+         }
+      }
+      for (int k = 0; k < nbrs.Size(); k++)
+      {
+         const int b = nbrs[k];
+         const double s = sqrt(nd(a)*nd(b));
+         if (val(b) > 0.0)
+            agg[a] = -1;
+         if (val(b) > 0.0 && val(b) >= theta*theta*s)
+         {
+            SJ.Append(b);
+            SV.Append(val(b)/s);
+         }
+      }
+      SI[a+1] = SJ.Size();
+   }
+
+   // aggregation: -1 = not aggregated, -2 = isolated node
+   int na = 0;
+   // 1. aggregates of nodes with all their strong neighbors free
+   for (int a = 0; a < nn; a++)
+   {
+      if (agg[a] != -1)
+         continue;
+      bool all_free = true;
+      for (int k = SI[a]; k < SI[a+1]; k++)
+         if (agg[SJ[k]] != -1)
+         {
+            all_free = false;
+            break;
+         }
+      if (!all_free)
+         continue;
+      agg[a] = na;
+      for (int k = SI[a]; k < SI[a+1]; k++)
+         agg[SJ[k]] = na;
+      na++;
+   }
+   // 2. attach the remaining nodes to their most strongly connected
+   // neighboring aggregate from step 1
+   Array<int> agg1(nn);
+   agg.Copy(agg1);
+   for (int a = 0; a < nn; a++)
+   {
+      if (agg1[a] != -1)
+         continue;
+      double best = 0.0;
+      for (int k = SI[a]; k < SI[a+1]; k++)
+         if (agg1[SJ[k]] >= 0 && SV[k] > best)
+         {
+            best = SV[k];
+            agg[a] = agg1[SJ[k]];
+         }
+   }
+   // 3. aggregate the rest with their free strong neighbors
+   for (int a = 0; a < nn; a++)
+   {
+      if (agg[a] != -1)
+         continue;
+      agg[a] = na;
+      for (int k = SI[a]; k < SI[a+1]; k++)
+         if (agg[SJ[k]] == -1)
+            agg[SJ[k]] = na;
+      na++;
+   }
+
+   const int nc = na*nb;
+   if (na == 0 || nc > 0.5*n)
+      return false;
+
+   // nodes of each aggregate
+   Array<int> aI(na+1), aJ(nn);
+   aI = 0;
+   for (int a = 0; a < nn; a++)
+      if (agg[a] >= 0)
+         aI[agg[a]+1]++;
+   for (int g = 0; g < na; g++)
+      aI[g+1] += aI[g];
+   for (int a = 0; a < nn; a++)
+      if (agg[a] >= 0)
+         aJ[aI[agg[a]]++] = a;
+   for (int g = na; g > 0; g--)
+      aI[g] = aI[g-1];
+   aI[0] = 0;
+
+   // tentative prolongator: orthonormalize the near null space on each
+   // aggregate (Q R = Bf restricted to the aggregate); R gives the coarse
+   // near null space
+   int *pI = new int[n+1];
+   pI[0] = 0;
+   for (int i = 0; i < n; i++)
+      pI[i+1] = pI[i] + ((agg[NodeOf(i, bs, nn, order_bynodes)] >= 0) ? nb : 0);
+   int *pJ = new int[pI[n]];
+   double *pA = new double[pI[n]];
+
+   Bc.SetSize(nc, nb);
+   Bc = 0.0;
+   DenseMatrix Q;
+   Array<int> rows;
+   for (int g = 0; g < na; g++)
+   {
+      rows.SetSize(0);
+      for (int k = aI[g]; k < aI[g+1]; k++)
+         for (int c = 0; c < bs; c++)
+            rows.Append(DofOf(aJ[k], c, bs, nn, order_bynodes));
+      const int m = rows.Size();
+      Q.SetSize(m, nb);
+      for (int k = 0; k < nb; k++)
+         for (int r = 0; r < m; r++)
+            Q(r, k) = Bf(rows[r], k);
+
+      // modified Gram-Schmidt with reorthogonalization; the columns that are
+      // numerically dependent are set to zero
+      for (int k = 0; k < nb; k++)
+      {
+         double *qk = Q.Data() + k*m, nrm0 = 0.0;
+         for (int r = 0; r < m; r++)
+            nrm0 += qk[r]*qk[r];
+         for (int pass = 0; pass < 2; pass++)
+            for (int j = 0; j < k; j++)
+            {
+               const double *qj = Q.Data() + j*m;
+               double h = 0.0;
+               for (int r = 0; r < m; r++)
+                  h += qj[r]*qk[r];
+               for (int r = 0; r < m; r++)
+                  qk[r] -= h*qj[r];
+               Bc(g*nb+j, k) += h;
+            }
+         double nrm = 0.0;
+         for (int r = 0; r < m; r++)
+            nrm += qk[r]*qk[r];
+         if (nrm <= 1e-20*nrm0 || nrm == 0.0)
+         {
+            for (int r = 0; r < m; r++)
+               qk[r] = 0.0;
+            continue;
+         }
+         nrm = sqrt(nrm);
+         for (int r = 0; r < m; r++)
+            qk[r] /= nrm;
+         Bc(g*nb+k, k) = nrm;
+      }
+
+      for (int r = 0; r < m; r++)
+         for (int k = 0; k < nb; k++)
+         {
+            pJ[pI[rows[r]]+k] = g*nb+k;
+            pA[pI[rows[r]]+k] = Q(r, k);
+         }
+   }
+   SparseMatrix *Pt = new SparseMatrix(pI, pJ, pA, n, nc);
+
+   // smoothed prolongator P = (I - 4/(3 lambda) D^{-1} A) Pt
+   SparseMatrix *APt = mfem::Mult(Af, *Pt);
+   Vector s(dinv);
+   s *= 4.0/(3.0*lambda);
+   APt->ScaleRows(s);
+   SparseMatrix *Pl = Add(1.0, *Pt, -1.0, *APt);
+   delete APt;
+   delete Pt;
+
+   SparseMatrix *Rl = Transpose(*Pl);
+   SparseMatrix *AP = mfem::Mult(Af, *Pl);
+   SparseMatrix *Acl = mfem::Mult(*Rl, *AP);
+   delete AP;
+
+   P.Append(Pl);
+   R.Append(Rl);
+   A.Append(Acl);
+   return true;
+}
+
+void AMGSolver::Smooth(int l, const Vector &b, Vector &x) const
+{
+   if (S[l])
+   {
+      S[l]->Mult(b, x);
+      return;
+   }
+
+   // l1-Jacobi
+   const SparseMatrix &Al = *A[l];
+   const double *dl = D[l]->GetData(), *bp = b.GetData();
+   const int n = Al.Height();
+   double *xp = x.GetData(), *rp = Res[l]->GetData();
+
+   for (int it = 0; it < degree; it++)
+   {
+      Al.Mult(x, *Res[l]);
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+      for (int i = 0; i < n; i++)
+         xp[i] += dl[i]*(bp[i] - rp[i]);
+   }
+}
+
+void AMGSolver::Cycle(int l, const Vector &b, Vector &x) const
+{
+   if (l == A.Size()-1)
+   {
+      if (Ac_inv)
+         Ac_inv->Mult(b, x);
+      else
+         Smooth(l, b, x);
+      return;
+   }
+
+   Smooth(l, b, x);
+
+   Vector &r = *Res[l];
+   A[l]->Mult(x, r);
+   subtract(b, r, r);
+   R[l]->Mult(r, *B[l+1]);
+   *X[l+1] = 0.0;
+   const int gamma = (l+2 < A.Size()) ? cycle : 1;
+   for (int g = 0; g < gamma; g++)
+      Cycle(l+1, *B[l+1], *X[l+1]);
+   P[l]->AddMult(*X[l+1], x);
+
+   Smooth(l, b, x);
+}
+
+void AMGSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(A.Size() > 0, "AMGSolver::Mult : the operator is not set!");
+
+   if (!iterative_mode)
+      x = 0.0;
+   Cycle(0, b, x);
+}
+
+}
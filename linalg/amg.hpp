@@ -0,0 +1,119 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+#include "../config/config.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+#include "sparsesmoothers.hpp"
+
+namespace mfem
+{
+
+/** Smoothed aggregation algebraic multigrid preconditioner for a symmetric
+    positive definite SparseMatrix. The fine-level unknowns are grouped into
+    aggregates of strongly connected nodes, the near null space (constants,
+    or rigid body modes for elasticity) is restricted to each aggregate to
+    form a tentative prolongator, which is then smoothed with one damped
+    Jacobi step. Each application of the solver is one V- or W-cycle with
+    Chebyshev or l1-Jacobi smoothing, so it is symmetric and can be used as a
+    preconditioner in CGSolver.
+
+    The options must be set before the operator (see SetOperator()). */
+class AMGSolver : public Solver
+{
+public:
+   enum SmootherType { CHEBYSHEV, L1_JACOBI };
+   enum CycleType { V_CYCLE = 1, W_CYCLE = 2 };
+
+protected:
+   // options
+   int vdim;              // number of unknowns per node on the fine level
+   bool bynodes;          // ordering of the fine-level unknowns
+   const Vector *coords;  // nodal coordinates for the rigid body modes
+   double theta;
+   int max_coarse, max_levels, smoother, degree, cycle, print_level;
+
+   // the hierarchy; A[0] is the given matrix
+   Array<const SparseMatrix *> A;
+   Array<SparseMatrix *> P, R;
+   Array<Solver *> S;           // Chebyshev smoothers
+   Array<Vector *> D;           // inverse l1 row norms for l1-Jacobi
+   DenseMatrix Ac;
+   DenseMatrixInverse *Ac_inv;  // direct solver on the coarsest level
+
+   mutable Array<Vector *> X, B, Res;
+
+   void Init();
+   void Clear();
+   void Setup();
+
+   /** Add the next level to the hierarchy using the near null space Bf
+       (columns) of the current coarsest level, whose unknowns are grouped in
+       blocks of size bs. The prolongator is smoothed with the inverse
+       diagonal dinv and the eigenvalue estimate lambda of the level. Returns
+       false if the coarsening stagnates. */
+   bool Coarsen(int bs, bool order_bynodes, const DenseMatrix &Bf,
+                const Vector &dinv, double lambda, DenseMatrix &Bc);
+
+   void Smooth(int l, const Vector &b, Vector &x) const;
+   void Cycle(int l, const Vector &b, Vector &x) const;
+
+public:
+   AMGSolver() { Init(); }
+
+   /// Construct and set up the hierarchy with the default options
+   AMGSolver(const SparseMatrix &a) { Init(); SetOperator(a); }
+
+   /** The matrix has vector unknowns with 'dim' components, ordered either
+       by nodes (all the first components first) or by vdim, following the
+       Ordering of the FiniteElementSpace. */
+   void SetSystemsOptions(int dim, bool order_bynodes = false)
+   { vdim = dim; bynodes = order_bynodes; }
+
+   /** Use the rigid body modes as near null space (for linear elasticity).
+       The vector 'dof_coords' gives for each unknown the corresponding
+       coordinate of its node, e.g. a GridFunction obtained by projecting the
+       coordinate function onto the vector (nodal) FiniteElementSpace. The
+       systems options must be set to the space dimension. The vector is
+       only accessed in SetOperator(). */
+   void SetElasticityOptions(const Vector &dof_coords)
+   { coords = &dof_coords; }
+
+   /** Threshold for the strength of connection (default 0, i.e. all the
+       nonzero couplings are strong); larger values give smaller aggregates. */
+   void SetStrengthThreshold(double th) { theta = th; }
+   /// Coarsen until the size is at most this value (default 300)
+   void SetMaxCoarseSize(int size) { max_coarse = size; }
+   void SetMaxLevels(int levels) { max_levels = levels; }
+   void SetCycleType(int type) { cycle = type; }
+   /** Set the smoother: the degree is the polynomial degree of the Chebyshev
+       smoother or the number of l1-Jacobi sweeps (default: CHEBYSHEV, 2). */
+   void SetSmoother(int type, int deg = 2) { smoother = type; degree = deg; }
+   void SetPrintLevel(int print_lvl) { print_level = print_lvl; }
+
+   int GetNumLevels() const { return A.Size(); }
+
+   /// Build the hierarchy for the given SparseMatrix
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply one multigrid cycle to A x = b
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~AMGSolver() { Clear(); }
+};
+
+}
+
+#endif
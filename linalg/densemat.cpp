@@ -1992,6 +1992,17 @@ void DenseMatrix::GetColumn(int c, Vector &col)
       vp[i] = cp[i];
 }
 
+void DenseMatrix::GetRow(int r, Vector &row) const
+{
+   const int m = Height(), n = Width();
+   row.SetSize(n);
+   const double *rp = data + r;
+   double *vp = row.GetData();
+
+   for (int j = 0; j < n; j++)
+      vp[j] = rp[j*m];
+}
+
 void DenseMatrix::GetDiag(Vector &d)
 {
    if (height != width)
@@ -183,6 +183,8 @@ public:
 
    void GetColumn(int c, Vector &col);
 
+   void GetRow(int r, Vector &row) const;
+
    void GetColumnReference(int c, Vector &col)
    { col.SetDataAndSize(data + c * height, height); }
 
@@ -445,6 +447,8 @@ public:
 
    void SetSize(int i, int j, int k)
    {
+      if (SizeI() == i && SizeJ() == j && nk == k)
+         return;
       delete [] tdata;
       Mk.UseExternalData(NULL, i, j);
       nk = k;
@@ -459,8 +463,11 @@ public:
    { return tdata[i+SizeI()*(j+SizeJ()*k)]; }
 
    double *GetData(int k) { return tdata+k*Mk.Height()*Mk.Width(); }
+   const double *GetData(int k) const
+   { return tdata+k*Mk.Height()*Mk.Width(); }
 
    double *Data() { return tdata; }
+   const double *Data() const { return tdata; }
 
    /** Matrix-vector product from unassembled element matrices, assuming both
        'x' and 'y' use the same elem_dof table. */
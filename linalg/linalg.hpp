@@ -18,10 +18,13 @@
 #include "operator.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
+#include "sellmat.hpp"
 #include "blockvector.hpp"
 #include "blockmatrix.hpp"
 #include "blockoperator.hpp"
 #include "sparsesmoothers.hpp"
+#include "amg.hpp"
+#include "sparseldl.hpp"
 #include "densemat.hpp"
 #include "ode.hpp"
 
@@ -40,4 +40,44 @@ void Operator::PrintMatlab (std::ostream & out, int n, int m)
    }
 }
 
+ConstrainedOperator::ConstrainedOperator(Operator *A_, const Array<int> &list,
+                                         bool own_A_)
+   : Operator(A_->Height(), A_->Width()), A(A_), own_A(own_A_),
+     z(height), w(height)
+{
+   MFEM_VERIFY(height == width, "the Operator must be square");
+   list.Copy(constraint_list);
+}
+
+void ConstrainedOperator::EliminateRHS(const Vector &x, Vector &b) const
+{
+   w = 0.0;
+   for (int i = 0; i < constraint_list.Size(); i++)
+      w(constraint_list[i]) = x(constraint_list[i]);
+
+   A->Mult(w, z);
+
+   b -= z;
+   for (int i = 0; i < constraint_list.Size(); i++)
+      b(constraint_list[i]) = x(constraint_list[i]);
+}
+
+void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
+{
+   if (constraint_list.Size() == 0)
+   {
+      A->Mult(x, y);
+      return;
+   }
+
+   z = x;
+   for (int i = 0; i < constraint_list.Size(); i++)
+      z(constraint_list[i]) = 0.0;
+
+   A->Mult(z, y);
+
+   for (int i = 0; i < constraint_list.Size(); i++)
+      y(constraint_list[i]) = x(constraint_list[i]);
+}
+
 }
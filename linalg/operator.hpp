@@ -186,6 +186,35 @@ public:
    ~RAPOperator() { }
 };
 
+
+/** Square Operator for imposing essential boundary conditions using only the
+    action, Mult(), of a given unconstrained Operator. The constrained dofs are
+    eliminated symmetrically: the rows and columns of A corresponding to
+    'constraint_list' are replaced with the rows and columns of the identity. */
+class ConstrainedOperator : public Operator
+{
+protected:
+   Operator *A;
+   Array<int> constraint_list;
+   bool own_A;
+   mutable Vector z, w;
+
+public:
+   /** Constrain the dofs listed in 'list' (non-directional, i.e. >= 0). If
+       'own_A' is true, the operator A will be destroyed with this object. */
+   ConstrainedOperator(Operator *A, const Array<int> &list, bool own_A = false);
+
+   /** Given the prescribed values 'x' at the constrained dofs, modify the
+       r.h.s. 'b' of the linear system accordingly: b -= A x_c and b_c = x_c,
+       where x_c is 'x' restricted to the constrained dofs. */
+   void EliminateRHS(const Vector &x, Vector &b) const;
+
+   /// Constrained operator application
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual ~ConstrainedOperator() { if (own_A) delete A; }
+};
+
 }
 
 #endif
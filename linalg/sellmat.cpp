@@ -0,0 +1,249 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class SELLMatrix
+
+#include "linalg.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+// orders row indices by decreasing row length
+class SELLRowLengthCmp
+{
+   const int *I;
+public:
+   SELLRowLengthCmp(const int *I_) : I(I_) { }
+   bool operator()(int a, int b) const
+   { return (I[a+1] - I[a]) > (I[b+1] - I[b]); }
+};
+
+SELLMatrix::SELLMatrix(const SparseMatrix &A, int C_, int sigma_)
+   : Operator(A.Height(), A.Width()), C(C_), sigma(sigma_)
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   MFEM_VERIFY(C > 0 && sigma >= C && sigma % C == 0,
+               "invalid SELL parameters: C = " << C << ", sigma = " << sigma);
+
+   const int n = height;
+   nnz = A.NumNonZeroElems();
+   const int *I = A.GetI(), *J = A.GetJ();
+   const double *V = A.GetData();
+
+   // sort the rows by decreasing length inside each sigma window; the sort
+   // is stable to preserve the locality of the original row ordering
+   perm.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      perm[i] = i;
+   }
+   for (int s = 0; s < n; s += sigma)
+   {
+      const int e = std::min(n, s + sigma);
+      std::stable_sort(perm.GetData() + s, perm.GetData() + e,
+                       SELLRowLengthCmp(I));
+   }
+
+   nchunks = (n + C - 1)/C;
+   chunk_start.SetSize(nchunks + 1);
+   chunk_len.SetSize(nchunks);
+   chunk_start[0] = 0;
+   for (int c = 0; c < nchunks; c++)
+   {
+      // the first row of each chunk is the longest one
+      const int row = perm[c*C];
+      chunk_len[c] = I[row+1] - I[row];
+      chunk_start[c+1] = chunk_start[c] + C*chunk_len[c];
+   }
+
+   // padding entries use column 0 (always a valid index) with value 0
+   const int size = chunk_start[nchunks];
+   col.SetSize(size);
+   col = 0;
+   val.SetSize(size);
+   val = 0.0;
+   for (int i = 0; i < n; i++)
+   {
+      const int row = perm[i], c = i/C, r = i%C;
+      int *cc = col.GetData() + chunk_start[c] + r;
+      double *vv = val.GetData() + chunk_start[c] + r;
+      for (int j = I[row], k = 0; j < I[row+1]; j++, k += C)
+      {
+         cc[k] = J[j];
+         vv[k] = V[j];
+      }
+   }
+}
+
+void SELLMatrix::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height,
+               "incompatible dimensions");
+
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   const int *cs = chunk_start.GetData(), *cl = chunk_len.GetData();
+   const int *cp = col.GetData(), *pp = perm.GetData();
+   const double *vp = val.GetData();
+   const int n = height, C = this->C;
+
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel
+#endif
+   {
+      Array<double> t(C);
+      double *tp = t.GetData();
+#ifdef MFEM_USE_OPENMP
+#pragma omp for
+#endif
+      for (int c = 0; c < nchunks; c++)
+      {
+         for (int r = 0; r < C; r++)
+         {
+            tp[r] = 0.0;
+         }
+         const int *cc = cp + cs[c];
+         const double *vv = vp + cs[c];
+         for (int k = 0; k < cl[c]; k++, cc += C, vv += C)
+         {
+            for (int r = 0; r < C; r++)
+            {
+               tp[r] += vv[r] * xp[cc[r]];
+            }
+         }
+         const int nr = std::min(C, n - c*C);
+         for (int r = 0; r < nr; r++)
+         {
+            yp[pp[c*C + r]] = tp[r];
+         }
+      }
+   }
+}
+
+void SELLMatrix::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   Vector z(height);
+   Mult(x, z);
+   y.Add(a, z);
+}
+
+void SELLMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == width,
+               "incompatible dimensions");
+
+   y = 0.0;
+   for (int c = 0; c < nchunks; c++)
+   {
+      const int nr = std::min(C, height - c*C);
+      for (int r = 0; r < nr; r++)
+      {
+         const double xr = x(perm[c*C + r]);
+         const int *cc = col.GetData() + chunk_start[c] + r;
+         const double *vv = val.GetData() + chunk_start[c] + r;
+         for (int k = 0; k < chunk_len[c]; k++)
+         {
+            y(cc[k*C]) += vv[k*C] * xr;
+         }
+      }
+   }
+}
+
+void SELLMatrix::Mult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   MFEM_ASSERT(X.Height() == width, "incompatible dimensions");
+
+   const int nv = X.Width();
+   Y.SetSize(height, nv);
+   if (nv == 1)
+   {
+      Vector x(X.Data(), width), y(Y.Data(), height);
+      Mult(x, y);
+      return;
+   }
+
+   const double *xp = X.Data();
+   double *yp = Y.Data();
+   const int *cs = chunk_start.GetData(), *cl = chunk_len.GetData();
+   const int *cp = col.GetData(), *pp = perm.GetData();
+   const double *vp = val.GetData();
+   const int n = height, w = width, C = this->C;
+
+   // process the columns of X in groups of up to 4, so that each stored entry
+   // (and column index) of a chunk is loaded once per group
+   for (int v0 = 0; v0 < nv; v0 += 4)
+   {
+      const int nb = std::min(4, nv - v0);
+      const double *x0 = xp + v0*w;
+      double *y0 = yp + v0*n;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel
+#endif
+      {
+         Array<double> t(4*C);
+         double *tp = t.GetData();
+#ifdef MFEM_USE_OPENMP
+#pragma omp for
+#endif
+         for (int c = 0; c < nchunks; c++)
+         {
+            for (int r = 0; r < 4*C; r++)
+            {
+               tp[r] = 0.0;
+            }
+            const int *cc = cp + cs[c];
+            const double *vv = vp + cs[c];
+            if (nb == 4)
+            {
+               for (int k = 0; k < cl[c]; k++, cc += C, vv += C)
+               {
+                  for (int r = 0; r < C; r++)
+                  {
+                     const double a = vv[r];
+                     const double *xj = x0 + cc[r];
+                     tp[r]     += a * xj[0];
+                     tp[r+C]   += a * xj[w];
+                     tp[r+2*C] += a * xj[2*w];
+                     tp[r+3*C] += a * xj[3*w];
+                  }
+               }
+            }
+            else
+            {
+               for (int k = 0; k < cl[c]; k++, cc += C, vv += C)
+               {
+                  for (int r = 0; r < C; r++)
+                  {
+                     const double a = vv[r];
+                     const double *xj = x0 + cc[r];
+                     for (int b = 0; b < nb; b++)
+                     {
+                        tp[r+b*C] += a * xj[b*w];
+                     }
+                  }
+               }
+            }
+            const int nr = std::min(C, n - c*C);
+            for (int b = 0; b < nb; b++)
+            {
+               for (int r = 0; r < nr; r++)
+               {
+                  y0[pp[c*C + r] + b*n] = tp[r+b*C];
+               }
+            }
+         }
+      }
+   }
+}
+
+}
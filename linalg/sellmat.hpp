@@ -0,0 +1,77 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SELLMAT
+#define MFEM_SELLMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in the SELL-C-sigma (sliced ELLPACK) format.
+
+    The rows are sorted by length within windows of sigma rows and then
+    grouped into chunks of C consecutive rows. Each chunk is stored in
+    column-major order, padded to the length of its longest row, so that the
+    inner loop of Mult runs over C independent rows and can be vectorized.
+
+    The matrix is a separate, read-only Operator built as a copy of a
+    finalized SparseMatrix (it is not a storage option of SparseMatrix itself,
+    so it cannot be assembled into or modified). It can be passed to the
+    iterative solvers in place of the original matrix. */
+class SELLMatrix : public Operator
+{
+protected:
+   int C, sigma, nchunks, nnz;
+   /// Offset of each chunk in col/val, size nchunks+1.
+   Array<int> chunk_start;
+   /// Length (number of padded entries per row) of each chunk.
+   Array<int> chunk_len;
+   /// Original index of row i in the sorted row order.
+   Array<int> perm;
+   Array<int> col;
+   Vector val;
+
+public:
+   /** Create a SELL-C-sigma copy of the finalized matrix A. C is the chunk
+       height and should be a multiple of the SIMD width; sigma is the sorting
+       window and should be a multiple of C. */
+   SELLMatrix(const SparseMatrix &A, int C_ = 8, int sigma_ = 256);
+
+   /// Ratio of the stored (padded) entries to the nonzeros of the matrix.
+   double GetFillRatio() const
+   { return (nnz > 0) ? double(val.Size())/nnz : 1.0; }
+
+   int GetChunkHeight() const { return C; }
+
+   /// y = A * x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a * A * x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t * x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** Y = A * X, for all columns of X. The columns are processed in groups
+       of up to 4, so that each stored entry is loaded once per group. */
+   void Mult(const DenseMatrix &X, DenseMatrix &Y) const;
+
+   virtual ~SELLMatrix() { }
+};
+
+}
+
+#endif
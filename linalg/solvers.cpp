@@ -30,6 +30,7 @@ IterativeSolver::IterativeSolver()
    rel_tol = abs_tol = 0.0;
 #ifdef MFEM_USE_MPI
    dot_prod_type = 0;
+   dots_request = MPI_REQUEST_NULL;
 #endif
 }
 
@@ -44,21 +45,26 @@ IterativeSolver::IterativeSolver(MPI_Comm _comm)
    rel_tol = abs_tol = 0.0;
    dot_prod_type = 1;
    comm = _comm;
+   dots_request = MPI_REQUEST_NULL;
 }
 #endif
 
 double IterativeSolver::Dot(const Vector &x, const Vector &y) const
+{
+   return GlobalSum(x * y);
+}
+
+double IterativeSolver::GlobalSum(double local_dot) const
 {
 #ifndef MFEM_USE_MPI
-   return (x * y);
+   return local_dot;
 #else
    if (dot_prod_type == 0)
    {
-      return (x * y);
+      return local_dot;
    }
    else
    {
-      double local_dot = (x * y);
       double global_dot;
 
       MPI_Allreduce(&local_dot, &global_dot, 1, MPI_DOUBLE, MPI_SUM, comm);
@@ -68,6 +74,307 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::StartDots(const Vector &x1, const Vector &y1,
+                                const Vector &x2, const Vector &y2,
+                                double *dots) const
+{
+   // compute both local inner products in one pass over the data
+   const int n = x1.Size();
+   const double *a1 = x1.GetData(), *b1 = y1.GetData();
+   const double *a2 = x2.GetData(), *b2 = y2.GetData();
+   double d1 = 0.0, d2 = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:d1,d2)
+#endif
+   for (int i = 0; i < n; i++)
+   {
+      d1 += a1[i]*b1[i];
+      d2 += a2[i]*b2[i];
+   }
+
+#ifndef MFEM_USE_MPI
+   dots[0] = d1;
+   dots[1] = d2;
+#else
+   if (dot_prod_type == 0)
+   {
+      dots[0] = d1;
+      dots[1] = d2;
+   }
+   else
+   {
+      dots_local[0] = d1;
+      dots_local[1] = d2;
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(dots_local, dots, 2, MPI_DOUBLE, MPI_SUM, comm,
+                     &dots_request);
+#else
+      MPI_Allreduce(dots_local, dots, 2, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#endif
+}
+
+void IterativeSolver::FinishDots() const
+{
+#ifdef MFEM_USE_MPI
+   if (dots_request != MPI_REQUEST_NULL)
+      MPI_Wait(&dots_request, MPI_STATUS_IGNORE);
+#endif
+}
+
+void IterativeSolver::BlockDot(const DenseMatrix &X, const DenseMatrix &Y,
+                               DenseMatrix &XtY) const
+{
+   XtY.SetSize(X.Width(), Y.Width());
+   if (X.Width() == 0 || Y.Width() == 0)
+      return;
+   MultAtB(X, Y, XtY);
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+      MPI_Allreduce(MPI_IN_PLACE, XtY.Data(), XtY.Height()*XtY.Width(),
+                    MPI_DOUBLE, MPI_SUM, comm);
+#endif
+}
+
+void IterativeSolver::ColumnDots(const DenseMatrix &X, const DenseMatrix &Y,
+                                 Vector &dots) const
+{
+   const int n = X.Height();
+   dots.SetSize(X.Width());
+   for (int j = 0; j < X.Width(); j++)
+   {
+      const double *xj = X.Data() + j*n, *yj = Y.Data() + j*n;
+      double d = 0.0;
+      for (int i = 0; i < n; i++)
+         d += xj[i]*yj[i];
+      dots(j) = d;
+   }
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0 && dots.Size() > 0)
+      MPI_Allreduce(MPI_IN_PLACE, dots.GetData(), dots.Size(), MPI_DOUBLE,
+                    MPI_SUM, comm);
+#endif
+}
+
+/* dots[j] = (V(:,j), w) for j < k, processing four columns of V at a time to
+   reduce the number of passes over w. */
+static void MultVtw(const DenseMatrix &V, int k, const Vector &w,
+                    double *dots)
+{
+   const int n = V.Height();
+   const double *wp = w.GetData();
+   int j = 0;
+   for ( ; j+3 < k; j += 4)
+   {
+      const double *v0 = V.Data() + j*n, *v1 = v0 + n;
+      const double *v2 = v1 + n, *v3 = v2 + n;
+      double d0 = 0.0, d1 = 0.0, d2 = 0.0, d3 = 0.0;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for reduction(+:d0,d1,d2,d3)
+#endif
+      for (int i = 0; i < n; i++)
+      {
+         d0 += v0[i]*wp[i];
+         d1 += v1[i]*wp[i];
+         d2 += v2[i]*wp[i];
+         d3 += v3[i]*wp[i];
+      }
+      dots[j] = d0; dots[j+1] = d1; dots[j+2] = d2; dots[j+3] = d3;
+   }
+   for ( ; j < k; j++)
+   {
+      const double *vj = V.Data() + j*n;
+      double d = 0.0;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for reduction(+:d)
+#endif
+      for (int i = 0; i < n; i++)
+         d += vj[i]*wp[i];
+      dots[j] = d;
+   }
+}
+
+// x += a V(:,0:k-1) y, processing four columns of V at a time
+static void AddMultVy(const DenseMatrix &V, int k, const double *y, double a,
+                      Vector &x)
+{
+   const int n = V.Height();
+   double *xp = x.GetData();
+   int j = 0;
+   for ( ; j+3 < k; j += 4)
+   {
+      const double *v0 = V.Data() + j*n, *v1 = v0 + n;
+      const double *v2 = v1 + n, *v3 = v2 + n;
+      const double y0 = a*y[j], y1 = a*y[j+1], y2 = a*y[j+2], y3 = a*y[j+3];
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+      for (int i = 0; i < n; i++)
+         xp[i] += y0*v0[i] + y1*v1[i] + y2*v2[i] + y3*v3[i];
+   }
+   for ( ; j < k; j++)
+   {
+      const double *vj = V.Data() + j*n;
+      const double yj = a*y[j];
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+      for (int i = 0; i < n; i++)
+         xp[i] += yj*vj[i];
+   }
+}
+
+void IterativeSolver::OrthogonalizeCGS2(const DenseMatrix &V, int k,
+                                        Vector &w, double *h) const
+{
+   // first pass: h = V^t w, w -= V h
+   MultVtw(V, k, w, h);
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0 && k > 0)
+      MPI_Allreduce(MPI_IN_PLACE, h, k, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   AddMultVy(V, k, h, -1.0, w);
+
+   // second pass, with (w,w) computed in the same reduction
+   Vector h2(k+1);
+   MultVtw(V, k, w, h2.GetData());
+   h2(k) = w * w;
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+      MPI_Allreduce(MPI_IN_PLACE, h2.GetData(), k+1, MPI_DOUBLE, MPI_SUM,
+                    comm);
+#endif
+   AddMultVy(V, k, h2.GetData(), -1.0, w);
+
+   // ||w - V h2||^2 = ||w||^2 - ||h2||^2 since the columns of V are
+   // orthonormal; recompute the norm if there is severe cancellation
+   double nrm2 = h2(k);
+   for (int j = 0; j < k; j++)
+   {
+      h[j] += h2(j);
+      nrm2 -= h2(j)*h2(j);
+   }
+   h[k] = (nrm2 > 1e-8*h2(k)) ? sqrt(nrm2) : Norm(w);
+}
+
+/* Cholesky factorization with symmetric pivoting of the k x k matrix G
+   (overwritten): G(perm,perm) = R^t R, where R is upper triangular with the
+   first r rows computed. The factorization stops when the largest remaining
+   diagonal entry is <= tol times the largest diagonal entry of G. Returns the
+   numerical rank r. */
+static int PivotedCholesky(DenseMatrix &G, Array<int> &perm, DenseMatrix &R,
+                           double tol)
+{
+   const int k = G.Height();
+   perm.SetSize(k);
+   R.SetSize(k, k);
+   R = 0.0;
+   double dmax = 0.0;
+   for (int i = 0; i < k; i++)
+   {
+      perm[i] = i;
+      dmax = std::max(dmax, G(i,i));
+   }
+
+   int r;
+   for (r = 0; r < k; r++)
+   {
+      int q = r;
+      for (int j = r+1; j < k; j++)
+         if (G(j,j) > G(q,q))
+            q = j;
+      if (G(q,q) <= tol*dmax || G(q,q) <= 0.0)
+         break;
+      if (q != r)
+      {
+         for (int j = 0; j < k; j++)
+            std::swap(G(r,j), G(q,j));
+         for (int j = 0; j < k; j++)
+            std::swap(G(j,r), G(j,q));
+         for (int l = 0; l < r; l++)
+            std::swap(R(l,r), R(l,q));
+         std::swap(perm[r], perm[q]);
+      }
+      R(r,r) = sqrt(G(r,r));
+      for (int j = r+1; j < k; j++)
+         R(r,j) = G(r,j)/R(r,r);
+      for (int j = r+1; j < k; j++)
+         for (int l = r+1; l < k; l++)
+            G(j,l) -= R(r,j)*R(r,l);
+   }
+   return r;
+}
+
+/* One pass of pivoted Cholesky QR: X(:,perm) = Q R(0:r,:) with Q = X(:,perm(0:r))
+   R(0:r,0:r)^{-1}. On return R is r x k with the columns in the original
+   order and X is replaced by Q. */
+static void CholeskyQRStep(DenseMatrix &X, DenseMatrix &G, const Vector &d,
+                           double tol, DenseMatrix &R)
+{
+   const int n = X.Height(), k = X.Width();
+   Array<int> perm;
+   DenseMatrix Rp;
+   const int r = PivotedCholesky(G, perm, Rp, tol);
+
+   // undo the column scaling, G = D^{-1} X^t X D^{-1}
+   for (int j = 0; j < k; j++)
+      for (int i = 0; i < r; i++)
+         Rp(i,j) *= d(perm[j]);
+
+   DenseMatrix Q(n, r);
+   for (int j = 0; j < r; j++)
+   {
+      double *qj = Q.Data() + j*n;
+      const double *xj = X.Data() + perm[j]*n;
+      for (int l = 0; l < n; l++)
+         qj[l] = xj[l];
+      for (int i = 0; i < j; i++)
+      {
+         const double *qi = Q.Data() + i*n, a = Rp(i,j);
+         for (int l = 0; l < n; l++)
+            qj[l] -= a*qi[l];
+      }
+      const double a = 1.0/Rp(j,j);
+      for (int l = 0; l < n; l++)
+         qj[l] *= a;
+   }
+   X = Q;
+
+   R.SetSize(r, k);
+   for (int j = 0; j < k; j++)
+      for (int i = 0; i < r; i++)
+         R(i,perm[j]) = Rp(i,j);
+}
+
+void IterativeSolver::Orthonormalize(DenseMatrix &X, DenseMatrix &R) const
+{
+   const int k = X.Width();
+   DenseMatrix G, R1, R2;
+   Vector d(k);
+
+   // the columns are scaled to unit length, so that the dropping criterion
+   // measures linear dependence and not the size of the columns
+   BlockDot(X, X, G);
+   for (int j = 0; j < k; j++)
+      d(j) = (G(j,j) > 0.0) ? sqrt(G(j,j)) : 0.0;
+   for (int j = 0; j < k; j++)
+      for (int i = 0; i < k; i++)
+         G(i,j) = (d(i) > 0.0 && d(j) > 0.0) ? G(i,j)/(d(i)*d(j)) : 0.0;
+   CholeskyQRStep(X, G, d, 1e-12, R1);
+
+   // the second pass restores the orthogonality lost in the first one
+   const int r = X.Width();
+   BlockDot(X, X, G);
+   d.SetSize(r);
+   d = 1.0;
+   CholeskyQRStep(X, G, d, 0.0, R2);
+
+   R.SetSize(R2.Height(), k);
+   if (R2.Height() > 0 && k > 0)
+      mfem::Mult(R2, R1, R);
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -344,17 +651,17 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    for (i = 1; true; )
    {
       alpha = nom/den;
-      add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
+      x.Add(alpha, d);          //  x = x + alpha d
 
       if (prec)
       {
+         r.Add(-alpha, z);      //  r = r - alpha A d
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         betanom = AddAndDot(-alpha, z, r, r);  //  r = r - alpha A d
       }
 
       if (print_level == 1)
@@ -436,6 +743,217 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   m.SetSize(width);
+   n.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+   q.SetSize(width);
+   z.SetSize(width);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double dots[2], &gamma = dots[0], &delta = dots[1];
+   double r0 = 0.0, nom0 = 0.0, gamma_old = 0.0, alpha = 0.0, beta;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+      prec->Mult(r, u); // u = B r
+   else
+      u = r;
+   oper->Mult(u, w);    // w = A u
+
+   // without a preconditioner m = w, so 'mw' points to w instead of m
+   const Vector &mw = prec ? m : w;
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      StartDots(r, u, w, u, dots); // gamma = (B r, r), delta = (A u, u)
+      if (prec)
+         prec->Mult(w, m);         // m = B w
+      oper->Mult(mw, n);           // n = A m
+      FinishDots();
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1)
+         cout << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+              << gamma << '\n';
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+            cout << "Number of PCG iterations: " << i << '\n';
+         else if (print_level == 3)
+            cout << "(B r_0, r_0) = " << nom0 << '\n'
+                 << "(B r_N, r_N) = " << gamma << '\n'
+                 << "Number of PCG iterations: " << i << '\n';
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+         break;
+
+      if (i == 0)
+      {
+         beta = 0.0;
+         alpha = gamma/delta;
+         z = n;
+         q = mw;
+         s = w;
+         p = u;
+      }
+      else
+      {
+         beta = gamma/gamma_old;
+         alpha = gamma/(delta - beta*gamma/alpha);
+         add(n, beta, z, z);    // z = n + beta z
+         add(mw, beta, q, q);   // q = m + beta q
+         add(w, beta, s, s);    // s = w + beta s
+         add(u, beta, p, p);    // p = u + beta p
+      }
+      if (delta <= 0.0 && print_level >= 0)
+         cout << "PipelinedCG: The operator is not postive definite. "
+              "(A u, u) = " << delta << '\n';
+      gamma_old = gamma;
+
+      x.Add(alpha, p);          // x = x + alpha p
+      r.Add(-alpha, s);         // r = r - alpha s
+      u.Add(-alpha, q);         // u = u - alpha q
+      w.Add(-alpha, z);         // w = w - alpha z
+   }
+   if (print_level >= 0 && !converged)
+   {
+      cerr << "PipelinedCG: No convergence!" << '\n';
+      cout << "(B r_0, r_0) = " << nom0 << '\n'
+           << "(B r_N, r_N) = " << gamma << '\n'
+           << "Number of PCG iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      cout << "Average reduction factor = "
+           << pow (gamma/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
+
+void SingleReductionCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+}
+
+void SingleReductionCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double dots[2], &gamma = dots[0], &delta = dots[1];
+   double r0 = 0.0, nom0 = 0.0, gamma_old = 0.0, alpha = 0.0, beta;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      if (prec)
+         prec->Mult(r, u);         // u = B r
+      else
+         u = r;
+      oper->Mult(u, w);            // w = A u
+      StartDots(r, u, w, u, dots); // gamma = (B r, r), delta = (A u, u)
+      FinishDots();
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1)
+         cout << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+              << gamma << '\n';
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+            cout << "Number of PCG iterations: " << i << '\n';
+         else if (print_level == 3)
+            cout << "(B r_0, r_0) = " << nom0 << '\n'
+                 << "(B r_N, r_N) = " << gamma << '\n'
+                 << "Number of PCG iterations: " << i << '\n';
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+         break;
+
+      if (i == 0)
+      {
+         alpha = gamma/delta;
+         p = u;
+         s = w;
+      }
+      else
+      {
+         beta = gamma/gamma_old;
+         alpha = gamma/(delta - beta*gamma/alpha);
+         add(u, beta, p, p);    // p = u + beta p
+         add(w, beta, s, s);    // s = w + beta s
+      }
+      if (delta <= 0.0 && print_level >= 0)
+         cout << "SingleReductionCG: The operator is not postive definite. "
+              "(A u, u) = " << delta << '\n';
+      gamma_old = gamma;
+
+      x.Add(alpha, p);          // x = x + alpha p
+      r.Add(-alpha, s);         // r = r - alpha s (s = A p)
+   }
+   if (print_level >= 0 && !converged)
+   {
+      cerr << "SingleReductionCG: No convergence!" << '\n';
+      cout << "(B r_0, r_0) = " << nom0 << '\n'
+           << "(B r_N, r_N) = " << gamma << '\n'
+           << "Number of PCG iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      cout << "Average reduction factor = "
+           << pow (gamma/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
+
 inline void GeneratePlaneRotation(double &dx, double &dy,
                                   double &cs, double &sn)
 {
@@ -482,10 +1000,28 @@ inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
       x.Add(y(j), *v[j]);
 }
 
+// Same as above with the vectors v[j] stored as the columns of v
+inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
+                   DenseMatrix &v)
+{
+   Vector y(s);
+
+   // Backsolve:
+   for (int i = k; i >= 0; i--)
+   {
+      y(i) /= h(i,i);
+      for (int j = i - 1; j >= 0; j--)
+         y(j) -= h(j,i) * y(i);
+   }
+
+   AddMultVy(v, k+1, y.GetData(), 1.0, x);
+}
+
 void GMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    // Generalized Minimum Residual method following the algorithm
-   // on p. 20 of the SIAM Templates book.
+   // on p. 20 of the SIAM Templates book, with the Arnoldi vectors
+   // orthogonalized by classical Gram-Schmidt with reorthogonalization.
 
    int n = width;
 
@@ -535,36 +1071,33 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
            << "   Iteration : " << setw(3) << 0
            << "  ||B r|| = " << beta << '\n';
 
-   Array<Vector *> v(m+1);
-   v = NULL;
+   // the Krylov vectors v[k] are stored as the columns of V
+   DenseMatrix V(n, m+1);
+   Vector vk;
 
    for (j = 1; j <= max_iter; )
    {
-      if (v[0] == NULL)  v[0] = new Vector(n);
-      v[0]->Set(1.0/beta, r);
+      vk.SetDataAndSize(V.Data(), n);
+      vk.Set(1.0/beta, r);
       s = 0.0; s(0) = beta;
 
       for (i = 0; i < m && j <= max_iter; i++, j++)
       {
+         vk.SetDataAndSize(V.Data() + i*n, n);
          if (prec)
          {
-            oper->Mult(*v[i], r);
+            oper->Mult(vk, r);
             prec->Mult(r, w);        // w = M A v[i]
          }
          else
          {
-            oper->Mult(*v[i], w);
+            oper->Mult(vk, w);
          }
 
-         for (k = 0; k <= i; k++)
-         {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
-         }
-
-         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
-         if (v[i+1] == NULL)  v[i+1] = new Vector(n);
-         v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
+         // H(k,i) = w * v[k], w -= H(k,i) * v[k], H(i+1,i) = ||w||
+         OrthogonalizeCGS2(V, i+1, w, &H(0,i));
+         vk.SetDataAndSize(V.Data() + (i+1)*n, n);
+         vk.Set(1.0/H(i+1,i), w);    // v[i+1] = w / H(i+1,i)
 
          for (k = 0; k < i; k++)
             ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
@@ -581,11 +1114,9 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
 
          if (resid <= final_norm)
          {
-            Update(x, i, H, s, v);
+            Update(x, i, H, s, V);
             final_norm = resid;
             final_iter = j;
-            for (i = 0; i <= m; i++)
-               delete v[i];
             converged = 1;
             return;
          }
@@ -594,7 +1125,7 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
       if (print_level >= 0 && j <= max_iter)
          cout << "Restarting..." << '\n';
 
-      Update(x, i-1, H, s, v);
+      Update(x, i-1, H, s, V);
 
       oper->Mult(x, r);
       if (prec)
@@ -611,8 +1142,6 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
       {
          final_norm = beta;
          final_iter = j;
-         for (i = 0; i <= m; i++)
-            delete v[i];
          converged = 1;
          return;
       }
@@ -620,13 +1149,12 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
 
    final_norm = beta;
    final_iter = max_iter;
-   for (i = 0; i <= m; i++)
-      delete v[i];
    converged = 0;
 }
 
 void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
+   const int n = b.Size();
    DenseMatrix H(m+1,m);
    Vector s(m+1), cs(m+1), sn(m+1);
    Vector av(b.Size());
@@ -662,41 +1190,34 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
            << "   Iteration : " << setw(3) << 0
            << "  || r || = " << beta << endl;
 
-   Array<Vector*> v(m+1);
-   Array<Vector*> z(m+1);
-   for (i= 0; i<=m; i++)
-   {
-      v[i] = NULL;
-      z[i] = NULL;
-   }
+   // the vectors v[k] and z[k] are stored as the columns of V and Z
+   DenseMatrix V(n, m+1), Z(n, m);
+   Vector vk, zk;
 
    j = 1;
    while (j <= max_iter)
    {
-      if (v[0] == NULL) v[0] = new Vector(b.Size());
-      (*v[0]) = 0.0;
-      v[0] -> Add (1.0/beta, r);   // v[0] = r / ||r||
+      vk.SetDataAndSize(V.Data(), n);
+      vk.Set(1.0/beta, r);          // v[0] = r / ||r||
       s = 0.0; s(0) = beta;
 
       for (i = 0; i < m && j <= max_iter; i++)
       {
-
-         if (z[i] == NULL)  z[i] = new Vector(b.Size());
-         (*z[i]) = 0.0;
-
-         prec->Mult(*v[i], *z[i]);
-         oper->Mult(*z[i], r);
-
-         for (k = 0; k <= i; k++)
+         vk.SetDataAndSize(V.Data() + i*n, n);
+         zk.SetDataAndSize(Z.Data() + i*n, n);
+         if (prec)
          {
-            H(k,i) = Dot( r, *v[k]); // H(k,i) = r * v[k]
-            r.Add(-H(k,i), (*v[k])); // r -= H(k,i) * v[k]
+            zk = 0.0;
+            prec->Mult(vk, zk);
          }
+         else
+            zk = vk;
+         oper->Mult(zk, r);
 
-         H(i+1,i)  = Norm(r);       // H(i+1,i) = ||r||
-         if (v[i+1] == NULL) v[i+1] = new Vector(b.Size());
-         (*v[i+1]) = 0.0;
-         v[i+1] -> Add (1.0/H(i+1,i), r); // v[i+1] = r / H(i+1,i)
+         // H(k,i) = r * v[k], r -= H(k,i) * v[k], H(i+1,i) = ||r||
+         OrthogonalizeCGS2(V, i+1, r, &H(0,i));
+         vk.SetDataAndSize(V.Data() + (i+1)*n, n);
+         vk.Set(1.0/H(i+1,i), r);    // v[i+1] = r / H(i+1,i)
 
          for (k = 0; k < i; k++)
             ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
@@ -712,14 +1233,10 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
                  << "  || r || = " << resid << endl;
 
          if ( resid <= final_norm) {
-            Update(x, i, H, s, z);
+            Update(x, i, H, s, Z);
             final_norm = resid;
-            final_iter = (j-1)*m + i;
+            final_iter = (j-1)*m + i+1;
             converged = 1;
-            for (i= 0; i<=m; i++){
-               if (v[i])  delete v[i];
-               if (z[i])  delete z[i];
-            }
             return;
          }
       }
@@ -727,7 +1244,7 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
       if (print_level>=0)
          cout << "Restarting..." << endl;
 
-      Update(x, i-1, H, s, z);
+      Update(x, i-1, H, s, Z);
 
       oper->Mult(x, r);
       subtract(b,r,r);
@@ -737,21 +1254,12 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
          final_norm = beta;
          final_iter = j*m;
          converged = 1;
-         for (i= 0; i<=m; i++){
-            if (v[i])  delete v[i];
-            if (z[i])  delete z[i];
-         }
          return;
       }
 
       j++;
    }
 
-   for (i = 0; i <= m; i++)
-   {
-      if (v[i])  delete v[i];
-      if (z[i])  delete z[i];
-   }
    converged = 0;
    return;
 
@@ -782,6 +1290,475 @@ void GMRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+// Y = A X; a finalized SparseMatrix or a SELLMatrix (passed as the operator)
+// use their multi-vector products, which load each matrix entry once per group
+// of up to 4 columns. Other operators are applied column by column.
+static void BlockOperatorMult(const Operator &A, const DenseMatrix &X,
+                              DenseMatrix &Y)
+{
+   Y.SetSize(A.Height(), X.Width());
+   if (X.Width() == 0)
+      return;
+   const SparseMatrix *S = dynamic_cast<const SparseMatrix *>(&A);
+   if (S && S->Finalized())
+   {
+      S->Mult(X, Y);
+      return;
+   }
+   const SELLMatrix *L = dynamic_cast<const SELLMatrix *>(&A);
+   if (L)
+   {
+      L->Mult(X, Y);
+      return;
+   }
+   Vector x, y;
+   for (int j = 0; j < X.Width(); j++)
+   {
+      x.SetDataAndSize(X.Data() + j*X.Height(), X.Height());
+      y.SetDataAndSize(Y.Data() + j*Y.Height(), Y.Height());
+      A.Mult(x, y);
+   }
+}
+
+// X += a P L
+static void AddMultBlock(double a, const DenseMatrix &P, const DenseMatrix &L,
+                         DenseMatrix &X)
+{
+   const int n = P.Height();
+   for (int j = 0; j < L.Width(); j++)
+   {
+      double *xj = X.Data() + j*n;
+      for (int k = 0; k < P.Width(); k++)
+      {
+         const double *pk = P.Data() + k*n, c = a*L(k,j);
+         for (int i = 0; i < n; i++)
+            xj[i] += c*pk[i];
+      }
+   }
+}
+
+// Replace X by its columns with the given (increasing) indices
+static void KeepColumns(DenseMatrix &X, const Array<int> &cols)
+{
+   const int n = X.Height();
+   DenseMatrix Y(n, cols.Size());
+   for (int j = 0; j < cols.Size(); j++)
+   {
+      const double *xj = X.Data() + cols[j]*n;
+      double *yj = Y.Data() + j*n;
+      for (int i = 0; i < n; i++)
+         yj[i] = xj[i];
+   }
+   X = Y;
+}
+
+// Copy the column 'src' of X into the column 'dst' of Y
+static void CopyColumn(const DenseMatrix &X, int src, DenseMatrix &Y, int dst)
+{
+   const int n = X.Height();
+   const double *x = X.Data() + src*n;
+   double *y = Y.Data() + dst*n;
+   for (int i = 0; i < n; i++)
+      y[i] = x[i];
+}
+
+// Apply the block Solver::Mult() through the single vector version
+template <class BlockSolver>
+static void BlockSolverMultVectors(const BlockSolver &solver, int n,
+                                   const Array<Vector *> &b,
+                                   Array<Vector *> &x)
+{
+   DenseMatrix B(n, b.Size()), X(n, b.Size());
+   for (int j = 0; j < b.Size(); j++)
+   {
+      for (int i = 0; i < n; i++)
+         B(i,j) = (*b[j])(i);
+      if (solver.iterative_mode)
+         for (int i = 0; i < n; i++)
+            X(i,j) = (*x[j])(i);
+   }
+   solver.Mult(B, X);
+   for (int j = 0; j < b.Size(); j++)
+      for (int i = 0; i < n; i++)
+         (*x[j])(i) = X(i,j);
+}
+
+void BlockCGSolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
+{
+   const int nrhs = B.Width();
+   DenseMatrix R, Xa, Ra, Za, P, Q, Delta, T, Lambda, QtZ, Phi, Rfac;
+   Vector gamma, r0, nom0;
+   Array<int> act, keep;
+
+   if (iterative_mode)
+   {
+      MFEM_VERIFY(X.Height() == width && X.Width() == nrhs,
+                  "the initial guess X has the wrong size");
+      BlockOperatorMult(*oper, X, R);
+      R.Neg();
+      R.Add(1.0, B);            // R = B - A X
+   }
+   else
+   {
+      X.SetSize(width, nrhs);
+      X = 0.0;
+      R = B;
+   }
+   if (prec)
+      BlockOperatorMult(*prec, R, Za);
+   else
+      Za = R;
+   ColumnDots(Za, R, gamma);    // gamma(j) = (B r_j, r_j)
+
+   nom0 = gamma;
+   r0.SetSize(nrhs);
+   for (int j = 0; j < nrhs; j++)
+   {
+      r0(j) = std::max(gamma(j)*rel_tol*rel_tol, abs_tol*abs_tol);
+      if (gamma(j) > r0(j))
+         act.Append(j);
+   }
+   Xa = X;
+   Ra = R;
+   KeepColumns(Xa, act);
+   KeepColumns(Ra, act);
+   KeepColumns(Za, act);
+
+   if (print_level == 1)
+      cout << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+           << (nrhs ? gamma.Max() : 0.0) << '\n';
+
+   P = Za;
+   Orthonormalize(P, Rfac);
+
+   int i;
+   for (i = 1; act.Size() > 0 && i <= max_iter; i++)
+   {
+      if (P.Width() == 0)
+      {
+         // no new search directions: the remaining columns stagnate
+         i--;
+         break;
+      }
+      BlockOperatorMult(*oper, P, Q);   // Q = A P
+      BlockDot(P, Q, Delta);            // Delta = P^t A P
+      BlockDot(P, Ra, T);
+      Delta.Invert();
+      Lambda.SetSize(P.Width(), act.Size());
+      mfem::Mult(Delta, T, Lambda);          // Lambda = (P^t A P)^{-1} P^t R
+      AddMultBlock( 1.0, P, Lambda, Xa);
+      AddMultBlock(-1.0, Q, Lambda, Ra);
+
+      if (prec)
+         BlockOperatorMult(*prec, Ra, Za);
+      else
+         Za = Ra;
+      Vector gamma_a;
+      ColumnDots(Za, Ra, gamma_a);
+
+      // remove the converged columns from the block
+      keep.SetSize(0);
+      for (int j = 0; j < act.Size(); j++)
+      {
+         gamma(act[j]) = gamma_a(j);
+         if (gamma_a(j) > r0(act[j]))
+            keep.Append(j);
+         else
+            CopyColumn(Xa, j, X, act[j]);
+      }
+      if (print_level == 1)
+         cout << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+              << gamma_a.Max() << "  active columns = " << keep.Size()
+              << '\n';
+      if (keep.Size() == 0)
+      {
+         act.SetSize(0);
+         break;
+      }
+      if (keep.Size() < act.Size())
+      {
+         for (int j = 0; j < keep.Size(); j++)
+            act[j] = act[keep[j]];
+         act.SetSize(keep.Size());
+         KeepColumns(Xa, keep);
+         KeepColumns(Ra, keep);
+         KeepColumns(Za, keep);
+      }
+
+      BlockDot(Q, Za, QtZ);
+      Phi.SetSize(P.Width(), act.Size());
+      mfem::Mult(Delta, QtZ, Phi);           // Phi = (P^t A P)^{-1} Q^t Z
+      Q = Za;
+      AddMultBlock(-1.0, P, Phi, Q);    // P = Z - P Phi
+      P = Q;
+      Orthonormalize(P, Rfac);
+   }
+   for (int j = 0; j < act.Size(); j++)
+      CopyColumn(Xa, j, X, act[j]);
+
+   converged = (act.Size() == 0);
+   final_iter = std::min(i, max_iter);
+   double gmax = 0.0, g0max = 0.0;
+   for (int j = 0; j < nrhs; j++)
+   {
+      gmax = std::max(gmax, gamma(j));
+      g0max = std::max(g0max, nom0(j));
+   }
+   if (print_level == 2)
+      cout << "Number of block PCG iterations: " << final_iter << '\n';
+   else if (print_level == 3 || (print_level >= 0 && !converged))
+   {
+      if (!converged)
+         cerr << "Block PCG: No convergence!" << '\n';
+      cout << "max (B r_0, r_0) = " << g0max << '\n'
+           << "max (B r_N, r_N) = " << gmax << '\n'
+           << "Number of block PCG iterations: " << final_iter << '\n';
+   }
+   final_norm = sqrt(gmax);
+}
+
+void BlockCGSolver::Mult(const Array<Vector *> &b, Array<Vector *> &x) const
+{
+   BlockSolverMultVectors(*this, width, b, x);
+}
+
+void BlockCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   DenseMatrix B(b.GetData(), b.Size(), 1), X(x.GetData(), x.Size(), 1);
+   Mult(B, X);
+   B.ClearExternalData();
+   X.ClearExternalData();
+}
+
+void BlockGMRESSolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
+{
+   // Block GMRES with block Arnoldi (block modified Gram-Schmidt); the block
+   // Hessenberg matrix is reduced to triangular form with Givens rotations,
+   // which also give the least squares residual of each column. The matrix R
+   // holds the (preconditioned) residuals in the columns of the active
+   // right-hand sides.
+   const int nrhs = B.Width();
+   DenseMatrix R, W, Ra, Hij, G, Y, Rfac;
+   Vector beta, tol;
+   Array<int> act, keep;
+   Array<DenseMatrix *> V(m+1);
+   V = NULL;
+
+   if (iterative_mode)
+   {
+      MFEM_VERIFY(X.Height() == width && X.Width() == nrhs,
+                  "the initial guess X has the wrong size");
+      BlockOperatorMult(*oper, X, W);
+      W.Neg();
+      W.Add(1.0, B);
+   }
+   else
+   {
+      X.SetSize(width, nrhs);
+      X = 0.0;
+      W = B;
+   }
+   if (prec)
+      BlockOperatorMult(*prec, W, R);   // R = M (B - A X)
+   else
+      R = W;
+   ColumnDots(R, R, beta);
+
+   tol.SetSize(nrhs);
+   double res_max = 0.0;
+   for (int j = 0; j < nrhs; j++)
+   {
+      beta(j) = sqrt(beta(j));
+      tol(j) = std::max(rel_tol*beta(j), abs_tol);
+      if (beta(j) > tol(j))
+         act.Append(j);
+      res_max = std::max(res_max, beta(j));
+   }
+   if (print_level >= 0)
+      cout << "   Pass : " << setw(2) << 1
+           << "   Iteration : " << setw(3) << 0
+           << "  max ||B r|| = " << res_max << '\n';
+
+   int j = 1, pass = 1;
+   while (act.Size() > 0 && j <= max_iter)
+   {
+      // V_0 G_0 = R, where G_0 is the top block of the right-hand side G
+      Ra = R;
+      KeepColumns(Ra, act);
+      const int na = act.Size();
+      if (V[0] == NULL)
+         V[0] = new DenseMatrix;
+      *V[0] = Ra;
+      Orthonormalize(*V[0], Rfac);
+      const int s = V[0]->Width();
+      if (s == 0)
+         break;
+
+      DenseMatrix H((m+1)*s, m*s);
+      G.SetSize((m+1)*s, na);
+      G = 0.0;
+      for (int c = 0; c < na; c++)
+         for (int l = 0; l < s; l++)
+            G(l,c) = Rfac(l,c);
+      // Givens rotations zeroing the sub-diagonal part of H, at most 2s-1 per
+      // column since the blocks H_{i+1,i} are not triangular in general
+      Vector cs(m*s*2*s), sn(m*s*2*s);
+
+      // on breakdown (V_{i+1} has fewer than s columns) the cycle is ended
+      bool breakdown = false;
+      int k = 0, i;
+      for (i = 0; i < m && j <= max_iter; i++, j++)
+      {
+         if (prec)
+         {
+            BlockOperatorMult(*oper, *V[i], Ra);
+            BlockOperatorMult(*prec, Ra, W);    // W = M A V_i
+         }
+         else
+            BlockOperatorMult(*oper, *V[i], W);
+
+         for (int l = 0; l <= i; l++)
+         {
+            BlockDot(*V[l], W, Hij);            // H_li = V_l^t W
+            AddMultBlock(-1.0, *V[l], Hij, W);  // W -= V_l H_li
+            for (int c = 0; c < s; c++)
+               for (int r = 0; r < s; r++)
+                  H(l*s+r, i*s+c) = Hij(r,c);
+         }
+         if (V[i+1] == NULL)
+            V[i+1] = new DenseMatrix;
+         *V[i+1] = W;
+         Orthonormalize(*V[i+1], Hij);          // W = V_{i+1} H_{i+1,i}
+         for (int c = 0; c < s; c++)
+            for (int r = 0; r < Hij.Height(); r++)
+               H((i+1)*s+r, i*s+c) = Hij(r,c);
+         breakdown = (V[i+1]->Width() < s);
+
+         // reduce the new columns of H to upper triangular form; the column
+         // p of H has nonzeros in rows up to the end of its block row i+1
+         for (int c = i*s; c < (i+1)*s; c++)
+         {
+            for (int p = 0; p < c; p++)
+            {
+               const int last = (p/s+2)*s-1;
+               for (int t = 0; t < last-p; t++)
+                  ApplyPlaneRotation(H(last-1-t,c), H(last-t,c),
+                                     cs(p*2*s+t), sn(p*2*s+t));
+            }
+            const int last = (i+2)*s-1;
+            for (int t = 0; t < last-c; t++)
+            {
+               const int l = last-1-t, q = c*2*s+t;
+               GeneratePlaneRotation(H(l,c), H(l+1,c), cs(q), sn(q));
+               ApplyPlaneRotation(H(l,c), H(l+1,c), cs(q), sn(q));
+               for (int a = 0; a < na; a++)
+                  ApplyPlaneRotation(G(l,a), G(l+1,a), cs(q), sn(q));
+            }
+         }
+         k = (i+1)*s;
+
+         // the least squares residual of column a is ||G(k:k+s,a)||
+         bool done = true;
+         res_max = 0.0;
+         for (int a = 0; a < na; a++)
+         {
+            double res = 0.0;
+            for (int l = k; l < k+s; l++)
+               res += G(l,a)*G(l,a);
+            res = sqrt(res);
+            res_max = std::max(res_max, res);
+            if (res > tol(act[a]))
+               done = false;
+         }
+         if (print_level >= 0)
+            cout << "   Pass : " << setw(2) << pass
+                 << "   Iteration : " << setw(3) << j
+                 << "  max ||B r|| = " << res_max << '\n';
+         if (done || breakdown)
+         {
+            i++, j++;
+            break;
+         }
+      }
+
+      // solve the triangular system H(0:k,0:k) Y = G(0:k,:), update X
+      Y.SetSize(k, na);
+      for (int a = 0; a < na; a++)
+         for (int l = k-1; l >= 0; l--)
+         {
+            double y = G(l,a);
+            for (int p = l+1; p < k; p++)
+               y -= H(l,p)*Y(p,a);
+            Y(l,a) = y/H(l,l);
+         }
+      Ra = X;
+      KeepColumns(Ra, act);
+      for (int l = 0; l < i; l++)
+      {
+         DenseMatrix Yl(s, na);
+         for (int a = 0; a < na; a++)
+            for (int r = 0; r < s; r++)
+               Yl(r,a) = Y(l*s+r,a);
+         AddMultBlock(1.0, *V[l], Yl, Ra);
+      }
+      for (int a = 0; a < na; a++)
+         CopyColumn(Ra, a, X, act[a]);
+
+      // compute the true residuals and remove the converged columns
+      BlockOperatorMult(*oper, Ra, W);
+      W.Neg();
+      Ra = B;
+      KeepColumns(Ra, act);
+      W.Add(1.0, Ra);                     // W = B - A X for the active columns
+      if (prec)
+         BlockOperatorMult(*prec, W, Ra);
+      else
+         Ra = W;
+      ColumnDots(Ra, Ra, beta);
+      keep.SetSize(0);
+      res_max = 0.0;
+      for (int a = 0; a < na; a++)
+      {
+         beta(a) = sqrt(beta(a));
+         res_max = std::max(res_max, beta(a));
+         if (beta(a) > tol(act[a]))
+         {
+            CopyColumn(Ra, a, R, act[a]);
+            keep.Append(act[a]);
+         }
+      }
+      keep.Copy(act);
+
+      if (act.Size() > 0 && j <= max_iter && print_level >= 0)
+         cout << "Restarting..." << '\n';
+      pass++;
+   }
+
+   for (int i = 0; i <= m; i++)
+      delete V[i];
+
+   converged = (act.Size() == 0);
+   final_iter = std::min(j-1, max_iter);
+   final_norm = res_max;
+   if (print_level >= 0 && !converged)
+      cerr << "Block GMRES: No convergence!" << '\n';
+}
+
+void BlockGMRESSolver::Mult(const Array<Vector *> &b, Array<Vector *> &x)
+const
+{
+   BlockSolverMultVectors(*this, width, b, x);
+}
+
+void BlockGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   DenseMatrix B(b.GetData(), b.Size(), 1), X(x.GetData(), x.Size(), 1);
+   Mult(B, X);
+   B.ClearExternalData();
+   X.ClearExternalData();
+}
+
+
 void BiCGSTABSolver::UpdateVectors()
 {
    p.SetSize(width);
@@ -848,8 +1825,8 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       else
       {
          beta = (rho_1/rho_2) * (alpha/omega);
-         add(p, -omega, v, p);  //  p = p - omega * v
-         add(r, beta, p, p);    //  p = r + beta * p
+         //  p = r + beta * (p - omega * v)
+         add(1.0, r, beta, p, -beta*omega, v, p);
       }
       if (prec)
          prec->Mult(p, phat);  //  phat = M^{-1} * p
@@ -857,8 +1834,8 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
          phat = p;
       oper->Mult(phat, v);     //  v = A * phat
       alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
+      //  s = r - alpha * v
+      resid = sqrt(SetAndDot(1.0, r, -alpha, v, s, s));
       if (resid < tol_goal)
       {
          x.Add(alpha, phat);  //  x = x + alpha * phat
@@ -878,13 +1855,16 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       else
          shat = s;
       oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
-      x.Add(alpha, phat);   //  x += alpha * phat
-      x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
+      double dots[2];
+      StartDots(t, s, t, t, dots);
+      FinishDots();
+      omega = dots[0] / dots[1];
+      //  x += alpha * phat + omega * shat
+      add(1.0, x, alpha, phat, omega, shat, x);
 
       rho_2 = rho_1;
-      resid = Norm(r);
+      //  r = s - omega * t
+      resid = sqrt(SetAndDot(1.0, s, -omega, t, r, r));
       if (print_level >= 0)
          cout << "   ||r|| = " << resid << '\n';
       if (resid < tol_goal)
@@ -994,8 +1974,9 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       oper->Mult(*z, q);
       alpha = Dot(*z, q);
       if (it > 1) // (v0 == 0) for (it == 1)
-         q.Add(-beta, v0);
-      add(q, -alpha, v1, v0);
+         add(1.0, q, -beta, v0, -alpha, v1, v0);
+      else
+         add(q, -alpha, v1, v0);
 
       delta = gamma1*alpha - gamma0*sigma1*beta;
       rho3 = sigma0*beta;
@@ -1016,10 +1997,7 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       else if (it == 2)
          add(1./rho1, *z, -rho2/rho1, w1, w0);  // (w0 == 0)
       else
-      {
-         add(-rho3/rho1, w0, -rho2/rho1, w1, w0);
-         w0.Add(1./rho1, *z);
-      }
+         add(-rho3/rho1, w0, -rho2/rho1, w1, 1./rho1, *z, w0);
 
       gamma0 = gamma1;
       gamma1 = delta/rho1;
@@ -1494,7 +2472,7 @@ slbqp_done:
 void UMFPackSolver::Init()
 {
    mat = NULL;
-   Numeric = NULL;
+   Numeric = Symbolic = NULL;
    AI = AJ = NULL;
    if (!use_long_ints)
       umfpack_di_defaults(Control);
@@ -1502,12 +2480,39 @@ void UMFPackSolver::Init()
       umfpack_dl_defaults(Control);
 }
 
-void UMFPackSolver::SetOperator(const Operator &op)
+bool UMFPackSolver::SamePattern() const
 {
-   int *Ap, *Ai;
-   void *Symbolic;
-   double *Ax;
+   const int *Ap = mat->GetI(), *Ai = mat->GetJ();
+
+   if (Symbolic == NULL || SI.Size() != width + 1 || SJ.Size() != Ap[width])
+      return false;
+   for (int i = 0; i <= width; i++)
+      if (SI[i] != Ap[i])
+         return false;
+   for (int i = 0; i < Ap[width]; i++)
+      if (SJ[i] != Ai[i])
+         return false;
+   return true;
+}
+
+void UMFPackSolver::FreeSymbolic()
+{
+   if (Symbolic)
+   {
+      if (!use_long_ints)
+      {
+         umfpack_di_free_symbolic(&Symbolic);
+      }
+      else
+      {
+         umfpack_dl_free_symbolic(&Symbolic);
+      }
+   }
+   Symbolic = NULL;
+}
 
+void UMFPackSolver::FreeNumeric()
+{
    if (Numeric)
    {
       if (!use_long_ints)
@@ -1519,6 +2524,15 @@ void UMFPackSolver::SetOperator(const Operator &op)
          umfpack_dl_free_numeric(&Numeric);
       }
    }
+   Numeric = NULL;
+}
+
+void UMFPackSolver::SetOperator(const Operator &op)
+{
+   int *Ap, *Ai;
+   double *Ax;
+
+   FreeNumeric();
 
    mat = const_cast<SparseMatrix *>(dynamic_cast<const SparseMatrix *>(&op));
    if (mat == NULL)
@@ -1535,16 +2549,33 @@ void UMFPackSolver::SetOperator(const Operator &op)
    Ai = mat->GetJ();
    Ax = mat->GetData();
 
+   // keep the symbolic factorization if the sparsity pattern did not change
+   const bool reuse = SamePattern();
+   if (!reuse)
+   {
+      FreeSymbolic();
+      SI.SetSize(width + 1);
+      for (int i = 0; i <= width; i++)
+         SI[i] = Ap[i];
+      SJ.SetSize(Ap[width]);
+      for (int i = 0; i < Ap[width]; i++)
+         SJ[i] = Ai[i];
+   }
+
    if (!use_long_ints)
    {
-      int status = umfpack_di_symbolic(width, width, Ap, Ai, Ax, &Symbolic,
-                                       Control, Info);
-      if (status < 0)
+      int status;
+      if (!reuse)
       {
-         umfpack_di_report_info(Control, Info);
-         umfpack_di_report_status(Control, status);
-         mfem_error("UMFPackSolver::SetOperator :"
-                    " umfpack_di_symbolic() failed!");
+         status = umfpack_di_symbolic(width, width, Ap, Ai, Ax, &Symbolic,
+                                      Control, Info);
+         if (status < 0)
+         {
+            umfpack_di_report_info(Control, Info);
+            umfpack_di_report_status(Control, status);
+            mfem_error("UMFPackSolver::SetOperator :"
+                       " umfpack_di_symbolic() failed!");
+         }
       }
 
       status = umfpack_di_numeric(Ap, Ai, Ax, Symbolic, &Numeric,
@@ -1556,29 +2587,31 @@ void UMFPackSolver::SetOperator(const Operator &op)
          mfem_error("UMFPackSolver::SetOperator :"
                     " umfpack_di_numeric() failed!");
       }
-      umfpack_di_free_symbolic(&Symbolic);
    }
    else
    {
       SuiteSparse_long status;
 
-      delete [] AJ;
-      delete [] AI;
-      AI = new SuiteSparse_long[width + 1];
-      AJ = new SuiteSparse_long[Ap[width]];
-      for (int i = 0; i <= width; i++)
-         AI[i] = (SuiteSparse_long)(Ap[i]);
-      for (int i = 0; i <= Ap[width]; i++)
-         AJ[i] = (SuiteSparse_long)(Ai[i]);
-
-      status = umfpack_dl_symbolic(width, width, AI, AJ, Ax, &Symbolic,
-                                   Control, Info);
-      if (status < 0)
+      if (!reuse)
       {
-         umfpack_dl_report_info(Control, Info);
-         umfpack_dl_report_status(Control, status);
-         mfem_error("UMFPackSolver::SetOperator :"
-                    " umfpack_dl_symbolic() failed!");
+         delete [] AJ;
+         delete [] AI;
+         AI = new SuiteSparse_long[width + 1];
+         AJ = new SuiteSparse_long[Ap[width]];
+         for (int i = 0; i <= width; i++)
+            AI[i] = (SuiteSparse_long)(Ap[i]);
+         for (int i = 0; i < Ap[width]; i++)
+            AJ[i] = (SuiteSparse_long)(Ai[i]);
+
+         status = umfpack_dl_symbolic(width, width, AI, AJ, Ax, &Symbolic,
+                                      Control, Info);
+         if (status < 0)
+         {
+            umfpack_dl_report_info(Control, Info);
+            umfpack_dl_report_status(Control, status);
+            mfem_error("UMFPackSolver::SetOperator :"
+                       " umfpack_dl_symbolic() failed!");
+         }
       }
 
       status = umfpack_dl_numeric(AI, AJ, Ax, Symbolic, &Numeric,
@@ -1590,7 +2623,6 @@ void UMFPackSolver::SetOperator(const Operator &op)
          mfem_error("UMFPackSolver::SetOperator :"
                     " umfpack_dl_numeric() failed!");
       }
-      umfpack_dl_free_symbolic(&Symbolic);
    }
 }
 
@@ -1664,17 +2696,8 @@ UMFPackSolver::~UMFPackSolver()
 {
    delete [] AJ;
    delete [] AI;
-   if (Numeric)
-   {
-      if (!use_long_ints)
-      {
-         umfpack_di_free_numeric(&Numeric);
-      }
-      else
-      {
-         umfpack_dl_free_numeric(&Numeric);
-      }
-   }
+   FreeNumeric();
+   FreeSymbolic();
 }
 
 #endif // MFEM_USE_SUITESPARSE
@@ -14,6 +14,7 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#include "densemat.hpp"
 
 #ifdef MFEM_USE_MPI
 #include <mpi.h>
@@ -33,6 +34,8 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable double dots_local[2];
+   mutable MPI_Request dots_request;
 #endif
 
 protected:
@@ -49,6 +52,44 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** y += a * x, returning the global inner product (y, z) computed in the
+       same pass over the data (see Vector::AddAndDot). */
+   double AddAndDot(double a, const Vector &x, Vector &y,
+                    const Vector &z) const
+   { return GlobalSum(y.AddAndDot(a, x, z)); }
+   /** w = a * x + b * y, returning the global inner product (w, z) computed
+       in the same pass over the data (see Vector::SetAndDot). */
+   double SetAndDot(double a, const Vector &x, double b, const Vector &y,
+                    Vector &w, const Vector &z) const
+   { return GlobalSum(w.SetAndDot(a, x, b, y, z)); }
+   /// Sum a locally computed inner product over all processors
+   double GlobalSum(double local_dot) const;
+
+   /** Start the computation of the two inner products (x1,y1) and (x2,y2)
+       with a single global reduction, which is non-blocking with MPI-3. The
+       results are stored in 'dots' after the call to FinishDots(). */
+   void StartDots(const Vector &x1, const Vector &y1,
+                  const Vector &x2, const Vector &y2, double *dots) const;
+   /// Complete the reduction started by StartDots()
+   void FinishDots() const;
+
+   /// Compute XtY = X^t Y with a single global reduction
+   void BlockDot(const DenseMatrix &X, const DenseMatrix &Y,
+                 DenseMatrix &XtY) const;
+   /// Compute the inner products of the columns of X and Y
+   void ColumnDots(const DenseMatrix &X, const DenseMatrix &Y,
+                   Vector &dots) const;
+   /** Replace the columns of X with an orthonormal basis of their span using
+       (two passes of) pivoted Cholesky QR. Numerically dependent columns are
+       dropped, so X may get fewer columns; on return X_old = X_new R. */
+   void Orthonormalize(DenseMatrix &X, DenseMatrix &R) const;
+   /** Orthogonalize w against the first k (orthonormal) columns of V using
+       classical Gram-Schmidt with one reorthogonalization pass (CGS2). On
+       return h[0..k-1] are the coefficients and h[k] is the norm of the new
+       w. Only two global reductions are used, independently of k. */
+   void OrthogonalizeCGS2(const DenseMatrix &V, int k, Vector &w,
+                          double *h) const;
+
 public:
    IterativeSolver();
 
@@ -137,6 +178,55 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/** Pipelined preconditioned conjugate gradient method (Ghysels, Vanroose).
+    The two inner products of each iteration are combined in one global
+    reduction which overlaps with the application of the preconditioner and
+    the operator (when MPI-3 is available). Uses more vectors than CGSolver
+    and its residual may be less accurate near convergence. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, p, s, q, z;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/** Conjugate gradient method of Chronopoulos and Gear, the one-step version
+    of s-step CG: both inner products of each iteration are computed with a
+    single global reduction. */
+class SingleReductionCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, p, s;
+
+   void UpdateVectors();
+
+public:
+   SingleReductionCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   SingleReductionCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
@@ -183,6 +273,62 @@ void GMRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
            double rtol = 1e-12, double atol = 1e-24);
 
 
+/** Block preconditioned conjugate gradient method for multiple right-hand
+    sides. In each iteration, the operator is applied to all search
+    directions at once: a finalized SparseMatrix or a SELLMatrix set as the
+    operator use their multi-vector Mult(), which loads each matrix entry once
+    per group of up to 4 columns; other operators and the preconditioner are
+    applied column by column. With a SELLMatrix operator, a preconditioner
+    built from the SparseMatrix (e.g. DSmoother) has to be set after
+    SetOperator(). The search directions are orthonormalized
+    to avoid breakdown and the converged columns are removed from the block.
+    The tolerances apply to each column separately. */
+class BlockCGSolver : public IterativeSolver
+{
+public:
+   BlockCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   /// Solve A X = B, where the columns of B are the right-hand sides
+   void Mult(const DenseMatrix &B, DenseMatrix &X) const;
+
+   /// Solve A x[i] = b[i] for all i
+   void Mult(const Array<Vector *> &b, Array<Vector *> &x) const;
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** Block GMRES method for multiple right-hand sides, with left
+    preconditioning like GMRESSolver. The restart length, SetKDim(), is in
+    number of block iterations. Columns that converge are removed from the
+    block at the next restart. */
+class BlockGMRESSolver : public IterativeSolver
+{
+protected:
+   int m;
+
+public:
+   BlockGMRESSolver() { m = 20; }
+
+#ifdef MFEM_USE_MPI
+   BlockGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 20; }
+#endif
+
+   void SetKDim(int dim) { m = dim; }
+
+   /// Solve A X = B, where the columns of B are the right-hand sides
+   void Mult(const DenseMatrix &B, DenseMatrix &X) const;
+
+   /// Solve A x[i] = b[i] for all i
+   void Mult(const Array<Vector *> &b, Array<Vector *> &x) const;
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
 /// BiCGSTAB method
 class BiCGSTABSolver : public IterativeSolver
 {
@@ -325,14 +471,25 @@ public:
 
 #ifdef MFEM_USE_SUITESPARSE
 
-/// Direct sparse solver using UMFPACK
+/** Direct sparse solver using UMFPACK. The symbolic factorization is kept
+    and reused by SetOperator() when the new matrix has the same sparsity
+    pattern as the previous one (e.g. the Jacobians in NewtonSolver or the
+    matrices of implicit time steps), so that only the numeric factorization
+    is recomputed. Changes of the Control parameters of the symbolic analysis
+    (e.g. the ordering) take effect when the pattern changes. */
 class UMFPackSolver : public Solver
 {
 protected:
    bool use_long_ints;
    SparseMatrix *mat;
-   void *Numeric;
+   void *Numeric, *Symbolic;
    SuiteSparse_long *AI, *AJ;
+   Array<int> SI, SJ; // the sparsity pattern of the symbolic factorization
+
+   /// Check if the pattern of mat is the one of the symbolic factorization
+   bool SamePattern() const;
+   void FreeSymbolic();
+   void FreeNumeric();
 
    void Init();
 
@@ -345,7 +502,9 @@ public:
    UMFPackSolver(SparseMatrix &A, bool _use_long_ints = false)
       : use_long_ints(_use_long_ints) { Init(); SetOperator(A); }
 
-   // Works on sparse matrices only; calls SparseMatrix::SortColumnIndices().
+   /** Works on sparse matrices only; calls SparseMatrix::SortColumnIndices().
+       The symbolic factorization is recomputed only if the sparsity pattern
+       changed. */
    virtual void SetOperator(const Operator &op);
 
    void SetPrintLevel(int print_lvl) { Control[UMFPACK_PRL] = print_lvl; }
@@ -0,0 +1,444 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the sparse LDL^T direct solver
+
+#include "sparseldl.hpp"
+
+namespace mfem
+{
+
+// Degree lists of the minimum degree ordering
+static inline void DegreeListInsert(int i, int d, Array<int> &head,
+                                    Array<int> &next, Array<int> &prev)
+{
+   next[i] = head[d];
+   prev[i] = -1;
+   if (head[d] >= 0)
+      prev[head[d]] = i;
+   head[d] = i;
+}
+
+static inline void DegreeListRemove(int i, int d, Array<int> &head,
+                                    Array<int> &next, Array<int> &prev)
+{
+   if (prev[i] >= 0)
+      next[prev[i]] = next[i];
+   else
+      head[d] = next[i];
+   if (next[i] >= 0)
+      prev[next[i]] = prev[i];
+}
+
+/* The elimination is done on the quotient graph: the eliminated unknowns
+   become elements, each with the list of the (not yet eliminated) variables
+   it couples, and the elements adjacent to a pivot are absorbed into the new
+   element. The degree of a variable i is approximated as in AMD by
+
+      |A_i| + |L_p \ i| + sum_{e in E_i, e != p} |L_e \ L_p|,
+
+   where A_i and E_i are the variables and the elements adjacent to i, L_e is
+   the variable list of element e and p is the last pivot. Elements with
+   L_e contained in L_p are absorbed as well. */
+void MinimumDegreeOrdering(const SparseMatrix &A, Array<int> &perm)
+{
+   enum { VARIABLE, ELEMENT, ABSORBED };
+
+   const int n = A.Height();
+   MFEM_VERIFY(A.Finalized() && A.Width() == n,
+               "MinimumDegreeOrdering : not a finalized square matrix!");
+
+   SparseMatrix *At = Transpose(A);
+   const int *I = A.GetI(), *J = A.GetJ(), *It = At->GetI(), *Jt = At->GetJ();
+
+   Array<Array<int> *> Av(n), Ae(n), Le(n);
+   Array<int> status(n), deg(n), mark(n), w(n), wmark(n);
+   Array<int> head(n), next(n), prev(n);
+
+   // the graph of A + A^T, without the diagonal
+   mark = -1;
+   for (int i = 0; i < n; i++)
+   {
+      Av[i] = new Array<int>;
+      Ae[i] = new Array<int>;
+      Le[i] = NULL;
+      mark[i] = i;
+      for (int k = I[i]; k < I[i+1]; k++)
+         if (mark[J[k]] != i)
+         {
+            mark[J[k]] = i;
+            Av[i]->Append(J[k]);
+         }
+      for (int k = It[i]; k < It[i+1]; k++)
+         if (mark[Jt[k]] != i)
+         {
+            mark[Jt[k]] = i;
+            Av[i]->Append(Jt[k]);
+         }
+      status[i] = VARIABLE;
+   }
+   delete At;
+
+   head = -1;
+   for (int i = 0; i < n; i++)
+   {
+      deg[i] = Av[i]->Size();
+      DegreeListInsert(i, deg[i], head, next, prev);
+   }
+   mark = -1;
+   wmark = -1;
+
+   perm.SetSize(n);
+   int mindeg = 0;
+   for (int k = 0; k < n; k++)
+   {
+      while (head[mindeg] < 0)
+         mindeg++;
+      const int p = head[mindeg];
+      DegreeListRemove(p, mindeg, head, next, prev);
+      perm[k] = p;
+      status[p] = ELEMENT;
+
+      // the variables of the new element
+      Array<int> *Lp = new Array<int>;
+      for (int j = 0; j < Av[p]->Size(); j++)
+      {
+         const int v = (*Av[p])[j];
+         if (status[v] == VARIABLE && mark[v] != k)
+         {
+            mark[v] = k;
+            Lp->Append(v);
+         }
+      }
+      for (int j = 0; j < Ae[p]->Size(); j++)
+      {
+         const int e = (*Ae[p])[j];
+         if (status[e] != ELEMENT)
+            continue;
+         for (int q = 0; q < Le[e]->Size(); q++)
+         {
+            const int v = (*Le[e])[q];
+            if (status[v] == VARIABLE && mark[v] != k)
+            {
+               mark[v] = k;
+               Lp->Append(v);
+            }
+         }
+         status[e] = ABSORBED;
+         delete Le[e];
+         Le[e] = NULL;
+      }
+      delete Av[p];
+      delete Ae[p];
+      Av[p] = Ae[p] = NULL;
+      Le[p] = Lp;
+
+      // w[e] = |L_e \ L_p| for the elements adjacent to L_p
+      for (int j = 0; j < Lp->Size(); j++)
+      {
+         const Array<int> &Ei = *Ae[(*Lp)[j]];
+         for (int q = 0; q < Ei.Size(); q++)
+         {
+            const int e = Ei[q];
+            if (status[e] != ELEMENT)
+               continue;
+            if (wmark[e] != k)
+            {
+               wmark[e] = k;
+               w[e] = Le[e]->Size();
+            }
+            w[e]--;
+         }
+      }
+
+      // update the adjacency and the degrees of the variables in L_p
+      const int max_deg = n - k - 2;
+      for (int j = 0; j < Lp->Size(); j++)
+      {
+         const int i = (*Lp)[j];
+         DegreeListRemove(i, deg[i], head, next, prev);
+
+         int d = Lp->Size() - 1, m = 0;
+         Array<int> &Ei = *Ae[i];
+         for (int q = 0; q < Ei.Size(); q++)
+         {
+            const int e = Ei[q];
+            if (status[e] != ELEMENT)
+               continue;
+            if (w[e] == 0)
+            {
+               status[e] = ABSORBED;
+               delete Le[e];
+               Le[e] = NULL;
+               continue;
+            }
+            Ei[m++] = e;
+            d += w[e];
+         }
+         Ei.SetSize(m);
+         Ei.Append(p);
+
+         // the variables in L_p are now coupled to i through p
+         Array<int> &Ai = *Av[i];
+         m = 0;
+         for (int q = 0; q < Ai.Size(); q++)
+         {
+            const int v = Ai[q];
+            if (status[v] == VARIABLE && mark[v] != k)
+               Ai[m++] = v;
+         }
+         Ai.SetSize(m);
+         d += m;
+
+         // the external degree grows by at most |L_p \ i|
+         if (d > deg[i] + Lp->Size() - 1)
+            d = deg[i] + Lp->Size() - 1;
+         deg[i] = (d < max_deg) ? d : max_deg;
+         DegreeListInsert(i, deg[i], head, next, prev);
+         if (deg[i] < mindeg)
+            mindeg = deg[i];
+      }
+   }
+
+   for (int i = 0; i < n; i++)
+   {
+      delete Av[i];
+      delete Ae[i];
+      delete Le[i];
+   }
+}
+
+void SparseLDLSolver::SetOperator(const Operator &op)
+{
+   const SparseMatrix *m = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(m != NULL && m->Finalized(),
+               "SparseLDLSolver::SetOperator : not a finalized SparseMatrix!");
+   MFEM_VERIFY(m->Height() == m->Width(),
+               "SparseLDLSolver::SetOperator : the matrix is not square!");
+
+   const int n = m->Height(), *I = m->GetI(), *J = m->GetJ();
+   bool same = (AI.Size() == n+1 && AJ.Size() == I[n]);
+   for (int i = 0; same && i <= n; i++)
+      same = (AI[i] == I[i]);
+   for (int k = 0; same && k < I[n]; k++)
+      same = (AJ[k] == J[k]);
+
+   mat = m;
+   height = width = n;
+   if (!same)
+      Analyze();
+   Factor();
+}
+
+void SparseLDLSolver::Analyze()
+{
+   const int n = height, *I = mat->GetI(), *J = mat->GetJ();
+
+   AI.SetSize(n+1);
+   for (int i = 0; i <= n; i++)
+      AI[i] = I[i];
+   AJ.SetSize(I[n]);
+   for (int k = 0; k < I[n]; k++)
+      AJ[k] = J[k];
+
+   MinimumDegreeOrdering(*mat, perm);
+   Array<int> iperm(n);
+   for (int i = 0; i < n; i++)
+      iperm[perm[i]] = i;
+
+   // The lower triangular part of C = P A P^T, C(i,k) = A(perm[i],perm[k]),
+   // from the lower triangular part of A only: the entry A(r,c), c <= r, is
+   // C(i,k) with i = max(iperm[r],iperm[c]) and k = min(iperm[r],iperm[c]).
+   CI.SetSize(n+1);
+   CI = 0;
+   for (int r = 0; r < n; r++)
+      for (int q = I[r]; q < I[r+1]; q++)
+         if (J[q] <= r)
+         {
+            const int i = iperm[r], k = iperm[J[q]];
+            CI[((i > k) ? i : k) + 1]++;
+         }
+   for (int i = 0; i < n; i++)
+      CI[i+1] += CI[i];
+   CJ.SetSize(CI[n]);
+   CA.SetSize(CI[n]);
+   for (int r = 0; r < n; r++)
+      for (int q = I[r]; q < I[r+1]; q++)
+         if (J[q] <= r)
+         {
+            const int i = iperm[r], k = iperm[J[q]];
+            const int row = (i > k) ? i : k;
+            CJ[CI[row]] = (i > k) ? k : i;
+            CA[CI[row]++] = q;
+         }
+   for (int i = n; i > 0; i--)
+      CI[i] = CI[i-1];
+   CI[0] = 0;
+
+   // The elimination tree and the column counts of L: the nonzeros of row i
+   // of L are the nodes of the tree on the paths from the columns k < i of
+   // row i of C up to i.
+   Array<int> flag(n), count(n);
+   parent.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      parent[i] = -1;
+      flag[i] = i;
+      count[i] = 0;
+      for (int q = CI[i]; q < CI[i+1]; q++)
+         for (int k = CJ[q]; flag[k] != i; k = parent[k])
+         {
+            if (parent[k] == -1)
+               parent[k] = i;
+            count[k]++;
+            flag[k] = i;
+         }
+   }
+   Lp.SetSize(n+1);
+   Lp[0] = 0;
+   for (int k = 0; k < n; k++)
+      Lp[k+1] = Lp[k] + count[k];
+
+   // Group the rows by their height in the tree: the rows of a level depend
+   // only on rows of lower levels and can be computed in parallel. The
+   // children of a node have smaller indices.
+   Array<int> &level = count;
+   level = 0;
+   int nl = (n > 0) ? 1 : 0;
+   for (int i = 0; i < n; i++)
+      if (parent[i] >= 0 && level[i] + 1 > level[parent[i]])
+      {
+         level[parent[i]] = level[i] + 1;
+         if (level[i] + 2 > nl)
+            nl = level[i] + 2;
+      }
+   lev_ptr.SetSize(nl+1);
+   lev_ptr = 0;
+   for (int i = 0; i < n; i++)
+      lev_ptr[level[i]+1]++;
+   for (int l = 0; l < nl; l++)
+      lev_ptr[l+1] += lev_ptr[l];
+   lev_nodes.SetSize(n);
+   for (int i = 0; i < n; i++)
+      lev_nodes[lev_ptr[level[i]]++] = i;
+   for (int l = nl; l > 0; l--)
+      lev_ptr[l] = lev_ptr[l-1];
+   lev_ptr[0] = 0;
+
+   Li.SetSize(Lp[n]);
+   Lx.SetSize(Lp[n]);
+   Lnz.SetSize(n);
+   D.SetSize(n);
+   y.SetSize(n);
+}
+
+/* Up-looking factorization: row i of L is obtained from a sparse triangular
+   solve with the rows of L in the subtree of i, and is stored by appending
+   its entries to the columns of L. Two rows of the same level have disjoint
+   subtrees and write to different columns, so they can be computed by
+   different threads. */
+void SparseLDLSolver::Factor()
+{
+   const int n = height;
+   const double *A = mat->GetData();
+   int zero_pivot = -1;
+
+   Lnz = 0;
+
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel reduction(max:zero_pivot)
+#endif
+   {
+      Array<int> flag(n), pattern(n);
+      Vector Y(n);
+      flag = -1;
+      Y = 0.0;
+
+      for (int l = 0; l < lev_ptr.Size()-1; l++)
+      {
+#ifdef MFEM_USE_OPENMP
+#pragma omp for
+#endif
+         for (int t = lev_ptr[l]; t < lev_ptr[l+1]; t++)
+         {
+            const int i = lev_nodes[t];
+
+            // scatter row i of C into Y and find the pattern of row i of L
+            int top = n;
+            flag[i] = i;
+            for (int q = CI[i]; q < CI[i+1]; q++)
+            {
+               int k = CJ[q], len = 0;
+               Y(k) += A[CA[q]];
+               for ( ; flag[k] != i; k = parent[k])
+               {
+                  pattern[len++] = k;
+                  flag[k] = i;
+               }
+               while (len > 0)
+                  pattern[--top] = pattern[--len];
+            }
+
+            double di = Y(i);
+            Y(i) = 0.0;
+            for ( ; top < n; top++)
+            {
+               const int k = pattern[top];
+               const double yk = Y(k);
+               Y(k) = 0.0;
+               const int end = Lp[k] + Lnz[k];
+               for (int p = Lp[k]; p < end; p++)
+                  Y(Li[p]) -= Lx[p]*yk;
+               const double lik = yk/D(k);
+               di -= lik*yk;
+               Li[end] = i;
+               Lx[end] = lik;
+               Lnz[k]++;
+            }
+            D(i) = di;
+            if (di == 0.0)
+               zero_pivot = i;
+         }
+      }
+   }
+
+   MFEM_VERIFY(zero_pivot < 0, "SparseLDLSolver : zero pivot in row "
+               << perm[zero_pivot]);
+}
+
+void SparseLDLSolver::Mult(const Vector &b, Vector &x) const
+{
+   const int n = height;
+
+   for (int i = 0; i < n; i++)
+      y(i) = b(perm[i]);
+
+   // L z = P b
+   for (int k = 0; k < n; k++)
+   {
+      const double yk = y(k);
+      for (int p = Lp[k]; p < Lp[k+1]; p++)
+         y(Li[p]) -= Lx[p]*yk;
+   }
+   // D L^T w = z
+   for (int k = n-1; k >= 0; k--)
+   {
+      double s = y(k)/D(k);
+      for (int p = Lp[k]; p < Lp[k+1]; p++)
+         s -= Lx[p]*y(Li[p]);
+      y(k) = s;
+   }
+
+   for (int i = 0; i < n; i++)
+      x(perm[i]) = y(i);
+}
+
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SPARSELDL
+#define MFEM_SPARSELDL
+
+#include "../config/config.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** Compute a fill-reducing ordering of the graph of A + A^T with the
+    minimum degree algorithm, using a quotient graph and approximate external
+    degrees (as in AMD). On return, perm[k] is the k-th unknown to eliminate. */
+void MinimumDegreeOrdering(const SparseMatrix &A, Array<int> &perm);
+
+/** Direct solver for a symmetric SparseMatrix, based on the sparse
+    factorization P A P^T = L D L^T, where P is a minimum degree ordering.
+    No pivoting is done, so the matrix must be positive definite, or at least
+    have such a factorization (e.g. quasi-definite matrices). Only the lower
+    triangular part of the matrix is used, so the matrix may store just that
+    part, or the full symmetric matrix.
+
+    SetOperator() computes the ordering and the sparsity of L (the symbolic
+    analysis) and then the factors. The analysis is reused when the new
+    matrix has the same sparsity pattern as the analyzed one, e.g. for the
+    Jacobians in NewtonSolver or in implicit time stepping. The rows of L are
+    computed level by level in the elimination tree, in parallel with OpenMP
+    within each level. */
+class SparseLDLSolver : public Solver
+{
+protected:
+   const SparseMatrix *mat;
+
+   // symbolic analysis
+   Array<int> AI, AJ;     // pattern of the analyzed matrix
+   Array<int> perm;       // row i of P A P^T is row perm[i] of A
+   Array<int> CI, CJ, CA; // lower part of P A P^T by rows, with the indices
+                          // of its entries in the lower part of A
+   Array<int> parent;     // elimination tree
+   Array<int> Lp;         // column pointers of L
+   Array<int> lev_ptr, lev_nodes; // the rows of L, grouped by tree levels
+
+   // numeric factorization (strictly lower part of L by columns)
+   Array<int> Li, Lnz;
+   Array<double> Lx;
+   Vector D;
+
+   mutable Vector y;
+
+   void Analyze();
+   void Factor();
+
+public:
+   SparseLDLSolver() { mat = NULL; }
+
+   SparseLDLSolver(const SparseMatrix &A) { mat = NULL; SetOperator(A); }
+
+   /** Factor the given finalized SparseMatrix, reusing the analysis if the
+       sparsity pattern is the same as the previous one. */
+   virtual void SetOperator(const Operator &op);
+
+   /// Number of nonzeros in L, including the unit diagonal
+   int NumNonZeroElems() const { return Li.Size() + height; }
+
+   /// Solve A x = b
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+}
+
+#endif
@@ -312,8 +312,36 @@ void SparseMatrix::GetDiag(Vector & d) const
 
 void SparseMatrix::Mult(const Vector &x, Vector &y) const
 {
-   y = 0.0;
-   AddMult(x, y);
+   if (A == NULL)
+   {
+      y = 0.0;
+      AddMult(x, y);
+      return;
+   }
+
+   MFEM_ASSERT(width == x.Size(),
+               "Input vector size (" << x.Size() << ") must match matrix width (" << width
+               << ")");
+   MFEM_ASSERT(height == y.Size(),
+               "Output vector size (" << y.Size() << ") must match matrix height (" << height
+               << ")");
+
+   // write y directly instead of zeroing it first and accumulating
+   const double *Ap = A, *xp = x.GetData();
+   const int *Jp = J, *Ip = I;
+   double *yp = y.GetData();
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      double d = 0.0;
+      for (int j = Ip[i], end = Ip[i+1]; j < end; j++)
+      {
+         d += Ap[j] * xp[Jp[j]];
+      }
+      yp[i] = d;
+   }
 }
 
 void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
@@ -385,6 +413,77 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
       }
 }
 
+void SparseMatrix::Mult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   Y.SetSize(height, X.Width());
+   Y = 0.0;
+   AddMult(X, Y);
+}
+
+void SparseMatrix::AddMult(const DenseMatrix &X, DenseMatrix &Y,
+                           const double a) const
+{
+   MFEM_VERIFY(A != NULL, "the matrix must be finalized");
+   MFEM_ASSERT(X.Height() == width && Y.Height() == height &&
+               X.Width() == Y.Width(), "incompatible dimensions");
+
+   const int nv = X.Width();
+   const double *Ap = A, *xp = X.Data();
+   const int *Jp = J, *Ip = I;
+   double *yp = Y.Data();
+
+   if (nv == 1)
+   {
+      Vector x(const_cast<double *>(xp), width), y(yp, height);
+      AddMult(x, y, a);
+      return;
+   }
+
+   // process the right-hand sides in groups of up to 4 so that each entry
+   // (and column index) of A is reused from registers
+   for (int v0 = 0; v0 < nv; v0 += 4)
+   {
+      const int nb = std::min(4, nv - v0);
+      const double *x0 = xp + v0*width;
+      double *y0 = yp + v0*height;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+      for (int i = 0; i < height; i++)
+      {
+         double d[4] = { 0.0, 0.0, 0.0, 0.0 };
+         if (nb == 4)
+         {
+            for (int j = Ip[i], end = Ip[i+1]; j < end; j++)
+            {
+               const double aij = Ap[j];
+               const double *xj = x0 + Jp[j];
+               d[0] += aij * xj[0];
+               d[1] += aij * xj[width];
+               d[2] += aij * xj[2*width];
+               d[3] += aij * xj[3*width];
+            }
+         }
+         else
+         {
+            for (int j = Ip[i], end = Ip[i+1]; j < end; j++)
+            {
+               const double aij = Ap[j];
+               const double *xj = x0 + Jp[j];
+               for (int k = 0; k < nb; k++)
+               {
+                  d[k] += aij * xj[k*width];
+               }
+            }
+         }
+         for (int k = 0; k < nb; k++)
+         {
+            y0[i + k*height] += a * d[k];
+         }
+      }
+   }
+}
+
 void SparseMatrix::MultTranspose(const Vector &x, Vector &y) const
 {
    y = 0.0;
@@ -1504,6 +1603,43 @@ void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
    }
 }
 
+void SparseMatrix::AddSubMatrixSorted(const Array<int> &rows,
+                                      const Array<int> &cols,
+                                      const DenseMatrix &subm)
+{
+   MFEM_VERIFY(Finalized() && isSorted,
+               "the matrix must be finalized with sorted column indices");
+
+   for (int i = 0; i < rows.Size(); i++)
+   {
+      int gi, s;
+      if ((gi=rows[i]) < 0) { gi = -1-gi, s = -1; }
+      else { s = 1; }
+      MFEM_ASSERT(gi < height,
+                  "Trying to insert a row " << gi << " outside the matrix height "
+                  << height);
+      const int *Jr = J + I[gi];
+      double *Ar = A + I[gi];
+      const int nr = I[gi+1] - I[gi];
+      for (int j = 0; j < cols.Size(); j++)
+      {
+         int gj, t;
+         if ((gj=cols[j]) < 0) { gj = -1-gj, t = -s; }
+         else { t = s; }
+         int lo = 0, hi = nr;
+         while (lo < hi)
+         {
+            const int mid = (lo + hi)/2;
+            if (Jr[mid] < gj) { lo = mid + 1; }
+            else { hi = mid; }
+         }
+         MFEM_VERIFY(lo < nr && Jr[lo] == gj,
+                     "Entry (" << gi << "," << gj << ") is not allocated.");
+         Ar[lo] += (t < 0) ? -subm(i, j) : subm(i, j);
+      }
+   }
+}
+
 void SparseMatrix::Set(const int i, const int j, const double A)
 {
    double a = A;
@@ -148,6 +148,15 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** Multiply the matrix with all columns of X, Y = A * X. The columns are
+       processed in groups of up to 4, so that each entry of A is loaded once
+       per group and applied to all of its columns. */
+   void Mult(const DenseMatrix &X, DenseMatrix &Y) const;
+
+   /// Y += a * A * X, for all columns of the DenseMatrix X.
+   void AddMult(const DenseMatrix &X, DenseMatrix &Y,
+                const double a = 1.0) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -254,6 +263,14 @@ public:
    void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
                      const DenseMatrix &subm, int skip_zeros = 1);
 
+   /** Add the dense matrix 'subm' to a finalized matrix with sorted column
+       indices (see SortColumnIndices()), whose sparsity pattern must already
+       contain all the entries. The entries are located by binary search
+       without using the internal column pointer scratch, so threads may call
+       this method concurrently as long as their 'rows' do not overlap. */
+   void AddSubMatrixSorted(const Array<int> &rows, const Array<int> &cols,
+                           const DenseMatrix &subm);
+
    bool RowIsEmpty(const int row) const;
 
    /** Extract all column indices and values from a given row.
@@ -12,6 +12,7 @@
 // Implementation of data types for sparse matrix smoothers
 
 #include <iostream>
+#include <cmath>
 #include "vector.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
@@ -43,6 +44,320 @@ void GSSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+/* Group the rows by the given index: the rows of group g are
+   rows[ptr[g]], ..., rows[ptr[g+1]-1], in increasing order. */
+static void GroupRows(const Array<int> &group, int ng, Array<int> &ptr,
+                      Array<int> &rows)
+{
+   ptr.SetSize(ng+1);
+   ptr = 0;
+   for (int i = 0; i < group.Size(); i++)
+      ptr[group[i]+1]++;
+   for (int g = 0; g < ng; g++)
+      ptr[g+1] += ptr[g];
+   rows.SetSize(group.Size());
+   for (int i = 0; i < group.Size(); i++)
+      rows[ptr[group[i]]++] = i;
+   for (int g = ng; g > 0; g--)
+      ptr[g] = ptr[g-1];
+   ptr[0] = 0;
+}
+
+MulticolorGSSmoother::MulticolorGSSmoother(const SparseMatrix &a, int t,
+                                           int it)
+{
+   type = t;
+   iterations = it;
+   SetOperator(a);
+}
+
+void MulticolorGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized() && height == width,
+               "MulticolorGSSmoother : not a finalized square matrix!");
+
+   const int n = height;
+   const int *I = oper->GetI(), *J = oper->GetJ();
+   const double *A = oper->GetData();
+   SparseMatrix *At = Transpose(*oper);
+   const int *It = At->GetI(), *Jt = At->GetJ();
+
+   // greedy coloring of the graph of A + A^T
+   Array<int> color(n), mark(n+1);
+   color = -1;
+   mark = -1;
+   int nc = 0;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+         if (color[J[k]] >= 0)
+            mark[color[J[k]]] = i;
+      for (int k = It[i]; k < It[i+1]; k++)
+         if (color[Jt[k]] >= 0)
+            mark[color[Jt[k]]] = i;
+      int c = 0;
+      while (c < nc && mark[c] == i)
+         c++;
+      color[i] = c;
+      if (c == nc)
+         nc++;
+   }
+   delete At;
+
+   GroupRows(color, nc, color_ptr, color_rows);
+
+   dinv.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      double d = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++)
+         if (J[k] == i)
+            d = A[k];
+      MFEM_VERIFY(d != 0.0, "MulticolorGSSmoother : zero diagonal in row "
+                  << i);
+      dinv(i) = 1.0/d;
+   }
+}
+
+void MulticolorGSSmoother::Sweep(int c, const Vector &x, Vector &y) const
+{
+   const int *I = oper->GetI(), *J = oper->GetJ(), *rows = color_rows;
+   const double *A = oper->GetData(), *xp = x, *dp = dinv;
+   double *yp = y;
+
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+   for (int k = color_ptr[c]; k < color_ptr[c+1]; k++)
+   {
+      const int i = rows[k];
+      double sum = xp[i];
+      for (int j = I[i]; j < I[i+1]; j++)
+         sum -= A[j]*yp[J[j]];
+      yp[i] += dp[i]*sum;
+   }
+}
+
+void MulticolorGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   const int nc = GetNumColors();
+
+   if (!iterative_mode)
+      y = 0.0;
+   for (int it = 0; it < iterations; it++)
+   {
+      if (type != 2)
+         for (int c = 0; c < nc; c++)
+            Sweep(c, x, y);
+      if (type != 1)
+         for (int c = nc-1; c >= 0; c--)
+            Sweep(c, x, y);
+   }
+}
+
+ILUSmoother::ILUSmoother(const SparseMatrix &a, int k)
+{
+   fill_level = k;
+   SetOperator(a);
+}
+
+void ILUSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized() && height == width,
+               "ILUSmoother : not a finalized square matrix!");
+
+   Factor();
+
+   // level scheduling: a row of L (U) is in the level following the levels
+   // of the rows it depends on
+   const int n = height;
+   Array<int> level(n);
+   int nl = 0;
+   for (int i = 0; i < n; i++)
+   {
+      int lv = 0;
+      for (int k = IL[i]; k < IL[i+1]; k++)
+         if (level[JL[k]] + 1 > lv)
+            lv = level[JL[k]] + 1;
+      level[i] = lv;
+      if (lv + 1 > nl)
+         nl = lv + 1;
+   }
+   GroupRows(level, nl, lev_ptr_L, lev_rows_L);
+
+   nl = 0;
+   for (int i = n-1; i >= 0; i--)
+   {
+      int lv = 0;
+      for (int k = IU[i]; k < IU[i+1]; k++)
+         if (level[JU[k]] + 1 > lv)
+            lv = level[JU[k]] + 1;
+      level[i] = lv;
+      if (lv + 1 > nl)
+         nl = lv + 1;
+   }
+   GroupRows(level, nl, lev_ptr_U, lev_rows_U);
+
+   r.SetSize(n);
+   z.SetSize(n);
+}
+
+/* Row-wise (IKJ) ILU(k). The strictly lower part of the current row is kept
+   in a sorted linked list, so that the rows of U are applied in increasing
+   order; the level of a fill-in entry (i,j) from row k is
+   lev(i,k) + lev(k,j) + 1 and only entries with level <= k are kept. */
+void ILUSmoother::Factor()
+{
+   const int n = height;
+   const int *I = oper->GetI(), *J = oper->GetJ();
+   const double *A = oper->GetData();
+
+   Array<int> lev(n), next(n), upper, ULev;
+   Vector w(n);
+   lev = -1;
+
+   IL.SetSize(n+1);
+   IU.SetSize(n+1);
+   IL[0] = IU[0] = 0;
+   JL.SetSize(0);
+   VL.SetSize(0);
+   JU.SetSize(0);
+   VU.SetSize(0);
+   udinv.SetSize(n);
+
+   for (int i = 0; i < n; i++)
+   {
+      int head = -1;
+      upper.SetSize(0);
+      w(i) = 0.0;
+      lev[i] = 0;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         w(j) = A[k];
+         lev[j] = 0;
+         if (j < i)
+         {
+            int *pos = &head;
+            while (*pos >= 0 && *pos < j)
+               pos = &next[*pos];
+            next[j] = *pos;
+            *pos = j;
+         }
+         else if (j > i)
+            upper.Append(j);
+      }
+
+      for (int k = head; k >= 0; k = next[k])
+      {
+         const double lik = (w(k) *= udinv(k));
+         for (int q = IU[k]; q < IU[k+1]; q++)
+         {
+            const int j = JU[q], newlev = lev[k] + ULev[q] + 1;
+            if (lev[j] < 0)
+            {
+               if (newlev > fill_level)
+                  continue;
+               // fill-in entry
+               lev[j] = newlev;
+               w(j) = 0.0;
+               if (j < i)
+               {
+                  int *pos = &next[k];
+                  while (*pos >= 0 && *pos < j)
+                     pos = &next[*pos];
+                  next[j] = *pos;
+                  *pos = j;
+               }
+               else
+                  upper.Append(j);
+            }
+            else if (newlev < lev[j])
+               lev[j] = newlev;
+            w(j) -= lik*VU[q];
+         }
+      }
+
+      for (int k = head; k >= 0; k = next[k])
+      {
+         JL.Append(k);
+         VL.Append(w(k));
+         lev[k] = -1;
+      }
+      IL[i+1] = JL.Size();
+
+      MFEM_VERIFY(w(i) != 0.0, "ILUSmoother : zero pivot in row " << i);
+      udinv(i) = 1.0/w(i);
+      lev[i] = -1;
+
+      for (int k = 0; k < upper.Size(); k++)
+      {
+         const int j = upper[k];
+         JU.Append(j);
+         VU.Append(w(j));
+         ULev.Append(lev[j]);
+         lev[j] = -1;
+      }
+      IU[i+1] = JU.Size();
+   }
+}
+
+// y = U^{-1} L^{-1} x; x and y can be the same vector
+void ILUSmoother::Solve(const Vector &x, Vector &y) const
+{
+   const double *xp = x, *vl = VL, *vu = VU, *dp = udinv;
+   const int *il = IL, *jl = JL, *iu = IU, *ju = JU;
+   double *yp = y, *zp = z;
+
+   for (int l = 0; l < lev_ptr_L.Size()-1; l++)
+   {
+      const int *rows = lev_rows_L;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+      for (int k = lev_ptr_L[l]; k < lev_ptr_L[l+1]; k++)
+      {
+         const int i = rows[k];
+         double sum = xp[i];
+         for (int q = il[i]; q < il[i+1]; q++)
+            sum -= vl[q]*zp[jl[q]];
+         zp[i] = sum;
+      }
+   }
+
+   for (int l = 0; l < lev_ptr_U.Size()-1; l++)
+   {
+      const int *rows = lev_rows_U;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+      for (int k = lev_ptr_U[l]; k < lev_ptr_U[l+1]; k++)
+      {
+         const int i = rows[k];
+         double sum = zp[i];
+         for (int q = iu[i]; q < iu[i+1]; q++)
+            sum -= vu[q]*yp[ju[q]];
+         yp[i] = dp[i]*sum;
+      }
+   }
+}
+
+void ILUSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      Solve(x, y);
+      return;
+   }
+
+   oper->Mult(y, r);
+   subtract(x, r, r);
+   Solve(r, r);
+   y += r;
+}
+
 /// Create the Jacobi smoother.
 DSmoother::DSmoother(const SparseMatrix &a, int t, double s, int it)
    : SparseSmoother(a)
@@ -86,4 +401,187 @@ void DSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+/* Largest eigenvalue of the symmetric tridiagonal matrix with diagonal a and
+   off-diagonal b (b[i] = T(i,i+1)), computed by bisection with the Sturm
+   sequence counts. */
+static double TridiagMaxEig(const Array<double> &a, const Array<double> &b)
+{
+   const int k = a.Size();
+   double lo = a[0], hi = a[0];
+   for (int i = 0; i < k; i++)
+   {
+      double rad = 0.0;
+      if (i > 0)
+         rad += fabs(b[i-1]);
+      if (i < k-1)
+         rad += fabs(b[i]);
+      if (a[i] - rad < lo)
+         lo = a[i] - rad;
+      if (a[i] + rad > hi)
+         hi = a[i] + rad;
+   }
+
+   for (int it = 0; it < 100 && hi - lo > 1e-12*fabs(hi); it++)
+   {
+      const double mid = 0.5*(lo + hi);
+      // number of eigenvalues smaller than mid
+      int count = 0;
+      double q = 1.0;
+      for (int i = 0; i < k; i++)
+      {
+         q = a[i] - mid - ((i > 0) ? b[i-1]*b[i-1]/q : 0.0);
+         if (q == 0.0)
+            q = 1e-300;
+         if (q < 0.0)
+            count++;
+      }
+      if (count == k)
+         hi = mid;
+      else
+         lo = mid;
+   }
+   return hi;
+}
+
+double EstimateMaxEigenvalue(const Operator &A, const Vector &dinv,
+                             int iter, int seed)
+{
+   const int n = A.Height();
+   Vector r(n), z(n), p(n), q(n);
+   Array<double> a, b;
+
+   // The Lanczos tridiagonal matrix of D^{-1/2} A D^{-1/2} is obtained from
+   // the coefficients of the preconditioned CG method.
+   r.Randomize(seed);
+   for (int i = 0; i < n; i++)
+      z(i) = dinv(i)*r(i);
+   p = z;
+   double rz = r*z, alpha_old = 0.0, beta_old = 0.0;
+   for (int k = 0; k < iter && rz > 0.0; k++)
+   {
+      A.Mult(p, q);
+      const double pq = p*q;
+      if (pq <= 0.0)
+         break;
+      const double alpha = rz/pq;
+      a.Append(1.0/alpha + ((k > 0) ? beta_old/alpha_old : 0.0));
+
+      add(r, -alpha, q, r);
+      for (int i = 0; i < n; i++)
+         z(i) = dinv(i)*r(i);
+      const double rz_new = r*z;
+      const double beta = rz_new/rz;
+      if (k+1 < iter && rz_new > 0.0)
+         b.Append(sqrt(beta)/alpha);
+      add(z, beta, p, p);
+
+      rz = rz_new;
+      alpha_old = alpha;
+      beta_old = beta;
+   }
+
+   return (a.Size() > 0) ? TridiagMaxEig(a, b) : 0.0;
+}
+
+ChebyshevSmoother::ChebyshevSmoother(const SparseMatrix &a, int ord,
+                                     double frac)
+{
+   order = ord;
+   fraction = frac;
+   SetOperator(a);
+}
+
+ChebyshevSmoother::ChebyshevSmoother(const Operator &a, const Vector &diag,
+                                     int ord, double frac)
+{
+   order = ord;
+   fraction = frac;
+   SetOperator(a, diag);
+}
+
+void ChebyshevSmoother::SetOperator(const Operator &a)
+{
+   const SparseMatrix *mat = dynamic_cast<const SparseMatrix*>(&a);
+   if (mat)
+   {
+      Vector diag;
+      mat->GetDiag(diag);
+      SetOperator(a, diag);
+      return;
+   }
+   MFEM_VERIFY(a.Height() == dinv.Size(), "ChebyshevSmoother::SetOperator :"
+               " the diagonal of a matrix-free operator must be given!");
+   oper = &a;
+   Setup();
+}
+
+void ChebyshevSmoother::SetOperator(const Operator &a, const Vector &diag)
+{
+   MFEM_VERIFY(a.Height() == a.Width() && diag.Size() == a.Height(),
+               "ChebyshevSmoother::SetOperator : size mismatch!");
+   oper = &a;
+   dinv.SetSize(diag.Size());
+   for (int i = 0; i < diag.Size(); i++)
+      dinv(i) = (diag(i) != 0.0) ? 1.0/diag(i) : 0.0;
+   Setup();
+}
+
+/* The Lanczos estimate is a lower bound of the largest eigenvalue; the
+   smoothing interval ends 10% above it. */
+void ChebyshevSmoother::Setup()
+{
+   height = width = oper->Height();
+   r.SetSize(height);
+   d.SetSize(height);
+   max_eig = EstimateMaxEigenvalue(*oper, dinv);
+}
+
+void ChebyshevSmoother::Mult(const Vector &x, Vector &y) const
+{
+   const double upper = 1.1*max_eig, lower = fraction*upper;
+   const double theta = 0.5*(upper + lower), delta = 0.5*(upper - lower);
+   const double sigma = theta/delta;
+   double rho = 1.0/sigma;
+
+   const int n = height;
+   const double *dl = dinv.GetData(), *xp = x.GetData(), *rp = r.GetData();
+   double *yp = y.GetData(), *dp = d.GetData();
+
+   if (!iterative_mode)
+      y = 0.0;
+
+   for (int k = 0; k < order; k++)
+   {
+      if (k > 0 || iterative_mode)
+         oper->Mult(y, r);
+      else
+         r = 0.0;
+      if (k == 0)
+      {
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+         for (int i = 0; i < n; i++)
+         {
+            dp[i] = dl[i]*(xp[i] - rp[i])/theta;
+            yp[i] += dp[i];
+         }
+      }
+      else
+      {
+         const double rho_new = 1.0/(2.0*sigma - rho);
+         const double c1 = rho_new*rho, c2 = 2.0*rho_new/delta;
+         rho = rho_new;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+         for (int i = 0; i < n; i++)
+         {
+            dp[i] = c1*dp[i] + c2*dl[i]*(xp[i] - rp[i]);
+            yp[i] += dp[i];
+         }
+      }
+   }
+}
+
 }
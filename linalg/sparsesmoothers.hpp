@@ -51,6 +51,74 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** Multicolor Gauss-Seidel smoother: the rows of the matrix are colored
+    (greedily, from the graph of A + A^T) so that rows of the same color are
+    not coupled, and the Gauss-Seidel sweep visits the colors in order,
+    updating the rows of each color in parallel (with OpenMP). The diagonal of
+    the matrix must be nonzero. */
+class MulticolorGSSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+   Array<int> color_ptr, color_rows; // rows of color c: color_ptr[c..c+1]
+   Vector dinv;
+
+   void Sweep(int c, const Vector &x, Vector &y) const;
+
+public:
+   MulticolorGSSmoother(int t = 0, int it = 1) { type = t; iterations = it; }
+
+   MulticolorGSSmoother(const SparseMatrix &a, int t = 0, int it = 1);
+
+   int GetNumColors() const { return color_ptr.Size()-1; }
+
+   /// Set the matrix and compute the coloring
+   virtual void SetOperator(const Operator &a);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/** Incomplete LU factorization with level of fill k, ILU(k), of a sparse
+    matrix; k = 0 gives ILU(0), with the sparsity of the matrix. The
+    factorization is computed in SetOperator(). Each application solves with
+    the factors L and U; the rows of the triangular solves are grouped into
+    levels of independent rows (level scheduling) which are processed in
+    parallel (with OpenMP). With iterative_mode set, the solve is applied to
+    the residual and added to y. */
+class ILUSmoother : public SparseSmoother
+{
+protected:
+   int fill_level;
+
+   // strictly lower part of L (unit diagonal) and strictly upper part of U
+   Array<int> IL, JL, IU, JU;
+   Array<double> VL, VU;
+   Vector udinv; // inverse of the diagonal of U
+
+   // the rows of the forward and backward solves, grouped by levels
+   Array<int> lev_ptr_L, lev_rows_L, lev_ptr_U, lev_rows_U;
+
+   mutable Vector r, z;
+
+   void Factor();
+   void Solve(const Vector &x, Vector &y) const;
+
+public:
+   ILUSmoother(int k = 0) { fill_level = k; }
+
+   ILUSmoother(const SparseMatrix &a, int k = 0);
+
+   /// Number of nonzeros in L and U
+   int NumNonZeroElems() const { return JL.Size() + JU.Size() + height; }
+
+   /// Set the matrix and compute the factorization
+   virtual void SetOperator(const Operator &a);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 /// Data type for scaled Jacobi-type smoother of sparse matrix
 class DSmoother : public SparseSmoother
 {
@@ -73,6 +141,59 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** Estimate the largest eigenvalue of diag(dinv) A, for a symmetric positive
+    definite operator A and a positive vector dinv (typically the inverse of
+    the diagonal of A), with 'iter' steps of the Lanczos method. Only A.Mult()
+    is used. The estimate is a lower bound that converges quickly to the
+    largest eigenvalue. */
+double EstimateMaxEigenvalue(const Operator &A, const Vector &dinv,
+                             int iter = 10, int seed = 1);
+
+/** Chebyshev polynomial smoother for a symmetric positive definite operator
+    A: 'order' steps of the Chebyshev iteration for D^{-1} A on the interval
+    [fraction*upper, upper], where D is the diagonal of A and upper is 1.1
+    times the estimate of the largest eigenvalue of D^{-1} A given by
+    EstimateMaxEigenvalue() (a lower bound). Only the action of A and
+    its diagonal are needed, so A can be matrix-free. The smoother is
+    symmetric and can be used in (multigrid) preconditioners for CGSolver.
+    Unknowns with zero diagonal are not changed. */
+class ChebyshevSmoother : public Solver
+{
+protected:
+   const Operator *oper;
+   Vector dinv;
+   int order;
+   double fraction, max_eig;
+
+   mutable Vector r, d;
+
+   void Setup();
+
+public:
+   ChebyshevSmoother(int ord = 2, double frac = 0.3)
+   { oper = NULL; order = ord; fraction = frac; max_eig = 0.0; }
+
+   /// Smoother for a SparseMatrix; the diagonal is extracted from the matrix
+   ChebyshevSmoother(const SparseMatrix &a, int ord = 2, double frac = 0.3);
+
+   /// Smoother for a (matrix-free) operator with the given diagonal
+   ChebyshevSmoother(const Operator &a, const Vector &diag, int ord = 2,
+                     double frac = 0.3);
+
+   /// The estimate of the largest eigenvalue of D^{-1} A, see Setup()
+   double GetMaxEigenvalue() const { return max_eig; }
+
+   /** Set the operator, which must be a SparseMatrix unless it has the same
+       size as the previous one, in which case its diagonal is kept. */
+   virtual void SetOperator(const Operator &a);
+
+   /// Set a (matrix-free) operator with the given diagonal
+   void SetOperator(const Operator &a, const Vector &diag);
+
+   /// Apply the smoother to A y = x
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 }
 
 #endif
@@ -64,6 +64,14 @@ void Vector::Load(std::istream &in, int Size)
       in >> data[i];
 }
 
+void Vector::LoadBinary(std::istream &in, int Size)
+{
+   SetSize(Size);
+
+   in.read(reinterpret_cast<char *>(data), std::streamsize(size)*sizeof(double));
+   MFEM_VERIFY(in, "error reading " << size << " binary values");
+}
+
 double &Vector::Elem(int i)
 {
    return operator()(i);
@@ -179,6 +187,49 @@ Vector &Vector::Add(const double a, const Vector &Va)
    return *this;
 }
 
+double Vector::AddAndDot(const double a, const Vector &x, const Vector &y)
+{
+#ifdef MFEM_DEBUG
+   if (size != x.size || size != y.size)
+      mfem_error("Vector::AddAndDot(const double, const Vector &, "
+                 "const Vector &)");
+#endif
+   const double *xp = x.data, *yp = y.data;
+   double *dp = data, prod = 0.0;
+   int s = size;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for reduction(+:prod)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      dp[i] += a * xp[i];
+      prod += dp[i] * yp[i];
+   }
+   return prod;
+}
+
+double Vector::SetAndDot(const double a, const Vector &x, const double b,
+                         const Vector &y, const Vector &z)
+{
+#ifdef MFEM_DEBUG
+   if (size != x.size || size != y.size || size != z.size)
+      mfem_error("Vector::SetAndDot(const double, const Vector &, "
+                 "const double, const Vector &, const Vector &)");
+#endif
+   const double *xp = x.data, *yp = y.data, *zp = z.data;
+   double *dp = data, prod = 0.0;
+   int s = size;
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for reduction(+:prod)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      dp[i] = a * xp[i] + b * yp[i];
+      prod += dp[i] * zp[i];
+   }
+   return prod;
+}
+
 Vector &Vector::Set(const double a, const Vector &Va)
 {
 #ifdef MFEM_DEBUG
@@ -338,6 +389,28 @@ void add(const double a, const Vector &x,
    }
 }
 
+void add(const double a, const Vector &x, const double b, const Vector &y,
+         const double c, const Vector &z, Vector &w)
+{
+#ifdef MFEM_DEBUG
+   if (x.size != y.size || x.size != z.size || x.size != w.size)
+      mfem_error("add(const double a, const Vector &x, const double b,\n"
+                 "    const Vector &y, const double c, const Vector &z,"
+                 " Vector &w)");
+#endif
+   const double *xp = x.data;
+   const double *yp = y.data;
+   const double *zp = z.data;
+   double       *wp = w.data;
+   int            s = x.size;
+
+#ifdef MFEM_USE_OPENMP
+#pragma omp parallel for
+#endif
+   for (int i = 0; i < s; i++)
+      wp[i] = a * xp[i] + b * yp[i] + c * zp[i];
+}
+
 void subtract(const Vector &x, const Vector &y, Vector &z)
 {
 #ifdef MFEM_DEBUG
@@ -514,6 +587,12 @@ void Vector::Print_HYPRE(std::ostream &out) const
    out.flags(old_fmt);
 }
 
+void Vector::PrintBinary(std::ostream &out) const
+{
+   out.write(reinterpret_cast<const char *>(data),
+             std::streamsize(size)*sizeof(double));
+}
+
 void Vector::Randomize(int seed)
 {
    // static unsigned int seed = time(0);
@@ -60,6 +60,9 @@ public:
    /// Load a vector from an input stream.
    void Load(std::istream &in) { int s; in >> s; Load (in, s); }
 
+   /// Load a vector of the given size stored as raw doubles (see PrintBinary).
+   void LoadBinary(std::istream &in, int Size);
+
    /// Resizes the vector if the new size is different
    void SetSize(int s);
 
@@ -134,6 +137,16 @@ public:
    /// (*this) += a * Va
    Vector & Add(const double a, const Vector &Va);
 
+   /** (*this) += a * x and return the local inner product ((*this), y),
+       computed in the same pass over the data; y may be (*this). */
+   double AddAndDot(const double a, const Vector &x, const Vector &y);
+
+   /** (*this) = a * x + b * y and return the local inner product ((*this), z),
+       computed in the same pass over the data; any of x, y and z may be
+       (*this). */
+   double SetAndDot(const double a, const Vector &x, const double b,
+                    const Vector &y, const Vector &z);
+
    /// (*this) = a * x
    Vector & Set(const double a, const Vector &x);
 
@@ -158,6 +171,12 @@ public:
    friend void add (const double a, const Vector &x,
                     const double b, const Vector &y, Vector &z);
 
+   /** w = a * x + b * y + c * z, in a single pass; w may be the same
+       vector as any of x, y and z. */
+   friend void add(const double a, const Vector &x, const double b,
+                   const Vector &y, const double c, const Vector &z,
+                   Vector &w);
+
    /// Do v = v1 - v2.
    friend void subtract(const Vector &v1, const Vector &v2, Vector &v);
 
@@ -186,6 +205,10 @@ public:
    /// Prints vector to stream out in HYPRE_Vector format.
    void Print_HYPRE(std::ostream &out) const;
 
+   /** Write the entries of the vector to the stream as raw doubles in the
+       native byte order, without the size. */
+   void PrintBinary(std::ostream &out) const;
+
    /// Set random values in the vector.
    void Randomize(int seed = 0);
    /// Returns the l2 norm of the vector.
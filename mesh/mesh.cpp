@@ -1730,6 +1730,84 @@ void Mesh::PrintElement(const Element *el, std::ostream &out)
    PrintElementWithoutAttr(el, out);
 }
 
+// Read n integers stored with 'isize' bytes each.
+static void ReadBinaryInts(std::istream &input, int isize, int n, int *data)
+{
+   if (isize == (int) sizeof(int))
+   {
+      input.read(reinterpret_cast<char *>(data), streamsize(n)*sizeof(int));
+   }
+   else
+   {
+      const int bs = 1024;
+      long long buf[bs];
+      for (int i = 0; i < n && input; i += bs)
+      {
+         const int m = std::min(bs, n - i);
+         input.read(reinterpret_cast<char *>(buf), m*sizeof(long long));
+         for (int k = 0; k < m; k++)
+         {
+            MFEM_VERIFY(buf[k] == (int) buf[k], "index " << buf[k]
+                        << " does not fit in int");
+            data[i+k] = (int) buf[k];
+         }
+      }
+   }
+   MFEM_VERIFY(input, "error reading binary mesh data");
+}
+
+void Mesh::ReadBinaryElements(std::istream &input, int isize, int n,
+                              Array<Element *> &els)
+{
+   Array<int> attr(n), geom(n), v;
+   ReadBinaryInts(input, isize, n, attr);
+   ReadBinaryInts(input, isize, n, geom);
+
+   els.SetSize(n);
+   int nv = 0;
+   for (int i = 0; i < n; i++)
+   {
+      els[i] = NewElement(geom[i]);
+      MFEM_VERIFY(els[i], "invalid element geometry: " << geom[i]);
+      els[i]->SetAttribute(attr[i]);
+      nv += els[i]->GetNVertices();
+   }
+
+   v.SetSize(nv);
+   ReadBinaryInts(input, isize, nv, v);
+   for (int i = 0, k = 0; i < n; i++)
+   {
+      els[i]->SetVertices(v.GetData() + k);
+      k += els[i]->GetNVertices();
+   }
+}
+
+void Mesh::PrintBinaryElements(const Array<Element *> &els, int n,
+                               std::ostream &out)
+{
+   Array<int> attr(n), geom(n), v;
+   int nv = 0;
+   for (int i = 0; i < n; i++)
+   {
+      attr[i] = els[i]->GetAttribute();
+      geom[i] = els[i]->GetGeometryType();
+      nv += els[i]->GetNVertices();
+   }
+   v.SetSize(nv);
+   for (int i = 0, k = 0; i < n; i++)
+   {
+      const int *ev = els[i]->GetVertices();
+      for (int j = 0; j < els[i]->GetNVertices(); j++)
+      {
+         v[k++] = ev[j];
+      }
+   }
+   out.write(reinterpret_cast<const char *>(attr.GetData()), n*sizeof(int));
+   out.write(reinterpret_cast<const char *>(geom.GetData()), n*sizeof(int));
+   out.write(reinterpret_cast<const char *>(v.GetData()),
+             streamsize(nv)*sizeof(int));
+}
+
 void Mesh::SetMeshGen()
 {
    meshgen = 0;
@@ -1779,6 +1857,8 @@ void Mesh::Load(std::istream &input, int generate_edges, int refine,
    if (!input)
       MFEM_ABORT("Input stream is not open");
 
+   DeleteGeometricFactors();
+
    if (NumOfVertices != -1)
    {
       // Delete the elements.
@@ -1868,6 +1948,36 @@ void Mesh::Load(std::istream &input, int generate_edges, int refine,
          curved = 1;
       }
    }
+   else if (mesh_type == "MFEM binary mesh v1.0")
+   {
+      // Read MFEM binary mesh v1.0 format, see PrintBinary()
+      int header[6];
+      input.read(reinterpret_cast<char *>(header), sizeof(header));
+      MFEM_VERIFY(input && header[0] == 1,
+                  "invalid binary mesh header or byte order mismatch");
+      const int isize = header[1];
+      MFEM_VERIFY(isize == 4 || isize == 8, "invalid index size: " << isize);
+      Dim = header[2];
+      spaceDim = header[3];
+      curved = header[4];
+
+      ReadBinaryInts(input, isize, 1, &NumOfElements);
+      ReadBinaryInts(input, isize, 1, &NumOfBdrElements);
+      ReadBinaryInts(input, isize, 1, &NumOfVertices);
+
+      ReadBinaryElements(input, isize, NumOfElements, elements);
+      ReadBinaryElements(input, isize, NumOfBdrElements, boundary);
+
+      vertices.SetSize(NumOfVertices);
+      if (!curved)
+      {
+         Vector coords;
+         coords.LoadBinary(input, NumOfVertices*spaceDim);
+         for (j = 0; j < NumOfVertices; j++)
+            for (i = 0; i < spaceDim; i++)
+               vertices[j](i) = coords(j*spaceDim + i);
+      }
+   }
    else if (mesh_type == "linemesh")
    {
       int j,p1,p2,a;
@@ -2895,6 +3005,8 @@ void Mesh::DegreeElevate(int t)
 
 void Mesh::UpdateNURBS()
 {
+   DeleteGeometricFactors();
+
    NURBSext->SetKnotsFromPatches();
 
    Dim = NURBSext->Dimension();
@@ -4122,6 +4234,9 @@ void Mesh::ReorientTetMesh()
    if (Dim != 3 || !(meshgen & 1))
       return;
 
+   // the element Jacobians change with the vertex order
+   DeleteGeometricFactors();
+
    DSTable *old_v_to_v = NULL;
    Table *old_elem_vert = NULL;
 
@@ -4888,6 +5003,7 @@ void Mesh::MoveVertices(const Vector &displacements)
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
          vertices[i](j) += displacements(j*nv+i);
+   NodesUpdated();
 }
 
 void Mesh::GetVertices(Vector &vert_coord) const
@@ -4904,6 +5020,7 @@ void Mesh::SetVertices(const Vector &vert_coord)
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
          vertices[i](j) = vert_coord(j*nv+i);
+   NodesUpdated();
 }
 
 void Mesh::GetNode(int i, double *coord)
@@ -4935,12 +5052,16 @@ void Mesh::SetNode(int i, const double *coord)
          vertices[i](j) = coord[j];
 
    }
+   NodesUpdated();
 }
 
 void Mesh::MoveNodes(const Vector &displacements)
 {
    if (Nodes)
+   {
       (*Nodes) += displacements;
+      NodesUpdated();
+   }
    else
       MoveVertices(displacements);
 }
@@ -4956,7 +5077,10 @@ void Mesh::GetNodes(Vector &node_coord) const
 void Mesh::SetNodes(const Vector &node_coord)
 {
    if (Nodes)
+   {
       (*Nodes) = node_coord;
+      NodesUpdated();
+   }
    else
       SetVertices(node_coord);
 }
@@ -4973,18 +5097,217 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
       delete NURBSext;
       NURBSext = nodes.FESpace()->StealNURBSext();
    }
+   NodesUpdated();
 }
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
+   NodesUpdated();
    // TODO:
    // if (nodes)
    //    nodes->FESpace()->MakeNURBSextOwner();
    // NURBSext = (Nodes) ? Nodes->FESpace()->StealNURBSext() : NULL;
 }
 
+GeometricFactors::GeometricFactors(Mesh &mesh, const IntegrationRule &ir,
+                                   int flags)
+{
+   IntRule = &ir;
+   computed = 0;
+   NE = mesh.GetNE();
+   NQ = ir.GetNPoints();
+   dim = mesh.Dimension();
+   sdim = mesh.SpaceDimension();
+
+   ir_data.SetSize(4*NQ);
+   for (int q = 0; q < NQ; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      ir_data(4*q+0) = ip.x;
+      ir_data(4*q+1) = ip.y;
+      ir_data(4*q+2) = ip.z;
+      ir_data(4*q+3) = ip.weight;
+   }
+
+   Compute(mesh, flags);
+}
+
+bool GeometricFactors::SameRule(const IntegrationRule &ir) const
+{
+   if (ir.GetNPoints() != NQ)
+      return false;
+   for (int q = 0; q < NQ; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      if (ir_data(4*q+0) != ip.x || ir_data(4*q+1) != ip.y ||
+          ir_data(4*q+2) != ip.z || ir_data(4*q+3) != ip.weight)
+         return false;
+   }
+   return true;
+}
+
+void GeometricFactors::Compute(Mesh &mesh, int flags)
+{
+   flags &= ~computed;
+   if (flags == 0)
+      return;
+   const IntegrationRule &ir = *IntRule;
+
+   const int sd = sdim*dim;
+   if (flags & COORDINATES)
+      X.SetSize(NE*NQ*sdim);
+   if (flags & JACOBIANS)
+      J.SetSize(NE*NQ*sd);
+   if (flags & INVERSE_JACOBIANS)
+      InvJ.SetSize(NE*NQ*sd);
+   if (flags & DETERMINANTS)
+      detJ.SetSize(NE*NQ);
+
+   // The data is computed from the shape functions of the transformation
+   // (nodal) FE and their reference gradients at the points, see DofToQuad.
+   // NURBS elements have no such tables and use the ElementTransformation.
+   GridFunction *nodes = mesh.GetNodes();
+   IsoparametricTransformation T;
+   DenseMatrix Jq(sdim, dim), InvJq;
+   Vector xq;
+   const FiniteElement *fe_prev = NULL;
+   const DofToQuad *maps = NULL;
+   for (int e = 0; e < NE; e++)
+   {
+      const FiniteElement *fe = nodes ? nodes->FESpace()->GetFE(e) :
+         Mesh::GetTransformationFEforElementType(mesh.GetElementType(e));
+      if (fe != fe_prev)
+      {
+         maps = fe->GetFullDofToQuad(ir);
+         fe_prev = fe;
+      }
+      mesh.GetElementTransformation(e, &T);
+      const DenseMatrix &pm = T.GetPointMat();
+      const int nd = pm.Width();
+
+      for (int q = 0; q < NQ; q++)
+      {
+         const int eq = e*NQ + q;
+         if (!maps)
+         {
+            const IntegrationPoint &ip = ir.IntPoint(q);
+            if (flags & COORDINATES)
+            {
+               xq.SetDataAndSize(X.GetData() + eq*sdim, sdim);
+               T.Transform(ip, xq);
+            }
+            T.SetIntPoint(&ip);
+            Jq = T.Jacobian();
+         }
+         else
+         {
+            if (flags & COORDINATES)
+            {
+               double *x = X.GetData() + eq*sdim;
+               for (int k = 0; k < sdim; k++)
+               {
+                  x[k] = 0.0;
+                  for (int j = 0; j < nd; j++)
+                     x[k] += pm(k,j)*maps->B(q,j);
+               }
+            }
+            if (flags == COORDINATES)
+               continue;
+
+            // Jq = pm G_q, where G_q is the nd x dim matrix of gradients
+            const double *Gq = maps->G.GetData(q);
+            for (int d = 0; d < dim; d++)
+               for (int k = 0; k < sdim; k++)
+               {
+                  double s = 0.0;
+                  for (int j = 0; j < nd; j++)
+                     s += pm(k,j)*Gq[j+d*nd];
+                  Jq(k,d) = s;
+               }
+         }
+         if (flags & JACOBIANS)
+            for (int k = 0; k < sd; k++)
+               J(eq*sd + k) = Jq.Data()[k];
+         if (flags & INVERSE_JACOBIANS)
+         {
+            InvJq.UseExternalData(InvJ.GetData() + eq*sd, dim, sdim);
+            CalcInverse(Jq, InvJq);
+         }
+         if (flags & DETERMINANTS)
+            detJ(eq) = Jq.Weight();
+      }
+   }
+   InvJq.ClearExternalData();
+   computed |= flags;
+}
+
+const GeometricFactors &Mesh::GetGeometricFactors(const IntegrationRule &ir,
+                                                  int flags)
+{
+   GeometricFactors *gf = NULL;
+   // the threads of the multithreaded assembly may get the factors of the
+   // same rule at the same time
+#ifdef MFEM_USE_OPENMP
+#pragma omp critical (GeometricFactors)
+#endif
+   {
+      // the nodes may have been edited directly, see NodesUpdated()
+      if (geom_factors.Size() > 0 &&
+          !CopyNodeCoordinates(geom_factors_nodes, true))
+         DeleteGeometricFactors();
+      if (geom_factors.Size() == 0)
+         CopyNodeCoordinates(geom_factors_nodes, false);
+
+      for (int i = 0; i < geom_factors.Size(); i++)
+         if (geom_factors[i]->IntRule == &ir)
+         {
+            gf = geom_factors[i];
+            if (!gf->SameRule(ir))
+            {
+               // the rule of the cached data no longer exists
+               delete gf;
+               gf = geom_factors[i] = new GeometricFactors(*this, ir, flags);
+            }
+            break;
+         }
+      if (gf == NULL)
+      {
+         gf = new GeometricFactors(*this, ir, flags);
+         geom_factors.Append(gf);
+      }
+      gf->Compute(*this, flags);
+   }
+   return *gf;
+}
+
+void Mesh::DeleteGeometricFactors()
+{
+   for (int i = 0; i < geom_factors.Size(); i++)
+      delete geom_factors[i];
+   geom_factors.SetSize(0);
+   geom_factors_nodes.Destroy();
+}
+
+bool Mesh::CopyNodeCoordinates(Vector &coords, bool compare) const
+{
+   const int size = Nodes ? Nodes->Size() : NumOfVertices*spaceDim;
+   if (compare && coords.Size() != size)
+      return false;
+   if (!compare)
+      coords.SetSize(size);
+   for (int i = 0; i < size; i++)
+   {
+      const double x = Nodes ? (*Nodes)(i) : vertices[i/spaceDim](i%spaceDim);
+      if (!compare)
+         coords(i) = x;
+      else if (coords(i) != x)
+         return false;
+   }
+   return true;
+}
+
 void Mesh::AverageVertices(int * indexes, int n, int result)
 {
    int j, k;
@@ -5831,6 +6154,9 @@ Mesh::Mesh(NCMesh &ncmesh)
 
 void Mesh::Swap(Mesh& other, bool non_geometry)
 {
+   DeleteGeometricFactors();
+   other.DeleteGeometricFactors();
+
    mfem::Swap(Dim, other.Dim);
 
    mfem::Swap(NumOfVertices, other.NumOfVertices);
@@ -5873,6 +6199,8 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
 
 void Mesh::UniformRefinement()
 {
+   DeleteGeometricFactors();
+
    if (NURBSext)
       NURBSUniformRefinement();
    else if (meshgen == 1)
@@ -5894,6 +6222,8 @@ void Mesh::UniformRefinement()
 void Mesh::GeneralRefinement(Array<Refinement> &refinements, int nonconforming,
                              int nc_limit)
 {
+   DeleteGeometricFactors();
+
    if (nonconforming < 0)
    {
       // determine if nonconforming refinement is suitable
@@ -6297,6 +6627,9 @@ void Mesh::UniformRefinement(int i, const DSTable &v_to_v,
 
 void Mesh::SetState(int s)
 {
+   if (s != State)
+      DeleteGeometricFactors();
+
    if (ncmesh)
    {
       if (State != Mesh::NORMAL && s == Mesh::NORMAL)
@@ -7186,6 +7519,41 @@ void Mesh::Print(std::ostream &out) const
    }
 }
 
+void Mesh::PrintBinary(std::ostream &out) const
+{
+   PrintBinary(out, boundary, NumOfBdrElements);
+}
+
+void Mesh::PrintBinary(std::ostream &out, const Array<Element *> &bdr,
+                       int nbdr) const
+{
+   MFEM_VERIFY(NURBSext == NULL,
+               "NURBS meshes are not supported by the binary mesh format");
+
+   out << "MFEM binary mesh v1.0\n";
+   const int header[6] =
+   { 1, int(sizeof(int)), Dim, spaceDim, (Nodes != NULL), 0 };
+   const int counts[3] = { NumOfElements, nbdr, NumOfVertices };
+   out.write(reinterpret_cast<const char *>(header), sizeof(header));
+   out.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+
+   PrintBinaryElements(elements, NumOfElements, out);
+   PrintBinaryElements(bdr, nbdr, out);
+
+   if (Nodes == NULL)
+   {
+      Vector coords(NumOfVertices*spaceDim);
+      for (int i = 0; i < NumOfVertices; i++)
+         for (int j = 0; j < spaceDim; j++)
+            coords(i*spaceDim + j) = vertices[i](j);
+      coords.PrintBinary(out);
+   }
+   else
+   {
+      Nodes->SaveBinary(out);
+   }
+}
+
 void Mesh::PrintTopo(std::ostream &out,const Array<int> &e_to_k) const
 {
    int i;
@@ -7512,6 +7880,107 @@ void Mesh::PrintVTK(std::ostream &out, int ref, int field_data)
    out << "POINT_DATA " << np << '\n';
 }
 
+// Convert the integer coordinates X[0..n-1] (b bits each) to the transposed
+// Hilbert index (J. Skilling, "Programming the Hilbert curve", 2004).
+static void HilbertAxesToTranspose(unsigned *X, int b, int n)
+{
+   const unsigned M = 1u << (b - 1);
+   for (unsigned Q = M; Q > 1; Q >>= 1)
+   {
+      const unsigned P = Q - 1;
+      for (int i = 0; i < n; i++)
+      {
+         if (X[i] & Q)
+         {
+            X[0] ^= P;
+         }
+         else
+         {
+            const unsigned t = (X[0] ^ X[i]) & P;
+            X[0] ^= t;
+            X[i] ^= t;
+         }
+      }
+   }
+   for (int i = 1; i < n; i++)
+   {
+      X[i] ^= X[i-1];
+   }
+   unsigned t = 0;
+   for (unsigned Q = M; Q > 1; Q >>= 1)
+   {
+      if (X[n-1] & Q)
+      {
+         t ^= Q - 1;
+      }
+   }
+   for (int i = 0; i < n; i++)
+   {
+      X[i] ^= t;
+   }
+}
+
+void Mesh::GetHilbertElementOrdering(Array<int> &ordering)
+{
+   const int sdim = spaceDim, ne = GetNE();
+   // the Hilbert index of each element is stored in 30 bits
+   const int bits = 30/sdim;
+
+   double min[3], max[3];
+   for (int d = 0; d < sdim; d++)
+   {
+      min[d] = numeric_limits<double>::infinity();
+      max[d] = -min[d];
+   }
+   for (int i = 0; i < NumOfVertices; i++)
+   {
+      const double *v = GetVertex(i);
+      for (int d = 0; d < sdim; d++)
+      {
+         min[d] = std::min(min[d], v[d]);
+         max[d] = std::max(max[d], v[d]);
+      }
+   }
+
+   Array<Pair<int,int> > keys(ne);
+   Array<int> v;
+   unsigned X[3];
+   const double scale = double((1u << bits) - 1);
+   for (int i = 0; i < ne; i++)
+   {
+      GetElementVertices(i, v);
+      for (int d = 0; d < sdim; d++)
+      {
+         double c = 0.0;
+         for (int k = 0; k < v.Size(); k++)
+         {
+            c += GetVertex(v[k])[d];
+         }
+         c /= v.Size();
+         const double h = max[d] - min[d];
+         X[d] = (h > 0.0) ? unsigned(scale*(c - min[d])/h + 0.5) : 0u;
+      }
+      HilbertAxesToTranspose(X, bits, sdim);
+      int key = 0;
+      for (int b = bits - 1; b >= 0; b--)
+      {
+         for (int d = 0; d < sdim; d++)
+         {
+            key = (key << 1) | int((X[d] >> b) & 1u);
+         }
+      }
+      keys[i].one = key;
+      keys[i].two = i;
+   }
+   SortPairs<int,int>(keys, ne);
+
+   ordering.SetSize(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      ordering[i] = keys[i].two;
+   }
+}
+
 void Mesh::GetElementColoring(Array<int> &colors, int el0)
 {
    int delete_el_to_el = (el_to_el) ? (0) : (1);
@@ -8116,6 +8585,8 @@ void Mesh::ScaleSubdomains(double sf)
    delete [] cg;
    delete [] nbea;
    delete [] vn;
+
+   NodesUpdated();
 }
 
 void Mesh::ScaleElements(double sf)
@@ -8178,6 +8649,8 @@ void Mesh::ScaleElements(double sf)
    delete [] cg;
    delete [] nbea;
    delete [] vn;
+
+   NodesUpdated();
 }
 
 void Mesh::Transform(void (*f)(const Vector&, Vector&))
@@ -8201,6 +8674,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
       xnew.ProjectCoefficient(f_pert);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::FreeElement(Element *E)
@@ -8222,6 +8696,8 @@ Mesh::~Mesh()
 {
    int i;
 
+   DeleteGeometricFactors();
+
    if (own_nodes) delete Nodes;
 
    delete ncmesh;
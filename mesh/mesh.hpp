@@ -37,6 +37,53 @@ struct Refinement;
 class ParMesh;
 #endif
 
+class Mesh;
+
+/** Geometric data of all the elements of a Mesh at the points of an
+    IntegrationRule, stored contiguously element by element (see
+    Mesh::GetGeometricFactors()). All the elements must have the geometry of
+    the rule. */
+class GeometricFactors
+{
+public:
+   enum
+   {
+      COORDINATES       = 1,
+      JACOBIANS         = 2,
+      INVERSE_JACOBIANS = 4,
+      DETERMINANTS      = 8
+   };
+
+   const IntegrationRule *IntRule;
+   /// The data that has been computed, a combination of the above flags
+   int computed;
+   int NE, NQ, dim, sdim;
+
+   /// Physical coordinates: NE x NQ blocks of size sdim
+   Vector X;
+   /** Jacobians: NE x NQ blocks of size sdim x dim in column-major order, see
+       DenseMatrix::UseExternalData() */
+   Vector J;
+   /// Inverse (left inverse, if sdim > dim) Jacobians: blocks of size dim x sdim
+   Vector InvJ;
+   /** The values of ElementTransformation::Weight(): the determinants of the
+       Jacobians, or sqrt(det(J^t J)) if sdim > dim. Size NE x NQ. */
+   Vector detJ;
+
+   /** Copy of the points and weights of IntRule, used to detect a different
+       rule created at the same address */
+   Vector ir_data;
+
+   GeometricFactors(Mesh &mesh, const IntegrationRule &ir, int flags);
+
+   /** Compute the data in 'flags' that has not been computed yet. The data
+       already computed is not modified. */
+   void Compute(Mesh &mesh, int flags);
+
+   /// Check if the points and weights of 'ir' are the ones of IntRule
+   bool SameRule(const IntegrationRule &ir) const;
+};
+
 class Mesh
 {
 #ifdef MFEM_USE_MPI
@@ -95,6 +142,11 @@ protected:
    GridFunction *Nodes;
    int own_nodes;
 
+   // Cached geometric factors, see GetGeometricFactors()
+   Array<GeometricFactors *> geom_factors;
+   // Node (or vertex) coordinates for which geom_factors were computed
+   Vector geom_factors_nodes;
+
    // Backup of the coarse mesh. Only used if WantTwoLevelState == 1 and
    // nonconforming refinements are used.
    Mesh* nc_coarse_level;
@@ -116,6 +168,13 @@ protected:
 
    void InitTables();
 
+   void DeleteGeometricFactors();
+
+   /** Copy the node coordinates (or the vertex coordinates, if there are no
+       nodes) to 'coords', or only compare them with 'coords' if 'compare' is
+       true. Return true if they are the same. */
+   bool CopyNodeCoordinates(Vector &coords, bool compare) const;
+
    void DeleteTables();
 
    /** Delete the 'el_to_el', 'face_edge' and 'edge_vertex' tables.
@@ -128,6 +187,15 @@ protected:
    Element *ReadElement(std::istream &);
    static void PrintElement(const Element *, std::ostream &);
 
+   /// Read/write the first n elements of 'els' in the binary mesh format.
+   void ReadBinaryElements(std::istream &, int isize, int n,
+                           Array<Element *> &els);
+   static void PrintBinaryElements(const Array<Element *> &els, int n,
+                                   std::ostream &);
+   /// Print the mesh in binary format using the given boundary elements.
+   void PrintBinary(std::ostream &out, const Array<Element *> &bdr,
+                    int nbdr) const;
+
    void SetMeshGen(); // set 'meshgen'
 
    /// Return the length of the segment from node i to node j.
@@ -642,6 +710,26 @@ public:
        with the given ones. */
    void SwapNodes(GridFunction *&nodes, int &own_nodes_);
 
+   /** Invalidate the data that depends on the node coordinates, e.g. the
+       cached geometric factors. This is done by all the Mesh methods that
+       move the nodes/vertices. Changes made directly to the internal node
+       GridFunction (see GetNodes()) are also detected by
+       GetGeometricFactors(), but calling this method frees the data
+       earlier. */
+   void NodesUpdated() { DeleteGeometricFactors(); }
+
+   /** Return the geometric factors of all the elements at the points of the
+       given rule, computing at least the data requested in 'flags' (see
+       GeometricFactors). The data is cached with the address of the rule as
+       key; a hit is checked against the points of the rule and against a
+       copy of the node coordinates, so that edited nodes or a different rule
+       at the same address are recomputed. The returned object is valid until
+       the next call with different nodes or rule, or until the mesh is
+       refined or its nodes are moved. Data that has already been computed is
+       not moved by later calls with more flags. */
+   const GeometricFactors &GetGeometricFactors(const IntegrationRule &ir,
+                                               int flags);
+
    /// Return the mesh nodes/vertices projected on the given GridFunction.
    void GetNodes(GridFunction &nodes) const;
    /** Replace the internal node GridFunction with a new GridFunction defined
@@ -715,6 +803,17 @@ public:
    /// Print the mesh to the given stream using the default MFEM mesh format.
    virtual void Print(std::ostream &out = std::cout) const;
 
+   /** Print the mesh in the binary MFEM mesh format, which can be read by
+       Load(). After the header line "MFEM binary mesh v1.0", the format
+       consists of the header integers (byte order mark, index size, Dim,
+       spaceDim, curved flag, reserved), the element, boundary element and
+       vertex counts, the attributes, geometries and vertex indices of the
+       elements and of the boundary elements as contiguous arrays, and finally
+       either the vertex coordinates as doubles or, for curved meshes, the
+       Nodes GridFunction saved with GridFunction::SaveBinary(). All data uses
+       the native byte order. NURBS meshes are not supported. */
+   virtual void PrintBinary(std::ostream &out) const;
+
    /// Print the mesh in VTK format (linear and quadratic meshes only).
    void PrintVTK(std::ostream &out);
 
@@ -726,6 +825,12 @@ public:
 
    void GetElementColoring(Array<int> &colors, int el0 = 0);
 
+   /** Compute an ordering of the elements along a Hilbert space-filling curve
+       through the element centers: ordering[k] is the index of the k-th
+       element on the curve. The mesh itself is not modified; the ordering can
+       be passed to FiniteElementSpace::ReorderDofsByElements(). */
+   void GetHilbertElementOrdering(Array<int> &ordering);
+
    /** Prints the mesh with bdr elements given by the boundary of
        the subdomains, so that the boundary of subdomain i has bdr
        attribute i+1. */
@@ -1087,6 +1087,8 @@ void mfem::Mesh::MesquiteSmooth(const int mesquite_option)
       // boundary perserving smoothing doesn't have a wrapper yet.
       BoundaryPreservingOptimization( msq_mesh );
    }
+
+   NodesUpdated();
 }
 
 }
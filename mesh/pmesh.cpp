@@ -18,6 +18,8 @@
 #include "../general/sets.hpp"
 #include "../general/sort_pairs.hpp"
 #include <iostream>
+#include <sstream>
+#include <string>
 using namespace std;
 
 namespace mfem
@@ -524,6 +526,159 @@ ParMesh::ParMesh(MPI_Comm comm, Mesh &mesh, int *partitioning_,
    have_face_nbr_data = false;
 }
 
+// Helpers for the binary checkpoint format, see ParMesh::SaveCheckpoint().
+static const char *pmesh_checkpoint_header = "MFEM ParMesh checkpoint v1.0";
+
+static void WriteCheckpointInts(ostream &out, int n, const int *data)
+{
+   out.write(reinterpret_cast<const char *>(data), streamsize(n)*sizeof(int));
+}
+
+static void ReadCheckpointInts(istream &in, int n, int *data)
+{
+   in.read(reinterpret_cast<char *>(data), streamsize(n)*sizeof(int));
+   MFEM_VERIFY(in, "error reading ParMesh checkpoint data");
+}
+
+static void WriteCheckpointArray(ostream &out, const Array<int> &a)
+{
+   const int n = a.Size();
+   WriteCheckpointInts(out, 1, &n);
+   WriteCheckpointInts(out, n, a.GetData());
+}
+
+static void ReadCheckpointArray(istream &in, Array<int> &a)
+{
+   int n;
+   ReadCheckpointInts(in, 1, &n);
+   a.SetSize(n);
+   ReadCheckpointInts(in, n, a.GetData());
+}
+
+static void WriteCheckpointTable(ostream &out, const Table &t)
+{
+   const int size = (t.Size() < 0) ? 0 : t.Size();
+   const int nnz = size ? t.Size_of_connections() : 0;
+   WriteCheckpointInts(out, 1, &size);
+   WriteCheckpointInts(out, 1, &nnz);
+   if (size)
+   {
+      WriteCheckpointInts(out, size+1, t.GetI());
+      WriteCheckpointInts(out, nnz, t.GetJ());
+   }
+}
+
+static void ReadCheckpointTable(istream &in, Table &t)
+{
+   int size, nnz;
+   ReadCheckpointInts(in, 1, &size);
+   ReadCheckpointInts(in, 1, &nnz);
+   t.SetDims(size, nnz);
+   if (size)
+   {
+      ReadCheckpointInts(in, size+1, t.GetI());
+      ReadCheckpointInts(in, nnz, t.GetJ());
+   }
+}
+
+ParMesh::ParMesh(MPI_Comm comm, const char *checkpoint_file)
+   : gtopo(comm)
+{
+   MyComm = comm;
+   MPI_Comm_size(MyComm, &NRanks);
+   MPI_Comm_rank(MyComm, &MyRank);
+
+   string block;
+   ReadSharedFile(MyComm, checkpoint_file, pmesh_checkpoint_header, block);
+   istringstream in(block);
+
+   int header[8];
+   ReadCheckpointInts(in, 8, header);
+   Dim = header[0];
+   spaceDim = header[1];
+   meshgen = header[2];
+   NumOfElements = header[3];
+   NumOfBdrElements = header[4];
+   NumOfVertices = header[5];
+   const int curved = header[6];
+   const int ngroups = header[7];
+
+   ReadBinaryElements(in, sizeof(int), NumOfElements, elements);
+   ReadBinaryElements(in, sizeof(int), NumOfBdrElements, boundary);
+   if (Dim == 3 && (meshgen & 1))
+   {
+      Array<int> flags(NumOfElements);
+      ReadCheckpointInts(in, NumOfElements, flags);
+      for (int i = 0; i < NumOfElements; i++)
+         if (elements[i]->GetType() == Element::TETRAHEDRON)
+            ((Tetrahedron *)elements[i])->SetRefinementFlag(flags[i]);
+   }
+
+   Vector coords(NumOfVertices*spaceDim);
+   in.read(reinterpret_cast<char *>(coords.GetData()),
+           streamsize(coords.Size())*sizeof(double));
+   MFEM_VERIFY(in, "error reading ParMesh checkpoint data");
+   vertices.SetSize(NumOfVertices);
+   for (int i = 0; i < NumOfVertices; i++)
+      for (int j = 0; j < spaceDim; j++)
+         vertices[i](j) = coords(i*spaceDim + j);
+
+   ReadCheckpointArray(in, attributes);
+   ReadCheckpointArray(in, bdr_attributes);
+
+   Table group_proc;
+   ReadCheckpointTable(in, group_proc);
+   MFEM_VERIFY(group_proc.Size() == ngroups,
+               "inconsistent ParMesh checkpoint data");
+   ReadCheckpointTable(in, group_svert);
+   ReadCheckpointTable(in, group_sedge);
+   ReadCheckpointTable(in, group_sface);
+   ReadCheckpointArray(in, svert_lvert);
+   ReadCheckpointArray(in, sedge_ledge);
+   ReadCheckpointArray(in, sface_lface);
+
+   int nshared[2];
+   ReadCheckpointInts(in, 2, nshared);
+   ReadBinaryElements(in, sizeof(int), nshared[0], shared_edges);
+   ReadBinaryElements(in, sizeof(int), nshared[1], shared_faces);
+
+   // rebuild the local topology in the same way as the ParMesh constructor,
+   // which reproduces the local edge and face numbering
+   if (Dim > 1)
+   {
+      el_to_edge = new Table;
+      NumOfEdges = Mesh::GetElementToEdgeTable(*el_to_edge, be_to_edge);
+   }
+   else
+      NumOfEdges = 0;
+
+   if (Dim == 3)
+      GetElementToFaceTable();
+   else
+      NumOfFaces = 0;
+   GenerateFaces();
+
+   c_el_to_edge = NULL;
+
+   // the groups are stored in their original order, group 0 is the local one
+   ListOfIntegerSets groups;
+   IntegerSet        group;
+   for (int g = 0; g < ngroups; g++)
+   {
+      group.Recreate(group_proc.RowSize(g), group_proc.GetRow(g));
+      groups.Insert(group);
+   }
+   gtopo.Create(groups, 822);
+
+   if (curved)
+   {
+      Nodes = new ParGridFunction(this, in);
+      own_nodes = 1;
+   }
+
+   have_face_nbr_data = false;
+}
+
 void ParMesh::GroupEdge(int group, int i, int &edge, int &o)
 {
    int sedge = group_sedge.GetJ()[group_sedge.GetI()[group-1]+i];
@@ -2511,6 +2666,102 @@ void ParMesh::Print(std::ostream &out) const
    }
 }
 
+void ParMesh::PrintBinary(std::ostream &out) const
+{
+   const Array<int> &s2l_face = ((Dim == 1) ? svert_lvert :
+                                 ((Dim == 2) ? sedge_ledge : sface_lface));
+
+   if (NURBSext || Dim == 1)
+   {
+      Mesh::PrintBinary(out);
+      return;
+   }
+
+   // same as in Print(): the shared faces become boundary elements
+   int shared_bdr_attr;
+   if (bdr_attributes.Size())
+      shared_bdr_attr = bdr_attributes.Max() + MyRank + 1;
+   else
+      shared_bdr_attr = MyRank + 1;
+
+   Array<Element *> bdr(NumOfBdrElements + s2l_face.Size());
+   for (int i = 0; i < NumOfBdrElements; i++)
+      bdr[i] = boundary[i];
+   for (int i = 0; i < s2l_face.Size(); i++)
+   {
+      faces[s2l_face[i]]->SetAttribute(shared_bdr_attr);
+      bdr[NumOfBdrElements + i] = faces[s2l_face[i]];
+   }
+   Mesh::PrintBinary(out, bdr, bdr.Size());
+}
+
+void ParMesh::SaveCheckpoint(const char *filename) const
+{
+   MFEM_VERIFY(NURBSext == NULL,
+               "NURBS meshes are not supported by ParMesh::SaveCheckpoint");
+
+   ostringstream out;
+
+   const int header[8] =
+   {
+      Dim, spaceDim, meshgen, NumOfElements, NumOfBdrElements, NumOfVertices,
+      (Nodes != NULL), gtopo.NGroups()
+   };
+   WriteCheckpointInts(out, 8, header);
+
+   PrintBinaryElements(elements, NumOfElements, out);
+   PrintBinaryElements(boundary, NumOfBdrElements, out);
+   // the refinement flags define the marked edges used by LocalRefinement()
+   if (Dim == 3 && (meshgen & 1))
+   {
+      Array<int> flags(NumOfElements);
+      for (int i = 0; i < NumOfElements; i++)
+         flags[i] = elements[i]->GetRefinementFlag();
+      WriteCheckpointInts(out, NumOfElements, flags);
+   }
+
+   Vector coords(NumOfVertices*spaceDim);
+   for (int i = 0; i < NumOfVertices; i++)
+      for (int j = 0; j < spaceDim; j++)
+         coords(i*spaceDim + j) = vertices[i](j);
+   out.write(reinterpret_cast<const char *>(coords.GetData()),
+             streamsize(coords.Size())*sizeof(double));
+
+   WriteCheckpointArray(out, attributes);
+   WriteCheckpointArray(out, bdr_attributes);
+
+   // store the groups with ranks instead of local neighbor indices
+   Table group_proc;
+   int nnz = 0;
+   for (int g = 0; g < gtopo.NGroups(); g++)
+      nnz += gtopo.GetGroupSize(g);
+   group_proc.SetDims(gtopo.NGroups(), nnz);
+   for (int g = 0, k = 0; g < gtopo.NGroups(); g++)
+   {
+      group_proc.GetI()[g] = k;
+      const int *nbrs = gtopo.GetGroup(g);
+      for (int j = 0; j < gtopo.GetGroupSize(g); j++)
+         group_proc.GetJ()[k++] = gtopo.GetNeighborRank(nbrs[j]);
+   }
+   WriteCheckpointTable(out, group_proc);
+   WriteCheckpointTable(out, group_svert);
+   WriteCheckpointTable(out, group_sedge);
+   WriteCheckpointTable(out, group_sface);
+   WriteCheckpointArray(out, svert_lvert);
+   WriteCheckpointArray(out, sedge_ledge);
+   WriteCheckpointArray(out, sface_lface);
+
+   const int nshared[2] = { shared_edges.Size(), shared_faces.Size() };
+   WriteCheckpointInts(out, 2, nshared);
+   PrintBinaryElements(shared_edges, nshared[0], out);
+   PrintBinaryElements(shared_faces, nshared[1], out);
+
+   if (Nodes)
+      Nodes->SaveBinary(out);
+
+   WriteSharedFile(MyComm, filename, pmesh_checkpoint_header, out.str());
+}
+
 void ParMesh::PrintAsOne(std::ostream &out)
 {
    int i, j, k, p, nv_ne[2], &nv = nv_ne[0], &ne = nv_ne[1], vc;
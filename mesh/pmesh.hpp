@@ -65,6 +65,11 @@ public:
    ParMesh(MPI_Comm comm, Mesh &mesh, int *partitioning_ = NULL,
            int part_method = 1);
 
+   /** Restart from a file written by SaveCheckpoint(). The number of ranks in
+       'comm' must be the same as when the file was written; each rank reads
+       back its own part, so no repartitioning takes place. */
+   ParMesh(MPI_Comm comm, const char *checkpoint_file);
+
    MPI_Comm GetComm() { return MyComm; }
    int GetNRanks() { return NRanks; }
    int GetMyRank() { return MyRank; }
@@ -124,6 +129,14 @@ public:
        as boundary (for visualization purposes) using the default format. */
    virtual void Print(std::ostream &out = std::cout) const;
 
+   /** Binary version of Print(): the interface is added as boundary, see
+       Mesh::PrintBinary(). */
+   virtual void PrintBinary(std::ostream &out) const;
+
+   /** Write the local parts of the mesh, including the parallel topology, of
+       all ranks into one shared binary file using MPI-IO. */
+   void SaveCheckpoint(const char *filename) const;
+
    /** Print the part of the mesh in the calling processor adding the interface
        as boundary (for visualization purposes) using Netgen/Truegrid format .*/
    virtual void PrintXG(std::ostream &out = std::cout) const;
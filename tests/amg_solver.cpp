@@ -0,0 +1,189 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: smoothed aggregation AMG preconditioner
+//
+// Compile with: make amg_solver
+//
+// Description:  Solves Poisson problems on two refinements of the star mesh
+//               and on the square-disc mesh, and a linear elasticity problem
+//               on the quad beam, with the unknowns ordered by nodes and by
+//               vdim, using CG preconditioned by AMGSolver with V- and
+//               W-cycles and with Chebyshev and l1-Jacobi smoothing. The
+//               preconditioner must be symmetric, and CG must converge in a
+//               number of iterations that stays small under refinement.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+void coords(const Vector &x, Vector &y) { y = x; }
+
+// Relative asymmetry |(y, M x) - (x, M y)| / (|(y, M x)| + |(x, M y)|)
+double Asymmetry(const Solver &M, int n)
+{
+   Vector x(n), y(n), Mx(n), My(n);
+   x.Randomize(2);
+   y.Randomize(3);
+   M.Mult(x, Mx);
+   M.Mult(y, My);
+   const double a = y*Mx, b = x*My;
+   return fabs(a - b)/(fabs(a) + fabs(b));
+}
+
+// Solve A x = b with AMG-PCG, return the number of iterations or -1
+int Solve(const SparseMatrix &A, const Vector &b, AMGSolver &amg,
+          const char *name)
+{
+   amg.SetOperator(A);
+   Vector x(A.Size()), r(A.Size());
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+   cg.SetPrintLevel(-1);
+   cg.SetPreconditioner(amg);
+   cg.SetOperator(A);
+   x = 0.0;
+   cg.Mult(b, x);
+
+   A.Mult(x, r);
+   subtract(b, r, r);
+   const double res = r.Norml2()/b.Norml2();
+   const double asym = Asymmetry(amg, A.Size());
+   const int it = cg.GetNumIterations();
+   cout << name << ": " << A.Size() << " unknowns, " << amg.GetNumLevels()
+        << " levels, " << it << " iterations, relative residual = " << res
+        << ", asymmetry = " << asym << endl;
+   if (!cg.GetConverged() || res > 1e-6 || asym > 1e-10 ||
+       amg.GetNumLevels() < 2)
+      return -1;
+   return it;
+}
+
+int main()
+{
+   int failed = 0;
+   ConstantCoefficient one(1.0);
+
+   // Poisson problems
+   const char *name[] = { "V-cycle", "W-cycle", "l1-Jacobi" };
+   int prev_it[3] = { 0, 0, 0 };
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   for (int ref = 0; ref < 2; ref++)
+   {
+      mesh.UniformRefinement();
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.Assemble();
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      GridFunction x(&fes);
+      x = 0.0;
+      Array<int> ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      a.EliminateEssentialBC(ess_bdr, x, b);
+      a.Finalize();
+
+      for (int k = 0; k < 3; k++)
+      {
+         AMGSolver amg;
+         if (k == 1)
+            amg.SetCycleType(AMGSolver::W_CYCLE);
+         if (k == 2)
+            amg.SetSmoother(AMGSolver::L1_JACOBI, 2);
+         const int it = Solve(a.SpMat(), b, amg, name[k]);
+         if (it < 0 || it > 60 || (ref > 0 && it > prev_it[k] + 10))
+            failed = 1;
+         prev_it[k] = it;
+      }
+   }
+
+   // P2 on square-disc, where a few power iterations underestimate the
+   // largest eigenvalue of D^{-1} A by more than the Chebyshev margin
+   {
+      ifstream idisc("../data/square-disc.mesh");
+      Mesh disc(idisc, 1, 1);
+      disc.UniformRefinement();
+      disc.UniformRefinement();
+      FiniteElementSpace fes(&disc, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.Assemble();
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      GridFunction x(&fes);
+      x = 0.0;
+      Array<int> ess_bdr(disc.bdr_attributes.Max());
+      ess_bdr = 1;
+      a.EliminateEssentialBC(ess_bdr, x, b);
+      a.Finalize();
+
+      AMGSolver amg;
+      const int it = Solve(a.SpMat(), b, amg, "V-cycle, square-disc");
+      if (it < 0 || it > 60)
+         failed = 1;
+   }
+
+   // linear elasticity with the rigid body modes as near null space
+   ifstream ibeam("../data/beam-quad.mesh");
+   Mesh beam(ibeam, 1, 1);
+   for (int ref = 0; ref < 4; ref++)
+      beam.UniformRefinement();
+   const int dim = beam.Dimension();
+   H1_FECollection fec1(1, dim);
+   for (int ord = 0; ord < 2; ord++)
+   {
+      FiniteElementSpace fes(&beam, &fec1, dim,
+                             ord ? Ordering::byVDIM : Ordering::byNODES);
+      BilinearForm a(&fes);
+      Vector lambda(beam.attributes.Max());
+      lambda = 1.0;
+      lambda(0) = 50.0;
+      PWConstCoefficient lambda_func(lambda);
+      PWConstCoefficient mu_func(lambda);
+      a.AddDomainIntegrator(new ElasticityIntegrator(lambda_func, mu_func));
+      a.Assemble();
+      Vector b(fes.GetVSize());
+      b.Randomize(1);
+      GridFunction x(&fes);
+      x = 0.0;
+      Array<int> ess_bdr(beam.bdr_attributes.Max());
+      ess_bdr = 0;
+      ess_bdr[0] = 1;
+      a.EliminateEssentialBC(ess_bdr, x, b);
+      a.Finalize();
+
+      GridFunction nodes(&fes);
+      VectorFunctionCoefficient coords_func(dim, coords);
+      nodes.ProjectCoefficient(coords_func);
+
+      AMGSolver amg;
+      amg.SetSystemsOptions(dim, ord == 0);
+      amg.SetElasticityOptions(nodes);
+      const int it = Solve(a.SpMat(), b, amg, ord ? "elasticity, byVDIM" :
+                           "elasticity, byNODES");
+      if (it < 0 || it > 60)
+         failed = 1;
+   }
+
+   return failed;
+}
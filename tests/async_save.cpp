@@ -0,0 +1,96 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: asynchronous DataCollection output
+//
+// Compile with: make async_save
+//
+// Description:  Saves several cycles of a VisItDataCollection with a static
+//               mesh in asynchronous mode, overwriting the field right after
+//               each Save() call, and then loads every cycle back. Each cycle
+//               must contain the values the field had when Save() was called.
+//               With MFEM_USE_PTHREADS=YES the snapshots are written by the
+//               background thread.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+const int num_cycles = 5;
+
+// values that are reproduced exactly also in the (6-digit) ASCII format
+void SetField(GridFunction &x, int cycle)
+{
+   for (int i = 0; i < x.Size(); i++)
+      x(i) = cycle + 0.125*(i%8);
+}
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+   GridFunction x(&fes);
+   int failed = 0;
+
+   for (int format = 0; format <= 1; format++)
+   {
+      VisItDataCollection dc("AsyncSave", &mesh);
+      dc.SetFormat(format);
+      dc.SetStaticMesh(true);
+      dc.SetAsync(true, 2);
+      dc.RegisterField("x", &x);
+      for (int cycle = 0; cycle < num_cycles; cycle++)
+      {
+         SetField(x, cycle);
+         dc.SetCycle(cycle);
+         dc.SetTime(0.1*cycle);
+         dc.Save();
+         // must not affect the snapshot of this cycle
+         x = -1.0;
+      }
+      dc.WaitForSaves();
+      if (dc.Error())
+      {
+         cout << "format " << format << ": Save() failed" << endl;
+         return 1;
+      }
+
+      for (int cycle = 0; cycle < num_cycles; cycle++)
+      {
+         VisItDataCollection dc_in("AsyncSave");
+         dc_in.Load(cycle);
+         if (dc_in.Error())
+         {
+            cout << "format " << format << ", cycle " << cycle
+                 << ": Load() failed" << endl;
+            failed = 1;
+            continue;
+         }
+         SetField(x, cycle);
+         Vector d(x);
+         d -= *dc_in.GetField("x");
+         const bool ok = (dc_in.GetMesh()->GetNE() == mesh.GetNE()) &&
+                         (d.Normlinf() == 0.0);
+         cout << "format " << format << ", cycle " << cycle << ": "
+              << (ok ? "OK" : "WRONG DATA") << endl;
+         if (!ok)
+            failed = 1;
+      }
+   }
+
+   return failed;
+}
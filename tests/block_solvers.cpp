@@ -0,0 +1,165 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: block CG and block GMRES for multiple right-hand sides
+//
+// Compile with: make block_solvers
+//
+// Description:  Solves a diffusion-reaction system with BlockCGSolver and a
+//               convection-diffusion system with BlockGMRESSolver for 1, 3
+//               and 6 right-hand sides (one of them repeated, to exercise the
+//               removal of dependent directions). The operator is given as a
+//               SparseMatrix and as a SELLMatrix, with and without a Jacobi
+//               preconditioner. Every column must match the solution of the
+//               single right-hand side CGSolver/GMRESSolver.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Solve the columns of B one at a time with the single-vector solver
+void SolveColumns(IterativeSolver &solver, const DenseMatrix &B,
+                  DenseMatrix &X)
+{
+   X.SetSize(B.Height(), B.Width());
+   for (int j = 0; j < B.Width(); j++)
+   {
+      Vector b(B.Data() + j*B.Height(), B.Height());
+      Vector x(X.Data() + j*X.Height(), X.Height());
+      x = 0.0;
+      solver.Mult(b, x);
+   }
+}
+
+// Max over the columns of ||B - A X|| / ||B|| and ||X - X_ref|| / ||X_ref||
+void Errors(const SparseMatrix &A, const DenseMatrix &B, const DenseMatrix &X,
+            const DenseMatrix &X_ref, double &res, double &err)
+{
+   const int n = B.Height();
+   Vector r(n);
+   res = err = 0.0;
+   for (int j = 0; j < B.Width(); j++)
+   {
+      Vector b(B.Data() + j*n, n), x(X.Data() + j*n, n);
+      Vector x_ref(X_ref.Data() + j*n, n);
+      A.Mult(x, r);
+      subtract(b, r, r);
+      res = max(res, r.Norml2()/b.Norml2());
+      subtract(x, x_ref, r);
+      err = max(err, r.Norml2()/x_ref.Norml2());
+   }
+}
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+
+   ConstantCoefficient one(1.0);
+   Vector vel(2);
+   vel(0) = 2.0;
+   vel(1) = 1.0;
+   VectorConstantCoefficient velocity(vel);
+
+   BilinearForm a_spd(&fes), a_ns(&fes);
+   a_spd.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a_spd.AddDomainIntegrator(new MassIntegrator(one));
+   a_ns.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a_ns.AddDomainIntegrator(new MassIntegrator(one));
+   a_ns.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+   a_spd.Assemble();
+   a_spd.Finalize();
+   a_ns.Assemble();
+   a_ns.Finalize();
+
+   const int n = fes.GetVSize();
+   const int nrhs[] = { 1, 3, 6 };
+   int failed = 0;
+
+   for (int k = 0; k < 2; k++)
+   {
+      const SparseMatrix &A = (k == 0) ? a_spd.SpMat() : a_ns.SpMat();
+      SELLMatrix A_sell(A, 4, 32);
+      DSmoother jacobi(A);
+
+      for (int pc = 0; pc <= 1; pc++)
+         for (int s = 0; s < 3; s++)
+         {
+            DenseMatrix B(n, nrhs[s]), X_ref, X;
+            for (int j = 0; j < nrhs[s]; j++)
+            {
+               Vector b(B.Data() + j*n, n);
+               b.Randomize(j + 1);
+            }
+            if (nrhs[s] == 6)
+               for (int i = 0; i < n; i++)
+                  B(i,5) = B(i,1);
+
+            CGSolver cg;
+            GMRESSolver gmres;
+            gmres.SetKDim(100);
+            IterativeSolver &single = (k == 0) ?
+                                      (IterativeSolver &)cg : gmres;
+            single.SetRelTol(1e-12);
+            single.SetMaxIter(2000);
+            single.SetPrintLevel(-1);
+            if (pc)
+               single.SetPreconditioner(jacobi);
+            single.SetOperator(A);
+            SolveColumns(single, B, X_ref);
+
+            for (int m = 0; m < 2; m++)
+            {
+               const Operator &op = (m == 0) ? (const Operator &)A : A_sell;
+               BlockCGSolver bcg;
+               BlockGMRESSolver bgmres;
+               bgmres.SetKDim(40);
+               IterativeSolver &block = (k == 0) ?
+                                        (IterativeSolver &)bcg : bgmres;
+               block.SetRelTol(1e-12);
+               block.SetMaxIter(2000);
+               block.SetPrintLevel(-1);
+               // set the preconditioner (built on A) after the operator, so
+               // that it is not reset with the SELLMatrix
+               block.SetOperator(op);
+               if (pc)
+                  block.SetPreconditioner(jacobi);
+               X.SetSize(n, nrhs[s]);
+               X = 0.0;
+               if (k == 0)
+                  bcg.Mult(B, X);
+               else
+                  bgmres.Mult(B, X);
+
+               double res, err;
+               Errors(A, B, X, X_ref, res, err);
+               cout << (k == 0 ? "BlockCG" : "BlockGMRES")
+                    << (m == 0 ? ", SparseMatrix" : ", SELLMatrix")
+                    << (pc ? ", Jacobi" : "") << ", " << nrhs[s]
+                    << " rhs: " << block.GetNumIterations()
+                    << " iterations, relative residual = " << res
+                    << ", difference from " << (k == 0 ? "CG" : "GMRES")
+                    << " = " << err << endl;
+               if (!block.GetConverged() || res > 1e-9 || err > 1e-8)
+                  failed = 1;
+            }
+         }
+   }
+
+   return failed;
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: Chebyshev smoother and eigenvalue estimate
+//
+// Compile with: make chebyshev
+//
+// Description:  Checks EstimateMaxEigenvalue() against a long Lanczos run
+//               and ChebyshevSmoother for orders 1-4 on a diffusion matrix
+//               with eliminated essential boundary conditions, both with the
+//               SparseMatrix and with a matrix-free wrapper of it. The
+//               smoother must be symmetric, reduce the energy norm of the
+//               error, leave the unknowns with zero diagonal unchanged, and
+//               accelerate CG more for higher orders.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Matrix-free wrapper of a SparseMatrix
+class WrappedOperator : public Operator
+{
+   const SparseMatrix &A;
+public:
+   WrappedOperator(const SparseMatrix &a) : Operator(a.Size()), A(a) { }
+   virtual void Mult(const Vector &x, Vector &y) const { A.Mult(x, y); }
+};
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   Vector b(fes.GetVSize());
+   b.Randomize(1);
+   GridFunction x0(&fes);
+   x0 = 0.0;
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   a.EliminateEssentialBC(ess_bdr, x0, b);
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+   const int n = A.Size();
+   WrappedOperator Aop(A);
+
+   int failed = 0;
+
+   Vector diag, dinv(n);
+   A.GetDiag(diag);
+   for (int i = 0; i < n; i++)
+      dinv(i) = 1.0/diag(i);
+   const double lmax = EstimateMaxEigenvalue(A, dinv, 200);
+   const double est = EstimateMaxEigenvalue(Aop, dinv);
+   cout << "largest eigenvalue of D^{-1} A: " << lmax << ", estimate: " << est
+        << endl;
+   if (est > lmax*(1.0 + 1e-10) || 1.1*est < lmax)
+      failed = 1;
+
+   // a diagonal with a zero entry for unknown 0
+   Vector diag0(diag);
+   diag0(0) = 0.0;
+
+   int prev_it = 0;
+   for (int order = 1; order <= 4; order++)
+   {
+      ChebyshevSmoother cheb(A, order);
+      ChebyshevSmoother cheb_mf(Aop, diag, order);
+
+      // identical results with the matrix-free operator
+      Vector y(n), y_mf(n), e(n), Ee(n), Ae(n), t(n), u(n);
+      cheb.Mult(b, y);
+      cheb_mf.Mult(b, y_mf);
+      y_mf -= y;
+      const double mf_err = y_mf.Normlinf()/y.Normlinf();
+
+      // symmetry of y = M b
+      e.Randomize(2);
+      cheb.Mult(e, t);
+      const double asym = fabs((b*t) - (e*y))/fabs(b*t);
+
+      // error propagation: E e = e - M A e
+      A.Mult(e, Ae);
+      Ee = e;
+      cheb.iterative_mode = true;
+      t = 0.0;
+      cheb.Mult(t, Ee);
+      cheb.iterative_mode = false;
+      A.Mult(Ee, t);
+      const double red = sqrt((Ee*t)/(e*Ae));
+
+      // zero diagonal
+      ChebyshevSmoother cheb0(Aop, diag0, order);
+      u = 1.0;
+      cheb0.iterative_mode = true;
+      cheb0.Mult(b, u);
+      const double zero_diag_err = fabs(u(0) - 1.0);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(1000);
+      cg.SetPrintLevel(-1);
+      cg.SetPreconditioner(cheb);
+      cg.SetOperator(A);
+      y = 0.0;
+      cg.Mult(b, y);
+      const int it = cg.GetNumIterations();
+
+      cout << "order " << order << ": matrix-free difference = " << mf_err
+           << ", asymmetry = " << asym << ", error reduction = " << red
+           << ", zero diagonal change = " << zero_diag_err << ", PCG "
+           << it << " iterations" << endl;
+      if (mf_err > 1e-12 || asym > 1e-10 || red >= 1.0 ||
+          zero_diag_err != 0.0 || !cg.GetConverged() ||
+          (order > 1 && it >= prev_it))
+         failed = 1;
+      prev_it = it;
+   }
+
+   return failed;
+}
@@ -0,0 +1,268 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: evaluation of coefficients at all the points of a rule
+//
+// Compile with: make coefficient_eval
+//
+// Description:  Compares the Eval methods of the scalar, vector and matrix
+//               coefficients for a whole IntegrationRule with the evaluation
+//               point by point on a curved mesh with two attributes. Then
+//               assembles diffusion, mass and linear forms (full and partial
+//               assembly) with function coefficients and with wrappers that
+//               only provide the point evaluation; the results must agree.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double f(Vector &x) { return 1.0 + x(0)*x(0) + 0.5*sin(x(1)); }
+double f_t(Vector &x, double t) { return t*x(0) - x(1); }
+
+void fvec(const Vector &x, Vector &v)
+{
+   v(0) = x(0)*x(1);
+   v(1) = 1.0 + x(1)*x(1);
+}
+
+void fmat(const Vector &x, DenseMatrix &K)
+{
+   K(0,0) = 2.0 + x(0)*x(0);
+   K(0,1) = K(1,0) = 0.1*x(0)*x(1);
+   K(1,1) = 1.0 + x(1)*x(1);
+}
+
+// Coefficients with only the point evaluation (the general rule evaluation)
+class PointwiseCoefficient : public Coefficient
+{
+   Coefficient &c;
+public:
+   PointwiseCoefficient(Coefficient &c_) : c(c_) { }
+   virtual double Eval(ElementTransformation &T, const IntegrationPoint &ip)
+   { return c.Eval(T, ip); }
+};
+
+class PointwiseVectorCoefficient : public VectorCoefficient
+{
+   VectorCoefficient &c;
+public:
+   PointwiseVectorCoefficient(VectorCoefficient &c_)
+      : VectorCoefficient(c_.GetVDim()), c(c_) { }
+   using VectorCoefficient::Eval;
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationPoint &ip)
+   { c.Eval(V, T, ip); }
+};
+
+class PointwiseMatrixCoefficient : public MatrixCoefficient
+{
+   MatrixCoefficient &c;
+public:
+   PointwiseMatrixCoefficient(MatrixCoefficient &c_)
+      : MatrixCoefficient(c_.GetVDim()), c(c_) { }
+   using MatrixCoefficient::Eval;
+   virtual void Eval(DenseMatrix &K, ElementTransformation &T,
+                     const IntegrationPoint &ip)
+   { c.Eval(K, T, ip); }
+};
+
+// Max difference between the rule and the point evaluations on all elements
+double Difference(Mesh &mesh, Coefficient *c, VectorCoefficient *vc,
+                  MatrixCoefficient *mc)
+{
+   double err = 0.0;
+   Vector V, v;
+   DenseMatrix M, m;
+   DenseTensor K;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      const IntegrationRule &ir =
+         IntRules.Get(mesh.GetElementBaseGeometry(e), 4);
+      if (c) c->Eval(V, T, ir);
+      if (vc) vc->Eval(M, T, ir);
+      if (mc) mc->Eval(K, T, ir);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         T.SetIntPoint(&ip);
+         if (c)
+            err = fmax(err, fabs(V(i) - c->Eval(T, ip)));
+         if (vc)
+         {
+            vc->Eval(v, T, ip);
+            for (int k = 0; k < v.Size(); k++)
+               err = fmax(err, fabs(M(k,i) - v(k)));
+         }
+         if (mc)
+         {
+            mc->Eval(m, T, ip);
+            m -= K(i);
+            err = fmax(err, m.MaxMaxNorm());
+         }
+      }
+   }
+   return err;
+}
+
+int main()
+{
+   ifstream imesh("../data/star-q2.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   for (int e = 0; e < mesh.GetNE(); e++)
+      mesh.GetElement(e)->SetAttribute(1 + e%2);
+   mesh.SetAttributes();
+   const int dim = mesh.Dimension();
+
+   H1_FECollection fec(2, dim);
+   FiniteElementSpace fes(&mesh, &fec), vfes(&mesh, &fec, dim);
+   GridFunction gf(&vfes);
+   VectorFunctionCoefficient vfunc(dim, fvec);
+   gf.ProjectCoefficient(vfunc);
+
+   Vector pw(2);
+   pw(0) = 2.0;
+   pw(1) = 3.0;
+   Array<int> attr(2);
+   attr[0] = 0;
+   attr[1] = 1;
+   ConstantCoefficient cc(2.5);
+   PWConstCoefficient pwc(pw);
+   FunctionCoefficient func(f), func_t(f_t);
+   func_t.SetTime(0.5);
+   GridFunctionCoefficient gfc(&gf, 2);
+   RestrictedCoefficient rc(func, attr);
+   VectorFunctionCoefficient vfunc_q(dim, fvec, &func);
+   VectorArrayCoefficient vac(dim);
+   vac.Set(0, new FunctionCoefficient(f));
+   vac.Set(1, new ConstantCoefficient(-1.0));
+   VectorGridFunctionCoefficient vgfc(&gf);
+   MatrixFunctionCoefficient mfunc(dim, fmat);
+   MatrixArrayCoefficient mac(dim);
+   for (int i = 0; i < dim; i++)
+      for (int j = 0; j < dim; j++)
+         mac.Set(i, j, (i == j) ? new FunctionCoefficient(f) :
+                 new FunctionCoefficient(f_t));
+
+   int failed = 0;
+   struct { const char *name; Coefficient *c; VectorCoefficient *vc;
+            MatrixCoefficient *mc; } coeffs[] =
+   {
+      { "ConstantCoefficient", &cc, NULL, NULL },
+      { "PWConstCoefficient", &pwc, NULL, NULL },
+      { "FunctionCoefficient", &func, NULL, NULL },
+      { "FunctionCoefficient (time-dependent)", &func_t, NULL, NULL },
+      { "GridFunctionCoefficient", &gfc, NULL, NULL },
+      { "RestrictedCoefficient", &rc, NULL, NULL },
+      { "VectorFunctionCoefficient", NULL, &vfunc, NULL },
+      { "VectorFunctionCoefficient (scaled)", NULL, &vfunc_q, NULL },
+      { "VectorArrayCoefficient", NULL, &vac, NULL },
+      { "VectorGridFunctionCoefficient", NULL, &vgfc, NULL },
+      { "MatrixFunctionCoefficient", NULL, NULL, &mfunc },
+      { "MatrixArrayCoefficient", NULL, NULL, &mac }
+   };
+   for (int k = 0; k < 12; k++)
+   {
+      const double err = Difference(mesh, coeffs[k].c, coeffs[k].vc,
+                                    coeffs[k].mc);
+      cout << coeffs[k].name << ": max difference = " << err << endl;
+      if (err > 1e-14)
+         failed = 1;
+   }
+
+   // forms with the rule evaluation vs. the point evaluation
+   PointwiseCoefficient pfunc(func);
+   PointwiseVectorCoefficient pvfunc(vfunc_q);
+   PointwiseMatrixCoefficient pmfunc(mfunc);
+   Vector x(fes.GetVSize()), y(fes.GetVSize()), y_ref(fes.GetVSize());
+   x.Randomize(1);
+   for (int type = 0; type < 3; type++)
+   {
+      const char *name[] = { "diffusion", "matrix diffusion", "mass" };
+      for (int level = 0; level <= 1; level++)
+      {
+         BilinearForm a(&fes), a_ref(&fes);
+         if (type == 0)
+         {
+            a.AddDomainIntegrator(new DiffusionIntegrator(func));
+            a_ref.AddDomainIntegrator(new DiffusionIntegrator(pfunc));
+         }
+         else if (type == 1)
+         {
+            a.AddDomainIntegrator(new DiffusionIntegrator(mfunc));
+            a_ref.AddDomainIntegrator(new DiffusionIntegrator(pmfunc));
+         }
+         else
+         {
+            a.AddDomainIntegrator(new MassIntegrator(func));
+            a_ref.AddDomainIntegrator(new MassIntegrator(pfunc));
+         }
+         if (level == 1)
+            a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         a.Assemble();
+         a_ref.Assemble();
+         if (level == 0)
+            a.Finalize();
+         a_ref.Finalize();
+         a.Mult(x, y);
+         a_ref.Mult(x, y_ref);
+         y -= y_ref;
+         const double err = y.Normlinf()/y_ref.Normlinf();
+         cout << name[type] << (level ? " (partial assembly)" : "")
+              << ": relative difference = " << err << endl;
+         if (err > 1e-13)
+            failed = 1;
+      }
+   }
+
+   for (int type = 0; type < 4; type++)
+   {
+      const char *name[] =
+      {
+         "domain LF", "boundary LF", "vector domain LF", "vector boundary LF"
+      };
+      FiniteElementSpace &lf_fes = (type < 2) ? fes : vfes;
+      LinearForm b(&lf_fes), b_ref(&lf_fes);
+      switch (type)
+      {
+      case 0:
+         b.AddDomainIntegrator(new DomainLFIntegrator(func));
+         b_ref.AddDomainIntegrator(new DomainLFIntegrator(pfunc));
+         break;
+      case 1:
+         b.AddBoundaryIntegrator(new BoundaryLFIntegrator(func));
+         b_ref.AddBoundaryIntegrator(new BoundaryLFIntegrator(pfunc));
+         break;
+      case 2:
+         b.AddDomainIntegrator(new VectorDomainLFIntegrator(vfunc_q));
+         b_ref.AddDomainIntegrator(new VectorDomainLFIntegrator(pvfunc));
+         break;
+      case 3:
+         b.AddBoundaryIntegrator(new VectorBoundaryLFIntegrator(vfunc_q));
+         b_ref.AddBoundaryIntegrator(new VectorBoundaryLFIntegrator(pvfunc));
+         break;
+      }
+      b.Assemble();
+      b_ref.Assemble();
+      b -= b_ref;
+      const double err = b.Normlinf()/b_ref.Normlinf();
+      cout << name[type] << ": relative difference = " << err << endl;
+      if (err > 1e-13)
+         failed = 1;
+   }
+
+   return failed;
+}
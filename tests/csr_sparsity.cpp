@@ -0,0 +1,120 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: precomputed CSR sparsity of vector and mixed forms
+//
+// Compile with: make csr_sparsity
+//
+// Description:  Assembles a vector diffusion form (on a vector H1 space in
+//               both orderings) and the mixed divergence forms of a vector H1
+//               and an RT trial space with an L2 test space, with the default
+//               (linked list) assembly and with UsePrecomputedSparsity(). The
+//               matrices are compared through their action on a random
+//               vector.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+double RelErr(const Vector &y_csr, const Vector &y)
+{
+   Vector d(y_csr);
+   d -= y;
+   return d.Normlinf()/y.Normlinf();
+}
+
+int main()
+{
+   const char *mesh_files[] = { "../data/star.mesh", "../data/fichera.mesh" };
+   ConstantCoefficient one(1.0);
+   int failed = 0;
+
+   for (int m = 0; m < 2; m++)
+   {
+      ifstream imesh(mesh_files[m]);
+      Mesh mesh(imesh, 1, 1);
+      const int dim = mesh.Dimension();
+
+      H1_FECollection h1_fec(2, dim);
+      RT_FECollection rt_fec(1, dim);
+      L2_FECollection l2_fec(1, dim);
+      FiniteElementSpace rt_fes(&mesh, &rt_fec), l2_fes(&mesh, &l2_fec);
+
+      for (int ordering = 0; ordering <= 1; ordering++)
+      {
+         FiniteElementSpace h1_fes(&mesh, &h1_fec, dim, ordering);
+
+         BilinearForm a(&h1_fes), a_csr(&h1_fes);
+         a.AddDomainIntegrator(new VectorDiffusionIntegrator(one));
+         a_csr.AddDomainIntegrator(new VectorDiffusionIntegrator(one));
+         a_csr.UsePrecomputedSparsity();
+         a.Assemble();
+         a.Finalize();
+         a_csr.Assemble();
+         a_csr.Finalize();
+
+         Vector x(h1_fes.GetVSize()), y(h1_fes.GetVSize());
+         Vector y_csr(h1_fes.GetVSize());
+         x.Randomize(1);
+         a.Mult(x, y);
+         a_csr.Mult(x, y_csr);
+         double err = RelErr(y_csr, y);
+         cout << mesh_files[m] << ", vector diffusion, ordering " << ordering
+              << ": relative error = " << err << endl;
+         if (err > 1e-12)
+            failed = 1;
+
+         MixedBilinearForm b(&h1_fes, &l2_fes), b_csr(&h1_fes, &l2_fes);
+         b.AddDomainIntegrator(new VectorDivergenceIntegrator(one));
+         b_csr.AddDomainIntegrator(new VectorDivergenceIntegrator(one));
+         b_csr.UsePrecomputedSparsity();
+         b.Assemble();
+         b.Finalize();
+         b_csr.Assemble();
+         b_csr.Finalize();
+
+         y.SetSize(l2_fes.GetVSize());
+         y_csr.SetSize(l2_fes.GetVSize());
+         b.Mult(x, y);
+         b_csr.Mult(x, y_csr);
+         err = RelErr(y_csr, y);
+         cout << mesh_files[m] << ", mixed H1 divergence, ordering "
+              << ordering << ": relative error = " << err << endl;
+         if (err > 1e-12)
+            failed = 1;
+      }
+
+      MixedBilinearForm b(&rt_fes, &l2_fes), b_csr(&rt_fes, &l2_fes);
+      b.AddDomainIntegrator(new VectorFEDivergenceIntegrator(one));
+      b_csr.AddDomainIntegrator(new VectorFEDivergenceIntegrator(one));
+      b_csr.UsePrecomputedSparsity();
+      b.Assemble();
+      b.Finalize();
+      b_csr.Assemble();
+      b_csr.Finalize();
+
+      Vector x(rt_fes.GetVSize()), y(l2_fes.GetVSize());
+      Vector y_csr(l2_fes.GetVSize());
+      x.Randomize(1);
+      b.Mult(x, y);
+      b_csr.Mult(x, y_csr);
+      double err = RelErr(y_csr, y);
+      cout << mesh_files[m] << ", mixed RT divergence: relative error = "
+           << err << endl;
+      if (err > 1e-12)
+         failed = 1;
+   }
+
+   return failed;
+}
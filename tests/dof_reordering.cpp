@@ -0,0 +1,102 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: reordering of the dofs of a FiniteElementSpace
+//
+// Compile with: make dof_reordering
+//
+// Description:  Computes the L2 projection of a function on an H1 space with
+//               the natural, the reverse Cuthill-McKee (RCM), and the
+//               Hilbert-curve numbering of the dofs. The projection errors
+//               must agree, and the RCM numbering must not increase the
+//               bandwidth of the mass matrix.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double f(Vector &x)
+{
+   return sin(2.0*x(0))*cos(3.0*x(1));
+}
+
+int Bandwidth(const SparseMatrix &A)
+{
+   const int *I = A.GetI(), *J = A.GetJ();
+   int bw = 0;
+   for (int i = 0; i < A.Size(); i++)
+      for (int j = I[i]; j < I[i+1]; j++)
+         bw = max(bw, abs(J[j] - i));
+   return bw;
+}
+
+// L2 projection of f; returns the L2 error and the mass matrix bandwidth
+double Project(FiniteElementSpace &fes, int &bw)
+{
+   FunctionCoefficient fc(f);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(fc));
+   b.Assemble();
+   BilinearForm m(&fes);
+   m.AddDomainIntegrator(new MassIntegrator);
+   m.Assemble();
+   m.Finalize();
+   bw = Bandwidth(m.SpMat());
+
+   GridFunction x(&fes);
+   x = 0.0;
+   DSmoother D(m.SpMat());
+   PCG(m.SpMat(), D, b, x, 0, 1000, 1e-24, 0.0);
+   return x.ComputeL2Error(fc);
+}
+
+int main()
+{
+   const char *mesh_files[] = { "../data/star.mesh", "../data/fichera.mesh" };
+   const char *name[] = { "natural", "RCM", "Hilbert" };
+   int failed = 0;
+
+   for (int m = 0; m < 2; m++)
+   {
+      ifstream imesh(mesh_files[m]);
+      Mesh mesh(imesh, 1, 1);
+      if (mesh.Dimension() == 2)
+         mesh.UniformRefinement();
+      H1_FECollection fec(2, mesh.Dimension());
+
+      double err[3];
+      int bw[3];
+      for (int k = 0; k < 3; k++)
+      {
+         FiniteElementSpace fes(&mesh, &fec);
+         if (k == 1)
+            fes.ReorderDofsRCM();
+         else if (k == 2)
+         {
+            Array<int> ordering;
+            mesh.GetHilbertElementOrdering(ordering);
+            fes.ReorderDofsByElements(ordering);
+         }
+         err[k] = Project(fes, bw[k]);
+         cout << mesh_files[m] << ", " << name[k] << " ordering: L2 error = "
+              << err[k] << ", bandwidth = " << bw[k] << endl;
+      }
+      if (fabs(err[1] - err[0]) > 1e-8*err[0] ||
+          fabs(err[2] - err[0]) > 1e-8*err[0] || bw[1] > bw[0])
+         failed = 1;
+   }
+
+   return failed;
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: DofToQuad tables of the tensor-product elements
+//
+// Compile with: make dof_to_quad
+//
+// Description:  Compares the DofToQuad::FULL tables (computed by sum
+//               factorization) and the DofToQuad::TENSOR 1D factors of the
+//               H1 and L2 quadrilateral and hexahedral elements with the
+//               values of CalcShape() and CalcDShape(), on tensor-product
+//               rules and on a perturbed rule (which must not be treated as
+//               a tensor rule). The tables of the perturbed (local) rule
+//               must not be cached, see FiniteElement::NewDofToQuad().
+
+#include "mfem.hpp"
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Max difference between the FULL tables and CalcShape()/CalcDShape()
+double CheckFull(const FiniteElement &fe, const IntegrationRule &ir,
+                 const DofToQuad &d2q)
+{
+   const int dof = fe.GetDof(), dim = fe.GetDim();
+   Vector shape(dof);
+   DenseMatrix dshape(dof, dim);
+   double err = 0.0;
+   for (int q = 0; q < ir.GetNPoints(); q++)
+   {
+      fe.CalcShape(ir.IntPoint(q), shape);
+      fe.CalcDShape(ir.IntPoint(q), dshape);
+      for (int i = 0; i < dof; i++)
+      {
+         err = fmax(err, fabs(d2q.B(q,i) - shape(i)));
+         for (int d = 0; d < dim; d++)
+            err = fmax(err, fabs(d2q.G(i,d,q) - dshape(i,d)));
+      }
+   }
+   return err;
+}
+
+// Max difference between the products of the TENSOR factors and CalcShape()
+// and CalcDShape()
+double CheckTensor(const FiniteElement &fe, const IntegrationRule &ir)
+{
+   const TensorBasisElement &tfe = dynamic_cast<const TensorBasisElement &>(fe);
+   const DofToQuad &d2q = fe.GetDofToQuad(ir, DofToQuad::TENSOR);
+   const Array<int> &dof_map = tfe.GetDofMap();
+   const int dof = fe.GetDof(), dim = fe.GetDim();
+   const int nd1 = d2q.ndof, nq1 = d2q.nqpt;
+   const DenseMatrix &B = d2q.B;
+   const DenseTensor &G = d2q.G;
+   Vector shape(dof);
+   DenseMatrix dshape(dof, dim);
+   double err = 0.0;
+   for (int q = 0; q < ir.GetNPoints(); q++)
+   {
+      const int qi[3] = { q % nq1, (q / nq1) % nq1, q / (nq1*nq1) };
+      fe.CalcShape(ir.IntPoint(q), shape);
+      fe.CalcDShape(ir.IntPoint(q), dshape);
+      for (int l = 0; l < dof; l++)
+      {
+         const int li[3] = { l % nd1, (l / nd1) % nd1, l / (nd1*nd1) };
+         const int i = (dof_map.Size() > 0) ? dof_map[l] : l;
+         double b = 1.0, g[3] = { 1.0, 1.0, 1.0 };
+         for (int d = 0; d < dim; d++)
+         {
+            b *= B(qi[d],li[d]);
+            for (int e = 0; e < dim; e++)
+               g[e] *= (e == d) ? G(qi[d],li[d],0) : B(qi[d],li[d]);
+         }
+         err = fmax(err, fabs(b - shape(i)));
+         for (int d = 0; d < dim; d++)
+            err = fmax(err, fabs(g[d] - dshape(i,d)));
+      }
+   }
+   return err;
+}
+
+int main()
+{
+   int failed = 0;
+
+   for (int p = 1; p <= 4; p++)
+   {
+      FiniteElement *fe[4] =
+      {
+         new H1_QuadrilateralElement(p), new H1_HexahedronElement(p),
+         new L2_QuadrilateralElement(p), new L2_HexahedronElement(p)
+      };
+      const char *name[4] = { "H1 quad", "H1 hex", "L2 quad", "L2 hex" };
+
+      for (int k = 0; k < 4; k++)
+      {
+         const IntegrationRule &ir =
+            IntRules.Get(fe[k]->GetGeomType(), 2*p+1);
+
+         // perturbed points and weights of ir, not a tensor product
+         IntegrationRule ir_nt(ir.GetNPoints());
+         for (int q = 0; q < ir.GetNPoints(); q++)
+         {
+            IntegrationPoint &ip = ir_nt.IntPoint(q);
+            ip = ir.IntPoint(q);
+            ip.x = 0.99*ip.x + 0.005*(q % 3);
+            ip.weight *= 1.0 + 0.1*(q % 3) - 0.1*(q % 2);
+         }
+
+         const DofToQuad &d2q = fe[k]->GetDofToQuad(ir, DofToQuad::FULL);
+         DofToQuad *d2q_nt = fe[k]->NewDofToQuad(ir_nt, DofToQuad::FULL);
+         double err_full = CheckFull(*fe[k], ir, d2q);
+         double err_tensor = CheckTensor(*fe[k], ir);
+         double err_nt = CheckFull(*fe[k], ir_nt, *d2q_nt);
+         delete d2q_nt;
+         if (fe[k]->GetFullDofToQuad(ir) != &d2q ||
+             fe[k]->GetFullDofToQuad(ir_nt) != NULL)
+         {
+            cout << name[k] << ", order " << p << ": wrong caching" << endl;
+            failed = 1;
+         }
+         cout << name[k] << ", order " << p << ": FULL error = " << err_full
+              << ", TENSOR error = " << err_tensor
+              << ", non-tensor rule error = " << err_nt << endl;
+         if (err_full > 1e-12 || err_tensor > 1e-12 || err_nt > 1e-12)
+            failed = 1;
+      }
+
+      for (int k = 0; k < 4; k++)
+         delete fe[k];
+   }
+
+   return failed;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: reuse of the element matrices of translated elements
+//
+// Compile with: make elmat_reuse
+//
+// Description:  Assembles H1 diffusion-mass forms with piecewise constant
+//               coefficients, and an H(curl) form in 3D, with and without
+//               BilinearForm::UseElementMatrixReuse() on structured 2D and 3D
+//               meshes, a curved mesh and a NURBS mesh. The matrices must
+//               agree, and the structured meshes must have few groups of
+//               similar elements while the curved mesh has one per element.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Access to the groups of similar elements
+class ReuseCheck : public BilinearForm
+{
+public:
+   ReuseCheck(FiniteElementSpace *f) : BilinearForm(f) { }
+   int NumGroups()
+   {
+      Table groups;
+      GroupSimilarElements(groups);
+      return groups.Size();
+   }
+};
+
+// Relative difference of the matrices of the two forms
+double Difference(BilinearForm &a, BilinearForm &b)
+{
+   const int n = a.Size();
+   Vector x(n), ya(n), yb(n);
+   x.Randomize(1);
+   a.Mult(x, ya);
+   b.Mult(x, yb);
+   yb -= ya;
+   return yb.Normlinf()/ya.Normlinf();
+}
+
+int main()
+{
+   Mesh *mesh[6];
+   const char *name[] =
+   {
+      "quadrilaterals", "triangles", "hexahedra", "tetrahedra",
+      "curved quadrilaterals", "NURBS"
+   };
+   mesh[0] = new Mesh(8, 8, Element::QUADRILATERAL, 1, 2.0, 1.0);
+   mesh[1] = new Mesh(8, 8, Element::TRIANGLE, 1);
+   mesh[2] = new Mesh(3, 3, 3, Element::HEXAHEDRON, 1);
+   mesh[3] = new Mesh(2, 2, 2, Element::TETRAHEDRON, 1);
+   ifstream imesh1("../data/star-q2.mesh");
+   mesh[4] = new Mesh(imesh1, 1, 1);
+   ifstream imesh2("../data/square-disc-nurbs.mesh");
+   mesh[5] = new Mesh(imesh2, 1, 1);
+   mesh[0]->UniformRefinement();
+   mesh[3]->UniformRefinement();
+   mesh[4]->UniformRefinement();
+
+   int failed = 0;
+   for (int m = 0; m < 6; m++)
+   {
+      // two attributes, in stripes
+      for (int e = 0; e < mesh[m]->GetNE(); e++)
+      {
+         Array<int> v;
+         mesh[m]->GetElementVertices(e, v);
+         double x0 = mesh[m]->GetVertex(v[0])[0];
+         mesh[m]->GetElement(e)->SetAttribute((x0 < 0.5) ? 1 : 2);
+      }
+      mesh[m]->SetAttributes();
+      const int dim = mesh[m]->Dimension();
+
+      Vector coeffs(2);
+      coeffs(0) = 1.0;
+      coeffs(1) = 10.0;
+      PWConstCoefficient pw(coeffs);
+      ConstantCoefficient one(1.0);
+      H1_FECollection h1(2, dim);
+      ND_FECollection nd(1, dim);
+      FiniteElementSpace h1_fes(mesh[m], &h1);
+      FiniteElementSpace nd_fes(mesh[m], &nd);
+
+      int groups = 0;
+      double err = 0.0;
+      for (int space = 0; space < 2; space++)
+      {
+         // H(curl) on the hexahedra (the 2D curls are not implemented)
+         if (space == 1 && m != 2)
+            continue;
+         FiniteElementSpace *fes = space ? &nd_fes : &h1_fes;
+         ReuseCheck a(fes), b(fes);
+         for (int k = 0; k < 2; k++)
+         {
+            BilinearForm &f = k ? (BilinearForm &)b : (BilinearForm &)a;
+            if (space == 0)
+            {
+               f.AddDomainIntegrator(new DiffusionIntegrator(pw));
+               f.AddDomainIntegrator(new MassIntegrator(one));
+            }
+            else
+            {
+               f.AddDomainIntegrator(new CurlCurlIntegrator(pw));
+               f.AddDomainIntegrator(new VectorFEMassIntegrator(one));
+            }
+         }
+         b.UseElementMatrixReuse();
+         a.Assemble();
+         b.Assemble();
+         a.Finalize();
+         b.Finalize();
+         err = fmax(err, Difference(a, b));
+         if (space == 0)
+            groups = b.NumGroups();
+      }
+
+      const int ne = mesh[m]->GetNE();
+      cout << name[m] << ": " << ne << " elements, " << groups
+           << " groups, relative difference = " << err << endl;
+      // the refined tetrahedra have many vertex orderings
+      const bool grouped = (m < 4) ? (4*groups <= ne) : (m == 4) ?
+                           (groups == ne) : true;
+      if (err > 1e-13 || !grouped)
+         failed = 1;
+   }
+
+   for (int m = 0; m < 6; m++)
+      delete mesh[m];
+
+   return failed;
+}
@@ -0,0 +1,144 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: fused Vector kernels and the Krylov solvers using them
+//
+// Compile with: make fused_kernels
+//
+// Description:  Compares Vector::AddAndDot(), Vector::SetAndDot() and the
+//               three-term add() with the equivalent sequences of single
+//               operations, also when the output aliases an input. Then
+//               solves a diffusion-reaction system with CG, BiCGSTAB and
+//               MINRES (with and without a Jacobi preconditioner), which must
+//               all converge to the same solution.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double Diff(const Vector &x, const Vector &y)
+{
+   Vector d(x);
+   d -= y;
+   return d.Normlinf();
+}
+
+bool CheckKernels()
+{
+   const int n = 1001;
+   const double a = 0.7, b = -1.3, c = 2.1;
+   Vector x(n), y(n), z(n), w(n), w_ref(n), t(n);
+   x.Randomize(1);
+   y.Randomize(2);
+   z.Randomize(3);
+   bool ok = true;
+
+   // w += a x, (w, z) and (w, w)
+   w = y;
+   w_ref = y;
+   w_ref.Add(a, x);
+   double dot = w.AddAndDot(a, x, z);
+   ok = ok && Diff(w, w_ref) == 0.0 && fabs(dot - w_ref*z) < 1e-12*n;
+   w = y;
+   dot = w.AddAndDot(a, x, w);
+   ok = ok && Diff(w, w_ref) == 0.0 && fabs(dot - w_ref*w_ref) < 1e-12*n;
+
+   // w = a x + b y, (w, z) and (w, w); also with w = x
+   add(a, x, b, y, w_ref);
+   dot = w.SetAndDot(a, x, b, y, z);
+   ok = ok && Diff(w, w_ref) < 1e-15 && fabs(dot - w_ref*z) < 1e-12*n;
+   dot = w.SetAndDot(a, x, b, y, w);
+   ok = ok && Diff(w, w_ref) < 1e-15 && fabs(dot - w_ref*w_ref) < 1e-12*n;
+   w = x;
+   dot = w.SetAndDot(a, w, b, y, w);
+   ok = ok && Diff(w, w_ref) < 1e-15 && fabs(dot - w_ref*w_ref) < 1e-12*n;
+
+   // w = a x + b y + c z; also with w = y
+   add(a, x, b, y, t);
+   add(1.0, t, c, z, w_ref);
+   add(a, x, b, y, c, z, w);
+   ok = ok && Diff(w, w_ref) < 1e-14;
+   w = y;
+   add(a, x, b, w, c, z, w);
+   ok = ok && Diff(w, w_ref) < 1e-14;
+
+   cout << "Vector kernels: " << (ok ? "OK" : "WRONG") << endl;
+   return ok;
+}
+
+int main()
+{
+   int failed = CheckKernels() ? 0 : 1;
+
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new MassIntegrator(one));
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+
+   const int n = A.Size();
+   Vector b(n), x_ref(n), x(n), r(n);
+   b.Randomize(1);
+   DSmoother jacobi(A);
+
+   // reference solution
+   CGSolver ref;
+   ref.SetRelTol(1e-14);
+   ref.SetMaxIter(5000);
+   ref.SetPrintLevel(-1);
+   ref.SetOperator(A);
+   x_ref = 0.0;
+   ref.Mult(b, x_ref);
+
+   const char *name[] = { "CG", "BiCGSTAB", "MINRES" };
+   for (int pc = 0; pc <= 1; pc++)
+      for (int k = 0; k < 3; k++)
+      {
+         CGSolver cg;
+         BiCGSTABSolver bicgstab;
+         MINRESSolver minres;
+         IterativeSolver *solver[] = { &cg, &bicgstab, &minres };
+         IterativeSolver &s = *solver[k];
+         s.SetRelTol(1e-10);
+         s.SetMaxIter(2000);
+         s.SetPrintLevel(-1);
+         if (pc)
+            s.SetPreconditioner(jacobi);
+         s.SetOperator(A);
+         x = 0.0;
+         s.Mult(b, x);
+
+         A.Mult(x, r);
+         subtract(b, r, r);
+         const double res = r.Norml2()/b.Norml2();
+         const double err = Diff(x, x_ref)/x_ref.Normlinf();
+         cout << (pc ? "Jacobi-" : "") << name[k] << ": "
+              << s.GetNumIterations() << " iterations, relative residual = "
+              << res << ", difference from the reference = " << err << endl;
+         if (!s.GetConverged() || res > 1e-8 || err > 1e-6)
+            failed = 1;
+      }
+
+   return failed;
+}
@@ -0,0 +1,276 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: cached geometric factors of a mesh
+//
+// Compile with: make geometric_factors
+//
+// Description:  Compares the coordinates, Jacobians, inverse Jacobians and
+//               determinants from Mesh::GetGeometricFactors() with the element
+//               transformations on straight, curved, surface, NURBS and 3D
+//               meshes. Checks that the requested data is accumulated over
+//               calls, and that the cache is refreshed after the nodes are
+//               moved, transformed or edited directly (with and without
+//               NodesUpdated()), after refinement and when the points of the
+//               rule change. The matrices of the Mass, Diffusion and
+//               Convection integrators assembled by BilinearForm (which uses
+//               the cached factors) are compared with the element matrices
+//               computed from the element transformations.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+const int ALL = GeometricFactors::COORDINATES | GeometricFactors::JACOBIANS |
+                GeometricFactors::INVERSE_JACOBIANS |
+                GeometricFactors::DETERMINANTS;
+
+// Max difference between the computed factors and the transformations
+double FactorsError(Mesh &mesh, const GeometricFactors &geom)
+{
+   const IntegrationRule &ir = *geom.IntRule;
+   const int nq = ir.GetNPoints(), dim = geom.dim, sdim = geom.sdim;
+   const int sd = sdim*dim;
+   const bool x = geom.computed & GeometricFactors::COORDINATES;
+   const bool j = geom.computed & GeometricFactors::JACOBIANS;
+   const bool ij = geom.computed & GeometricFactors::INVERSE_JACOBIANS;
+   const bool d = geom.computed & GeometricFactors::DETERMINANTS;
+   double err = 0.0;
+   Vector xq;
+   DenseMatrix InvJq;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation *T = mesh.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const int eq = e*nq + q;
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T->Transform(ip, xq);
+         T->SetIntPoint(&ip);
+         const DenseMatrix &Jq = T->Jacobian();
+         InvJq.SetSize(dim, sdim);
+         CalcInverse(Jq, InvJq);
+         for (int k = 0; x && k < sdim; k++)
+            err = fmax(err, fabs(geom.X(eq*sdim + k) - xq(k)));
+         for (int k = 0; j && k < sd; k++)
+            err = fmax(err, fabs(geom.J(eq*sd + k) - Jq.Data()[k]));
+         for (int k = 0; ij && k < sd; k++)
+            err = fmax(err, fabs(geom.InvJ(eq*sd + k) - InvJq.Data()[k]));
+         if (d)
+            err = fmax(err, fabs(geom.detJ(eq) - T->Weight()));
+      }
+   }
+   return err;
+}
+
+void Scale(const Vector &x, Vector &y)
+{
+   y = x;
+   y *= 2.0;
+}
+
+void Velocity(const Vector &x, Vector &v)
+{
+   v.SetSize(x.Size());
+   for (int d = 0; d < x.Size(); d++)
+      v(d) = 1.0 + d - x(d)*x(d);
+}
+
+double Kappa(Vector &x)
+{
+   return 1.0 + x(0)*x(0);
+}
+
+void AddIntegrators(BilinearForm &a, Coefficient &kappa,
+                    VectorCoefficient &vel)
+{
+   a.AddDomainIntegrator(new MassIntegrator(kappa));
+   a.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   a.AddDomainIntegrator(new ConvectionIntegrator(vel));
+}
+
+// Relative difference between the matrix assembled by BilinearForm and the
+// sum of the element matrices of its integrators, computed without the cached
+// geometric factors
+double AssemblyError(FiniteElementSpace &fes)
+{
+   FunctionCoefficient kappa(Kappa);
+   VectorFunctionCoefficient vel(fes.GetMesh()->SpaceDimension(), Velocity);
+   BilinearForm a(&fes), a_ref(&fes);
+   AddIntegrators(a, kappa, vel);
+   AddIntegrators(a_ref, kappa, vel);
+   a.Assemble();
+   a.Finalize();
+
+   SparseMatrix A_ref(fes.GetVSize());
+   Array<BilinearFormIntegrator*> &integs = *a_ref.GetDBFI();
+   DenseMatrix elmat;
+   Array<int> vdofs;
+   for (int e = 0; e < fes.GetNE(); e++)
+   {
+      fes.GetElementVDofs(e, vdofs);
+      for (int k = 0; k < integs.Size(); k++)
+      {
+         integs[k]->AssembleElementMatrix(*fes.GetFE(e),
+                                          *fes.GetElementTransformation(e),
+                                          elmat);
+         A_ref.AddSubMatrix(vdofs, vdofs, elmat);
+      }
+   }
+   A_ref.Finalize();
+
+   Vector x(fes.GetVSize()), y(fes.GetVSize()), y_ref(fes.GetVSize());
+   x.Randomize(1);
+   a.Mult(x, y);
+   A_ref.Mult(x, y_ref);
+   y -= y_ref;
+   return y.Normlinf()/y_ref.Normlinf();
+}
+
+int main()
+{
+   const char *mesh_file[] =
+   {
+      "../data/star.mesh", "../data/star-q2.mesh", "../data/star-surf.mesh",
+      "../data/square-disc-nurbs.mesh", "../data/fichera-q2.mesh"
+   };
+   int failed = 0;
+
+   for (int m = 0; m < 5; m++)
+   {
+      ifstream imesh(mesh_file[m]);
+      Mesh mesh(imesh, 1, 1);
+      if (m < 4)
+         mesh.UniformRefinement();
+      const int geom_type = mesh.GetElementBaseGeometry(0);
+      const IntegrationRule &ir = IntRules.Get(geom_type, 5);
+
+      // the data is accumulated over the calls
+      const GeometricFactors &gx =
+         mesh.GetGeometricFactors(ir, GeometricFactors::COORDINATES);
+      const double err_x = FactorsError(mesh, gx);
+      const GeometricFactors &geom = mesh.GetGeometricFactors(
+         ir, GeometricFactors::JACOBIANS | GeometricFactors::DETERMINANTS);
+      const bool accumulated =
+         (geom.computed & GeometricFactors::COORDINATES) &&
+         (&mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS) ==
+          &geom);
+      const GeometricFactors &gall = mesh.GetGeometricFactors(ir, ALL);
+      const double err = fmax(err_x, FactorsError(mesh, gall));
+
+      cout << mesh_file[m] << ": " << gall.NE << " elements, " << gall.NQ
+           << " points, max error = " << err << ", data accumulated: "
+           << (accumulated ? "yes" : "no") << endl;
+      if (err > 1e-12 || !accumulated || gall.computed != ALL)
+         failed = 1;
+   }
+
+   // invalidation of the cache
+   ifstream imesh("../data/star-q2.mesh");
+   Mesh *mesh = new Mesh(imesh, 1, 1);
+   H1_FECollection fec3(3, mesh->Dimension());
+   FiniteElementSpace *fes3 = NULL;
+   const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 5);
+   const char *name[] =
+   {
+      "Transform", "MoveNodes", "edited nodes + NodesUpdated",
+      "edited nodes", "UniformRefinement", "SetNodalFESpace (cubic)"
+   };
+   for (int k = 0; k < 6; k++)
+   {
+      mesh->GetGeometricFactors(ir, ALL);
+      switch (k)
+      {
+      case 0: mesh->Transform(Scale); break;
+      case 1:
+      {
+         Vector disp(mesh->GetNodes()->Size());
+         disp.Randomize(1);
+         disp *= 0.01;
+         mesh->MoveNodes(disp);
+         break;
+      }
+      case 2:
+      case 3:
+      {
+         GridFunction &nodes = *mesh->GetNodes();
+         for (int i = 0; i < nodes.Size(); i++)
+            nodes(i) += 0.01*sin(3.0*i + k);
+         if (k == 2)
+            mesh->NodesUpdated();
+         break;
+      }
+      case 4: mesh->UniformRefinement(); break;
+      case 5:
+         fes3 = new FiniteElementSpace(mesh, &fec3, mesh->SpaceDimension());
+         mesh->SetNodalFESpace(fes3);
+         break;
+      }
+      const GeometricFactors &geom = mesh->GetGeometricFactors(ir, ALL);
+      double err = FactorsError(*mesh, geom);
+      if (geom.NE != mesh->GetNE())
+         err = 1.0;
+      cout << "after " << name[k] << ": max error = " << err << endl;
+      if (err > 1e-12)
+         failed = 1;
+   }
+
+   // a rule with different points at the same address
+   {
+      IntegrationRule ir_loc(ir.GetNPoints());
+      for (int q = 0; q < ir.GetNPoints(); q++)
+         ir_loc.IntPoint(q) = ir.IntPoint(q);
+      mesh->GetGeometricFactors(ir_loc, ALL);
+      for (int q = 0; q < ir.GetNPoints(); q++)
+         ir_loc.IntPoint(q).x *= 0.5;
+      double err = FactorsError(*mesh, mesh->GetGeometricFactors(ir_loc, ALL));
+      cout << "changed rule: max error = " << err << endl;
+      if (err > 1e-12)
+         failed = 1;
+   }
+
+   // element assembly with the cached factors
+   for (int k = 0; k < 2; k++)
+   {
+      if (k == 1)
+      {
+         // edited nodes, without NodesUpdated()
+         GridFunction &nodes = *mesh->GetNodes();
+         for (int i = 0; i < nodes.Size(); i++)
+            nodes(i) += 0.01*cos(2.0*i);
+      }
+      FiniteElementSpace fes(mesh, &fec3);
+      double err = AssemblyError(fes);
+      cout << "element assembly" << (k ? " after edited nodes" : "")
+           << ": relative error = " << err << endl;
+      if (err > 1e-12)
+         failed = 1;
+   }
+   {
+      ifstream imesh3("../data/fichera-q2.mesh");
+      Mesh mesh3(imesh3, 1, 1);
+      H1_FECollection fec2(2, 3);
+      FiniteElementSpace fes(&mesh3, &fec2);
+      double err = AssemblyError(fes);
+      cout << "element assembly (3D): relative error = " << err << endl;
+      if (err > 1e-12)
+         failed = 1;
+   }
+
+   delete mesh;
+   delete fes3;
+
+   return failed;
+}
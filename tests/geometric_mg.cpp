@@ -0,0 +1,138 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: geometric multigrid from mesh refinement levels
+//
+// Compile with: make geometric_mg
+//
+// Description:  Solves Poisson problems with essential boundary conditions
+//               on a quadrilateral and a triangular mesh, for orders 1 and 2,
+//               with CG preconditioned by GeometricMultigrid after each
+//               uniform refinement. The preconditioner must be symmetric, it
+//               must not change the essential dofs, and the iteration counts
+//               must stay bounded as levels are added. The last level is
+//               also solved with a user smoother and coarse solver.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Relative asymmetry |(y, M x) - (x, M y)| / (|(y, M x)| + |(x, M y)|)
+double Asymmetry(const Solver &M, int n)
+{
+   Vector x(n), y(n), Mx(n), My(n);
+   x.Randomize(2);
+   y.Randomize(3);
+   M.Mult(x, Mx);
+   M.Mult(y, My);
+   const double a = y*Mx, b = x*My;
+   return fabs(a - b)/(fabs(a) + fabs(b));
+}
+
+int main()
+{
+   const char *mesh_file[] = { "../data/star.mesh", "../data/inline-tri.mesh" };
+   ConstantCoefficient one(1.0);
+   int failed = 0;
+
+   for (int m = 0; m < 2; m++)
+      for (int order = 1; order <= 2; order++)
+      {
+         ifstream imesh(mesh_file[m]);
+         Mesh mesh(imesh, 1, 1);
+         if (m == 0)
+            mesh.UniformRefinement();
+         H1_FECollection fec(order, mesh.Dimension());
+         FiniteElementSpace fes(&mesh, &fec);
+         Array<int> ess_bdr(mesh.bdr_attributes.Max());
+         ess_bdr = 1;
+
+         GeometricMultigrid mg(fes, ess_bdr);
+         int first_it = 0;
+         for (int l = 1; l <= 4; l++)
+         {
+            mg.UniformRefinement();
+
+            BilinearForm a(&fes);
+            a.AddDomainIntegrator(new DiffusionIntegrator(one));
+            a.Assemble();
+            LinearForm b(&fes);
+            b.AddDomainIntegrator(new DomainLFIntegrator(one));
+            b.Assemble();
+            GridFunction x(&fes);
+            x = 0.0;
+            a.EliminateEssentialBC(ess_bdr, x, b);
+            a.Finalize();
+            const SparseMatrix &A = a.SpMat();
+            mg.SetOperator(A);
+
+            // user smoother on the finest level and coarse solver
+            DSmoother jacobi(A, 0, 2.0/3.0, 2);
+            CGSolver coarse;
+            DSmoother coarse_jacobi;
+            if (l == 4)
+            {
+               mg.SetSmoother(mg.GetNumLevels()-1, jacobi);
+               coarse.SetRelTol(1e-14);
+               coarse.SetMaxIter(1000);
+               coarse.SetPrintLevel(-1);
+               coarse.SetPreconditioner(coarse_jacobi);
+               mg.SetCoarseSolver(coarse);
+            }
+
+            CGSolver cg;
+            cg.SetRelTol(1e-10);
+            cg.SetMaxIter(500);
+            cg.SetPrintLevel(-1);
+            cg.SetPreconditioner(mg);
+            cg.SetOperator(A);
+            cg.Mult(b, x);
+
+            Vector r(A.Size());
+            A.Mult(x, r);
+            subtract(b, r, r);
+            const double res = r.Norml2()/b.Norml2();
+            const double asym = Asymmetry(mg, A.Size());
+
+            // the default smoothers solve exactly for the essential dofs, and
+            // the coarse-grid corrections must not change them
+            Array<int> ess_dofs;
+            fes.GetEssentialVDofs(ess_bdr, ess_dofs);
+            Vector e(A.Size()), Me(A.Size());
+            e.Randomize(4);
+            mg.Mult(e, Me);
+            double ess_err = 0.0;
+            for (int i = 0; i < A.Size(); i++)
+               if (ess_dofs[i] && l < 4)
+                  ess_err = fmax(ess_err, fabs(Me(i) - e(i)/A(i,i)));
+
+            const int it = cg.GetNumIterations();
+            cout << mesh_file[m] << ", order " << order << ", "
+                 << mg.GetNumLevels() << " levels" << (l == 4 ? " (user)" : "")
+                 << ": " << A.Size() << " unknowns, " << it
+                 << " iterations, relative residual = " << res
+                 << ", asymmetry = " << asym
+                 << ", essential dofs error = " << ess_err << endl;
+            if (!cg.GetConverged() || res > 1e-6 || asym > 1e-8 ||
+                ess_err > 1e-12 || it > 40 ||
+                (l > 1 && it > first_it + 10))
+               failed = 1;
+            if (l == 1)
+               first_it = it;
+         }
+      }
+
+   return failed;
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: GMRES and FGMRES with CGS2 orthogonalization
+//
+// Compile with: make gmres_cgs2
+//
+// Description:  Solves a nonsymmetric convection-diffusion system
+//               with GMRESSolver and FGMRESSolver for several restart lengths,
+//               without a preconditioner, with Jacobi, and (FGMRES only) with
+//               a few inner GMRES iterations as a variable preconditioner.
+//               Every solve must converge to the reference solution, and a
+//               longer restart must not need more iterations.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+
+   ConstantCoefficient one(1.0);
+   Vector vel(2);
+   vel(0) = 2.0;
+   vel(1) = 1.0;
+   VectorConstantCoefficient velocity(vel);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new MassIntegrator(one));
+   a.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+
+   const int n = A.Size();
+   Vector b(n), x_ref(n), x(n), r(n);
+   b.Randomize(1);
+   DSmoother jacobi(A);
+
+   // reference solution: unrestarted GMRES with a tight tolerance
+   GMRESSolver ref;
+   ref.SetKDim(n);
+   ref.SetRelTol(1e-14);
+   ref.SetMaxIter(n);
+   ref.SetPrintLevel(-1);
+   ref.SetOperator(A);
+   x_ref = 0.0;
+   ref.Mult(b, x_ref);
+
+   // variable preconditioner: a few Jacobi-GMRES iterations
+   GMRESSolver inner;
+   inner.SetKDim(5);
+   inner.SetMaxIter(5);
+   inner.SetRelTol(0.0);
+   inner.SetPrintLevel(-1);
+   inner.iterative_mode = false;
+   inner.SetPreconditioner(jacobi);
+   inner.SetOperator(A);
+
+   const int kdim[] = { 10, 40, 400 };
+   const char *pc_name[] = { "", "Jacobi-", "GMRES-" };
+   int failed = 0;
+
+   for (int k = 0; k < 2; k++)
+      for (int pc = 0; pc < (k == 0 ? 2 : 3); pc++)
+      {
+         int prev_it = 0;
+         for (int m = 0; m < 3; m++)
+         {
+            GMRESSolver gmres;
+            FGMRESSolver fgmres;
+            IterativeSolver &s = (k == 0) ? (IterativeSolver &)gmres : fgmres;
+            if (k == 0)
+               gmres.SetKDim(kdim[m]);
+            else
+               fgmres.SetKDim(kdim[m]);
+            s.SetRelTol(1e-10);
+            s.SetMaxIter(5000);
+            s.SetPrintLevel(-1);
+            if (pc == 1)
+               s.SetPreconditioner(jacobi);
+            s.SetOperator(A);
+            // set after SetOperator(), which would reset the inner solver
+            if (pc == 2)
+               s.SetPreconditioner(inner);
+            x = 0.0;
+            s.Mult(b, x);
+
+            A.Mult(x, r);
+            subtract(b, r, r);
+            const double res = r.Norml2()/b.Norml2();
+            r = x;
+            r -= x_ref;
+            const double err = r.Normlinf()/x_ref.Normlinf();
+            const int it = s.GetNumIterations();
+            cout << pc_name[pc] << (k == 0 ? "GMRES(" : "FGMRES(")
+                 << kdim[m] << "): " << it
+                 << " iterations, relative residual = " << res
+                 << ", difference from the reference = " << err << endl;
+            if (!s.GetConverged() || res > 1e-8 || err > 1e-6 ||
+                (m > 0 && it > prev_it))
+               failed = 1;
+            prev_it = it;
+         }
+      }
+
+   return failed;
+}
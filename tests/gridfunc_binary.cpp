@@ -0,0 +1,120 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: binary Vector, GridFunction and DataCollection output
+//
+// Compile with: make gridfunc_binary
+//
+// Description:  Round-trips a Vector through PrintBinary()/LoadBinary(), a
+//               scalar H1 and a vector RT GridFunction through SaveBinary()
+//               and the stream GridFunction constructor (checking the byte
+//               order mark after the 'binary' line), and a
+//               VisItDataCollection saved in BINARY_FORMAT through Load(). All
+//               values must be reproduced exactly.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace mfem;
+
+// Max difference between two vectors, or -1 if the sizes differ
+double Diff(const Vector &x, const Vector &y)
+{
+   if (x.Size() != y.Size())
+      return -1.0;
+   Vector d(x);
+   d -= y;
+   return d.Normlinf();
+}
+
+int main()
+{
+   ifstream imesh("../data/escher-p2.mesh");
+   Mesh mesh(imesh, 1, 1);
+   const int dim = mesh.Dimension();
+   int failed = 0;
+
+   Vector v(1000), v_bin;
+   v.Randomize(1);
+   ostringstream vout;
+   v.PrintBinary(vout);
+   istringstream vin(vout.str());
+   v_bin.LoadBinary(vin, v.Size());
+   double err = Diff(v, v_bin);
+   cout << "Vector: max difference = " << err << endl;
+   if (err != 0.0)
+      failed = 1;
+
+   H1_FECollection h1_fec(3, dim);
+   RT_FECollection rt_fec(1, dim);
+   FiniteElementSpace h1_fes(&mesh, &h1_fec), rt_fes(&mesh, &rt_fec);
+   GridFunction u(&h1_fes), w(&rt_fes);
+   u.Randomize(2);
+   w.Randomize(3);
+
+   GridFunction *gf[2] = { &u, &w };
+   const char *name[2] = { "u", "w" };
+   for (int k = 0; k < 2; k++)
+   {
+      ostringstream out;
+      gf[k]->SaveBinary(out);
+      const string data = out.str();
+      const size_t pos = data.find("binary\n") + 7;
+      int bom = 0;
+      if (pos + sizeof(bom) <= data.size())
+         data.copy(reinterpret_cast<char *>(&bom), sizeof(bom), pos);
+      if (bom != 1)
+      {
+         cout << "GridFunction " << name[k] << ": missing byte order mark"
+              << endl;
+         failed = 1;
+      }
+      istringstream in(data);
+      GridFunction gf_bin(&mesh, in);
+      err = Diff(*gf[k], gf_bin);
+      cout << "GridFunction " << name[k] << ": max difference = " << err
+           << endl;
+      if (err != 0.0)
+         failed = 1;
+   }
+
+   VisItDataCollection dc("GridFunctionBinary", &mesh);
+   dc.SetFormat(DataCollection::BINARY_FORMAT);
+   dc.RegisterField("u", &u);
+   dc.RegisterField("w", &w);
+   dc.Save();
+   if (dc.Error())
+   {
+      cout << "VisItDataCollection: Save() failed" << endl;
+      return 1;
+   }
+
+   VisItDataCollection dc_in("GridFunctionBinary");
+   dc_in.Load();
+   if (dc_in.Error())
+   {
+      cout << "VisItDataCollection: Load() failed" << endl;
+      return 1;
+   }
+   for (int k = 0; k < 2; k++)
+   {
+      err = Diff(*gf[k], *dc_in.GetField(name[k]));
+      cout << "VisItDataCollection field " << name[k]
+           << ": max difference = " << err << endl;
+      if (err != 0.0)
+         failed = 1;
+   }
+
+   return failed;
+}
@@ -0,0 +1,222 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: multicolor Gauss-Seidel and ILU(k) smoothers
+//
+// Compile with: make gs_ilu_smoothers
+//
+// Description:  On a convection-diffusion matrix, checks that the coloring of
+//               MulticolorGSSmoother has no coupled rows of the same color,
+//               that its sweeps match sequential Gauss-Seidel in the color
+//               order, and that the symmetric sweep preconditions CG on a
+//               diffusion matrix. For ILUSmoother, checks that L U equals A
+//               on the pattern of A for ILU(0), that the fill grows with k and
+//               that a large k gives the exact LU solve, and that GMRES needs
+//               fewer iterations as k grows.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Access to the coloring
+class ColoringCheck : public MulticolorGSSmoother
+{
+public:
+   ColoringCheck(const SparseMatrix &a, int t) : MulticolorGSSmoother(a, t) { }
+   const Array<int> &Ptr() const { return color_ptr; }
+   const Array<int> &Rows() const { return color_rows; }
+};
+
+// Access to the factors
+class ILUCheck : public ILUSmoother
+{
+public:
+   ILUCheck(const SparseMatrix &a, int k) : ILUSmoother(a, k) { }
+
+   // (L U)(i,j), with the unit diagonal of L and the diagonal of U
+   double LU(int i, int j) const
+   {
+      double s = 0.0;
+      for (int q = IL[i]; q <= IL[i+1]; q++)
+      {
+         const int k = (q < IL[i+1]) ? JL[q] : i;
+         const double lik = (q < IL[i+1]) ? VL[q] : 1.0;
+         if (k == j)
+            s += lik/udinv(k);
+         for (int p = IU[k]; p < IU[k+1]; p++)
+            if (JU[p] == j)
+               s += lik*VU[p];
+      }
+      return s;
+   }
+};
+
+void Assemble(Mesh &mesh, int order, double conv, SparseMatrix *&A,
+              FiniteElementSpace *&fes, H1_FECollection *&fec)
+{
+   fec = new H1_FECollection(order, mesh.Dimension());
+   fes = new FiniteElementSpace(&mesh, fec);
+   ConstantCoefficient one(1.0);
+   Vector vel(2);
+   vel(0) = conv;
+   vel(1) = 0.5*conv;
+   VectorConstantCoefficient velocity(vel);
+   BilinearForm a(fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new MassIntegrator(one));
+   if (conv != 0.0)
+      a.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+   a.Assemble();
+   a.Finalize();
+   A = a.LoseMat();
+}
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+
+   SparseMatrix *A, *S;
+   FiniteElementSpace *fes, *fes_s;
+   H1_FECollection *fec, *fec_s;
+   Assemble(mesh, 2, 5.0, A, fes, fec);
+   Assemble(mesh, 2, 0.0, S, fes_s, fec_s);
+   const int n = A->Size();
+   const int *I = A->GetI(), *J = A->GetJ();
+   const double *V = A->GetData();
+
+   Vector b(n), y(n), y_ref(n), r(n);
+   b.Randomize(1);
+   int failed = 0;
+
+   // multicolor Gauss-Seidel
+   for (int type = 1; type <= 2; type++)
+   {
+      ColoringCheck gs(*A, type);
+      const Array<int> &ptr = gs.Ptr(), &rows = gs.Rows();
+      Array<int> color(n);
+      for (int c = 0; c < gs.GetNumColors(); c++)
+         for (int k = ptr[c]; k < ptr[c+1]; k++)
+            color[rows[k]] = c;
+      int conflicts = 0;
+      for (int i = 0; i < n; i++)
+         for (int k = I[i]; k < I[i+1]; k++)
+            if (J[k] != i && color[J[k]] == color[i])
+               conflicts++;
+
+      // sequential Gauss-Seidel visiting the rows in the color order
+      y_ref = 0.0;
+      for (int p = 0; p < n; p++)
+      {
+         const int i = rows[(type == 1) ? p : n-1-p];
+         double sum = b(i), d = 0.0;
+         for (int k = I[i]; k < I[i+1]; k++)
+            if (J[k] == i)
+               d = V[k];
+            else
+               sum -= V[k]*y_ref(J[k]);
+         y_ref(i) = sum/d;
+      }
+      gs.Mult(b, y);
+      y -= y_ref;
+      const double err = y.Normlinf()/y_ref.Normlinf();
+      cout << "MulticolorGS (type " << type << "): " << gs.GetNumColors()
+           << " colors, " << conflicts << " conflicts, difference from "
+           << "sequential GS = " << err << endl;
+      if (conflicts > 0 || err > 1e-12)
+         failed = 1;
+   }
+   {
+      MulticolorGSSmoother sgs(*S, 0);
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(1000);
+      cg.SetPrintLevel(-1);
+      cg.SetPreconditioner(sgs);
+      cg.SetOperator(*S);
+      y = 0.0;
+      cg.Mult(b, y);
+      cout << "MulticolorGS (symmetric) - PCG: " << cg.GetNumIterations()
+           << " iterations" << endl;
+      if (!cg.GetConverged())
+         failed = 1;
+   }
+
+   // ILU(k)
+   {
+      ILUCheck ilu0(*A, 0);
+      double err = 0.0;
+      for (int i = 0; i < n; i++)
+         for (int k = I[i]; k < I[i+1]; k++)
+            err = fmax(err, fabs(ilu0.LU(i, J[k]) - V[k]));
+      cout << "ILU(0): " << ilu0.NumNonZeroElems() << " nonzeros (A: "
+           << A->NumNonZeroElems() << "), max |LU - A| on the pattern = "
+           << err << endl;
+      if (ilu0.NumNonZeroElems() != A->NumNonZeroElems() || err > 1e-12)
+         failed = 1;
+   }
+   {
+      ILUSmoother ilu(*A, n);
+      ilu.Mult(b, y);
+      A->Mult(y, r);
+      subtract(b, r, r);
+      const double res = r.Norml2()/b.Norml2();
+      cout << "ILU(" << n << "): " << ilu.NumNonZeroElems()
+           << " nonzeros, relative residual = " << res << endl;
+      if (res > 1e-10)
+         failed = 1;
+
+      // iterative_mode: one more application does not change the solution
+      y_ref = y;
+      ilu.iterative_mode = true;
+      ilu.Mult(b, y);
+      y -= y_ref;
+      if (y.Normlinf() > 1e-10*y_ref.Normlinf())
+         failed = 1;
+   }
+   int prev_it = 0, prev_nnz = 0;
+   for (int k = 0; k <= 2; k++)
+   {
+      ILUSmoother ilu(*A, k);
+      GMRESSolver gmres;
+      gmres.SetKDim(50);
+      gmres.SetRelTol(1e-10);
+      gmres.SetMaxIter(1000);
+      gmres.SetPrintLevel(-1);
+      gmres.SetPreconditioner(ilu);
+      gmres.SetOperator(*A);
+      y = 0.0;
+      gmres.Mult(b, y);
+      const int it = gmres.GetNumIterations();
+      cout << "ILU(" << k << ") - GMRES: " << ilu.NumNonZeroElems()
+           << " nonzeros, " << it << " iterations" << endl;
+      if (!gmres.GetConverged() ||
+          (k > 0 && (it >= prev_it || ilu.NumNonZeroElems() <= prev_nnz)))
+         failed = 1;
+      prev_it = it;
+      prev_nnz = ilu.NumNonZeroElems();
+   }
+
+   delete A;
+   delete S;
+   delete fes;
+   delete fes_s;
+   delete fec;
+   delete fec_s;
+
+   return failed;
+}
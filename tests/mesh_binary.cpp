@@ -0,0 +1,60 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: binary MFEM mesh format
+//
+// Compile with: make mesh_binary
+//
+// Description:  Writes straight and curved meshes with Mesh::PrintBinary(),
+//               reads them back with the stream Mesh constructor, and checks
+//               that the ASCII output of the two meshes is identical.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace mfem;
+
+int main()
+{
+   const char *mesh_files[] =
+   {
+      "../data/star.mesh", "../data/beam-tet.mesh", "../data/fichera.mesh",
+      "../data/square-disc-p2.mesh", "../data/escher-p2.mesh"
+   };
+   int failed = 0;
+
+   for (int m = 0; m < 5; m++)
+   {
+      ifstream imesh(mesh_files[m]);
+      Mesh mesh(imesh, 1, 1);
+
+      ostringstream bin;
+      mesh.PrintBinary(bin);
+      istringstream ibin(bin.str());
+      Mesh mesh_bin(ibin, 1, 1);
+
+      ostringstream ascii, ascii_bin;
+      ascii.precision(16);
+      ascii_bin.precision(16);
+      mesh.Print(ascii);
+      mesh_bin.Print(ascii_bin);
+      const bool same = (ascii.str() == ascii_bin.str());
+      cout << mesh_files[m] << ": "
+           << (same ? "identical" : "DIFFERENT") << endl;
+      if (!same)
+         failed = 1;
+   }
+
+   return failed;
+}
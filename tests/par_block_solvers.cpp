@@ -0,0 +1,201 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: parallel block CG and block GMRES
+//
+// Compile with: make par_block_solvers
+//
+// Sample run:   mpirun -np 4 par_block_solvers
+//
+// Description:  Solves a symmetric and a nonsymmetric tridiagonal system,
+//               distributed by blocks of rows, with the parallel
+//               BlockCGSolver and BlockGMRESSolver for 1, 3 and 6 right-hand
+//               sides (one of them repeated, to exercise the removal of
+//               dependent directions), without and with a Jacobi
+//               preconditioner. The Gram matrices of the block
+//               orthonormalization are reduced over all ranks, so every
+//               column must match the serial CG/GMRES solution of the
+//               assembled global system on all ranks.
+
+#include "mfem.hpp"
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Global size of the systems and their entries; the convection term 'c'
+// makes the matrix nonsymmetric
+const int N = 2000;
+double Diag(int i) { return (1 + i%5)*(2.0 + 0.01*(1 + i%7)); }
+double Lower(double c) { return -1.0 - c; }
+double Upper(double c) { return -1.0 + c; }
+
+// The rows [first, first+height) of the tridiagonal matrix
+class ParTridiagonal : public Operator
+{
+   MPI_Comm comm;
+   int myid, num_procs, first;
+   double c;
+
+public:
+   ParTridiagonal(MPI_Comm _comm, int _first, int n, double _c)
+      : Operator(n), comm(_comm), first(_first), c(_c)
+   {
+      MPI_Comm_rank(comm, &myid);
+      MPI_Comm_size(comm, &num_procs);
+   }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      const int n = height;
+      const int left = (myid > 0) ? myid-1 : MPI_PROC_NULL;
+      const int right = (myid < num_procs-1) ? myid+1 : MPI_PROC_NULL;
+      double xl = 0.0, xr = 0.0;
+      MPI_Sendrecv(&x(n-1), 1, MPI_DOUBLE, right, 0, &xl, 1, MPI_DOUBLE,
+                   left, 0, comm, MPI_STATUS_IGNORE);
+      MPI_Sendrecv(&x(0), 1, MPI_DOUBLE, left, 1, &xr, 1, MPI_DOUBLE,
+                   right, 1, comm, MPI_STATUS_IGNORE);
+      for (int i = 0; i < n; i++)
+         y(i) = Diag(first+i)*x(i) + Lower(c)*((i > 0) ? x(i-1) : xl) +
+                Upper(c)*((i < n-1) ? x(i+1) : xr);
+   }
+};
+
+// Jacobi preconditioner for the local rows of the tridiagonal matrix
+class Jacobi : public Solver
+{
+   int first;
+
+public:
+   Jacobi(int _first, int n) : Solver(n), first(_first) { }
+
+   virtual void SetOperator(const Operator &op) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      for (int i = 0; i < height; i++)
+         y(i) = x(i)/Diag(first+i);
+   }
+};
+
+int main(int argc, char *argv[])
+{
+   int num_procs, myid;
+   MPI_Init(&argc, &argv);
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+
+   const int first = (myid*N)/num_procs, n = ((myid+1)*N)/num_procs - first;
+   Jacobi jacobi(first, n);
+
+   const int nrhs[] = { 1, 3, 6 };
+   int failed = 0;
+
+   for (int k = 0; k < 2; k++)
+   {
+      const double c = (k == 0) ? 0.0 : 0.3;
+      ParTridiagonal A(MPI_COMM_WORLD, first, n, c);
+
+      // the assembled global system, on every rank
+      SparseMatrix A_glob(N);
+      for (int i = 0; i < N; i++)
+      {
+         A_glob.Add(i, i, Diag(i));
+         if (i > 0)
+            A_glob.Add(i, i-1, Lower(c));
+         if (i < N-1)
+            A_glob.Add(i, i+1, Upper(c));
+      }
+      A_glob.Finalize();
+
+      for (int pc = 0; pc <= 1; pc++)
+         for (int s = 0; s < 3; s++)
+         {
+            // global right-hand sides and serial reference solutions
+            DenseMatrix B_glob(N, nrhs[s]), X_ref(N, nrhs[s]);
+            for (int j = 0; j < nrhs[s]; j++)
+            {
+               Vector b(B_glob.Data() + j*N, N);
+               b.Randomize(j + 1);
+            }
+            if (nrhs[s] == 6)
+               for (int i = 0; i < N; i++)
+                  B_glob(i,5) = B_glob(i,1);
+            CGSolver cg;
+            GMRESSolver gmres;
+            gmres.SetKDim(100);
+            IterativeSolver &single = (k == 0) ?
+                                      (IterativeSolver &)cg : gmres;
+            single.SetRelTol(1e-14);
+            single.SetMaxIter(10*N);
+            single.SetPrintLevel(-1);
+            single.SetOperator(A_glob);
+            for (int j = 0; j < nrhs[s]; j++)
+            {
+               Vector b(B_glob.Data() + j*N, N), x(X_ref.Data() + j*N, N);
+               x = 0.0;
+               single.Mult(b, x);
+            }
+
+            // local rows of the right-hand sides
+            DenseMatrix B(n, nrhs[s]), X(n, nrhs[s]);
+            for (int j = 0; j < nrhs[s]; j++)
+               for (int i = 0; i < n; i++)
+                  B(i,j) = B_glob(first+i,j);
+
+            BlockCGSolver bcg(MPI_COMM_WORLD);
+            BlockGMRESSolver bgmres(MPI_COMM_WORLD);
+            bgmres.SetKDim(40);
+            IterativeSolver &block = (k == 0) ?
+                                     (IterativeSolver &)bcg : bgmres;
+            block.SetRelTol(1e-12);
+            block.SetMaxIter(10*N);
+            block.SetPrintLevel(-1);
+            if (pc)
+               block.SetPreconditioner(jacobi);
+            block.SetOperator(A);
+            X = 0.0;
+            if (k == 0)
+               bcg.Mult(B, X);
+            else
+               bgmres.Mult(B, X);
+
+            // max over the columns of ||X - X_ref|| / ||X_ref||
+            double err = 0.0;
+            for (int j = 0; j < nrhs[s]; j++)
+            {
+               double d[2] = { 0.0, 0.0 };
+               for (int i = 0; i < n; i++)
+               {
+                  d[0] += pow(X(i,j) - X_ref(first+i,j), 2);
+                  d[1] += pow(X_ref(first+i,j), 2);
+               }
+               MPI_Allreduce(MPI_IN_PLACE, d, 2, MPI_DOUBLE, MPI_SUM,
+                             MPI_COMM_WORLD);
+               err = max(err, sqrt(d[0]/d[1]));
+            }
+
+            if (myid == 0)
+               cout << (k == 0 ? "BlockCG" : "BlockGMRES")
+                    << (pc ? ", Jacobi" : "") << ", " << nrhs[s] << " rhs, "
+                    << num_procs << " ranks: " << block.GetNumIterations()
+                    << " iterations, difference from the serial "
+                    << (k == 0 ? "CG" : "GMRES") << " = " << err << endl;
+            if (!block.GetConverged() || err > 1e-8)
+               failed = 1;
+         }
+   }
+
+   MPI_Finalize();
+
+   return failed;
+}
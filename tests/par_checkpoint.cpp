@@ -0,0 +1,162 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: MPI-IO checkpoint/restart of ParMesh and ParGridFunction
+//
+// Compile with: make par_checkpoint
+//
+// Sample run:   mpirun -np 2 par_checkpoint
+//
+// Description:  Partitions straight (triangular, tetrahedral) and curved
+//               (triangular, quadrilateral, hexahedral) meshes, writes the
+//               ParMesh and an H1 ParGridFunction with SaveCheckpoint(),
+//               restarts both from the shared files and checks that the local
+//               meshes, the groups and shared entities, the parallel dof
+//               numbering, and the grid function values on every rank are
+//               identical to the originals. Both meshes are then refined in
+//               parallel, which uses the restored shared entities, and
+//               compared again.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double f(Vector &x)
+{
+   return sin(x(0))*cos(2.0*x(1)) + x(x.Size()-1);
+}
+
+bool SameMesh(ParMesh &a, ParMesh &b)
+{
+   ostringstream sa, sb;
+   sa.precision(16);
+   sb.precision(16);
+   a.Print(sa);
+   b.Print(sb);
+   return (sa.str() == sb.str());
+}
+
+// Compare the groups of ranks and the shared vertices, edges and faces
+bool SameGroups(ParMesh &a, ParMesh &b)
+{
+   GroupTopology &ga = a.gtopo, &gb = b.gtopo;
+   if (ga.NGroups() != gb.NGroups())
+      return false;
+   for (int g = 0; g < ga.NGroups(); g++)
+   {
+      if (ga.GetGroupSize(g) != gb.GetGroupSize(g))
+         return false;
+      for (int j = 0; j < ga.GetGroupSize(g); j++)
+         if (ga.GetNeighborRank(ga.GetGroup(g)[j]) !=
+             gb.GetNeighborRank(gb.GetGroup(g)[j]))
+            return false;
+   }
+   for (int g = 1; g < a.GetNGroups(); g++)
+   {
+      if (a.GroupNVertices(g) != b.GroupNVertices(g) ||
+          a.GroupNEdges(g) != b.GroupNEdges(g) ||
+          a.GroupNFaces(g) != b.GroupNFaces(g))
+         return false;
+      for (int i = 0; i < a.GroupNVertices(g); i++)
+         if (a.GroupVertex(g, i) != b.GroupVertex(g, i))
+            return false;
+      int ea, oa, eb, ob;
+      for (int i = 0; i < a.GroupNEdges(g); i++)
+      {
+         a.GroupEdge(g, i, ea, oa);
+         b.GroupEdge(g, i, eb, ob);
+         if (ea != eb || oa != ob)
+            return false;
+      }
+      for (int i = 0; i < a.GroupNFaces(g); i++)
+      {
+         a.GroupFace(g, i, ea, oa);
+         b.GroupFace(g, i, eb, ob);
+         if (ea != eb || oa != ob)
+            return false;
+      }
+   }
+   return true;
+}
+
+int main(int argc, char *argv[])
+{
+   int num_procs, myid;
+   MPI_Init(&argc, &argv);
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+
+   const char *mesh_files[] =
+   {
+      "../data/beam-tri.mesh", "../data/beam-tet.mesh",
+      "../data/square-disc-p2.mesh", "../data/star-q2.mesh",
+      "../data/fichera-q2.mesh"
+   };
+   int failed = 0;
+
+   for (int m = 0; m < 5; m++)
+   {
+      ifstream imesh(mesh_files[m]);
+      Mesh mesh(imesh, 1, 1);
+      mesh.UniformRefinement();
+
+      // partition by blocks of consecutive elements (no METIS needed)
+      const int ne = mesh.GetNE();
+      Array<int> partitioning(ne);
+      for (int i = 0; i < ne; i++)
+         partitioning[i] = (i*num_procs)/ne;
+
+      ParMesh pmesh(MPI_COMM_WORLD, mesh, partitioning);
+      H1_FECollection fec(2, pmesh.Dimension());
+      ParFiniteElementSpace fes(&pmesh, &fec);
+      ParGridFunction x(&fes);
+      FunctionCoefficient fc(f);
+      x.ProjectCoefficient(fc);
+
+      pmesh.SaveCheckpoint("par_checkpoint.mesh");
+      x.SaveCheckpoint("par_checkpoint.gf");
+
+      ParMesh pmesh_r(MPI_COMM_WORLD, "par_checkpoint.mesh");
+      ParGridFunction x_r(&pmesh_r, "par_checkpoint.gf");
+
+      // the parallel numbering of the restarted space uses the restored
+      // groups and shared entities
+      ParFiniteElementSpace fes_r(&pmesh_r, &fec);
+      Vector d(x);
+      d -= x_r;
+      int ok = SameMesh(pmesh, pmesh_r) && SameGroups(pmesh, pmesh_r) &&
+               (x.Size() == x_r.Size()) && (d.Normlinf() == 0.0) &&
+               (fes.TrueVSize() == fes_r.TrueVSize()) &&
+               (fes.GetMyDofOffset() == fes_r.GetMyDofOffset());
+
+      pmesh.UniformRefinement();
+      pmesh_r.UniformRefinement();
+      ok = ok && SameMesh(pmesh, pmesh_r) && SameGroups(pmesh, pmesh_r);
+
+      int all_ok;
+      MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+      if (myid == 0)
+         cout << mesh_files[m] << ", " << num_procs << " ranks: "
+              << (all_ok ? "identical after restart and refinement"
+                  : "DIFFERENT") << endl;
+      if (!all_ok)
+         failed = 1;
+   }
+
+   MPI_Finalize();
+
+   return failed;
+}
@@ -0,0 +1,162 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: parallel pipelined and single-reduction CG
+//
+// Compile with: make par_pipelined_cg
+//
+// Sample run:   mpirun -np 4 par_pipelined_cg
+//
+// Description:  Solves a tridiagonal reaction-diffusion system, distributed by
+//               blocks of rows, with the parallel CGSolver, PipelinedCGSolver
+//               and SingleReductionCGSolver, without and with a Jacobi
+//               preconditioner. The operator exchanges its halo values with
+//               point-to-point messages while the non-blocking reduction of
+//               the pipelined solvers is in flight. Every solver must match
+//               the serial CG solution of the assembled global system on all
+//               ranks and use about the same number of iterations.
+
+#include "mfem.hpp"
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+// Global size of the system and its entries
+const int N = 2000;
+double Diag(int i) { return (1 + i%5)*(2.0 + 0.01*(1 + i%7)); }
+const double Off = -1.0;
+
+// The rows [first, first+height) of the tridiagonal matrix
+class ParTridiagonal : public Operator
+{
+   MPI_Comm comm;
+   int myid, num_procs, first;
+
+public:
+   ParTridiagonal(MPI_Comm _comm, int _first, int n)
+      : Operator(n), comm(_comm), first(_first)
+   {
+      MPI_Comm_rank(comm, &myid);
+      MPI_Comm_size(comm, &num_procs);
+   }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      const int n = height;
+      const int left = (myid > 0) ? myid-1 : MPI_PROC_NULL;
+      const int right = (myid < num_procs-1) ? myid+1 : MPI_PROC_NULL;
+      double xl = 0.0, xr = 0.0;
+      MPI_Sendrecv(&x(n-1), 1, MPI_DOUBLE, right, 0, &xl, 1, MPI_DOUBLE,
+                   left, 0, comm, MPI_STATUS_IGNORE);
+      MPI_Sendrecv(&x(0), 1, MPI_DOUBLE, left, 1, &xr, 1, MPI_DOUBLE,
+                   right, 1, comm, MPI_STATUS_IGNORE);
+      for (int i = 0; i < n; i++)
+         y(i) = Diag(first+i)*x(i) + Off*((i > 0) ? x(i-1) : xl) +
+                Off*((i < n-1) ? x(i+1) : xr);
+   }
+};
+
+// Jacobi preconditioner for the local rows of the tridiagonal matrix
+class Jacobi : public Solver
+{
+   int first;
+
+public:
+   Jacobi(int _first, int n) : Solver(n), first(_first) { }
+
+   virtual void SetOperator(const Operator &op) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      for (int i = 0; i < height; i++)
+         y(i) = x(i)/Diag(first+i);
+   }
+};
+
+int main(int argc, char *argv[])
+{
+   int num_procs, myid;
+   MPI_Init(&argc, &argv);
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+
+   const int first = (myid*N)/num_procs, n = ((myid+1)*N)/num_procs - first;
+   ParTridiagonal A(MPI_COMM_WORLD, first, n);
+   Jacobi jacobi(first, n);
+
+   // the assembled global system and right-hand side, on every rank
+   SparseMatrix A_glob(N);
+   for (int i = 0; i < N; i++)
+   {
+      A_glob.Add(i, i, Diag(i));
+      if (i > 0)
+         A_glob.Add(i, i-1, Off);
+      if (i < N-1)
+         A_glob.Add(i, i+1, Off);
+   }
+   A_glob.Finalize();
+   Vector b_glob(N), x_ref(N);
+   b_glob.Randomize(1);
+   x_ref = 0.0;
+   CG(A_glob, b_glob, x_ref, -1, 10*N, 1e-24, 0.0);
+
+   Vector b(b_glob.GetData() + first, n), x(n);
+
+   const char *name[] = { "CG", "PipelinedCG", "SingleReductionCG" };
+   int failed = 0, it_cg = 0;
+
+   for (int pc = 0; pc <= 1; pc++)
+      for (int k = 0; k < 3; k++)
+      {
+         CGSolver cg(MPI_COMM_WORLD);
+         PipelinedCGSolver pipe(MPI_COMM_WORLD);
+         SingleReductionCGSolver sr(MPI_COMM_WORLD);
+         IterativeSolver &solver = (k == 0) ? (IterativeSolver &)cg :
+                                   (k == 1) ? (IterativeSolver &)pipe : sr;
+         solver.SetRelTol(1e-10);
+         solver.SetMaxIter(10*N);
+         solver.SetPrintLevel(-1);
+         if (pc)
+            solver.SetPreconditioner(jacobi);
+         solver.SetOperator(A);
+         x = 0.0;
+         solver.Mult(b, x);
+
+         double err = 0.0, ref = 0.0;
+         for (int i = 0; i < n; i++)
+         {
+            err = max(err, fabs(x(i) - x_ref(first+i)));
+            ref = max(ref, fabs(x_ref(first+i)));
+         }
+         MPI_Allreduce(MPI_IN_PLACE, &err, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD);
+         MPI_Allreduce(MPI_IN_PLACE, &ref, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD);
+         err /= ref;
+
+         const int it = solver.GetNumIterations();
+         if (k == 0)
+            it_cg = it;
+         if (myid == 0)
+            cout << (pc ? "Jacobi-" : "") << name[k] << ", " << num_procs
+                 << " ranks: " << it << " iterations, difference from the "
+                 << "serial solution = " << err << endl;
+         if (!solver.GetConverged() || err > 1e-6 ||
+             abs(it - it_cg) > 0.1*it_cg + 2)
+            failed = 1;
+      }
+
+   MPI_Finalize();
+
+   return failed;
+}
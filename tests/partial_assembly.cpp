@@ -0,0 +1,98 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: partial assembly vs. full assembly
+//
+// Compile with: make partial_assembly
+//
+// Description:  Applies the diffusion + mass operator with a variable
+//               coefficient, assembled with AssemblyLevel::PARTIAL, to a
+//               random vector and compares the result with the action of the
+//               fully assembled SparseMatrix, on quadrilateral and hexahedral
+//               meshes (straight and curved) and for several orders.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double kappa(Vector &x)
+{
+   return 1.0 + x.Norml2();
+}
+
+void perturb(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(3.0*x(1));
+   y(1) += 0.05*sin(2.0*x(0));
+}
+
+// Return the max-norm of the difference of the two actions, relative to the
+// max-norm of the full action.
+double Check(Mesh &mesh, int order)
+{
+   H1_FECollection fec(order, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+   FunctionCoefficient k(kappa);
+   ConstantCoefficient m(2.0);
+
+   BilinearForm a_fa(&fes), a_pa(&fes);
+   a_fa.AddDomainIntegrator(new DiffusionIntegrator(k));
+   a_fa.AddDomainIntegrator(new MassIntegrator(m));
+   a_pa.AddDomainIntegrator(new DiffusionIntegrator(k));
+   a_pa.AddDomainIntegrator(new MassIntegrator(m));
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_fa.Assemble();
+   a_fa.Finalize();
+   a_pa.Assemble();
+
+   Vector x(fes.GetVSize()), y_fa(fes.GetVSize()), y_pa(fes.GetVSize());
+   x.Randomize(1);
+   a_fa.Mult(x, y_fa);
+   a_pa.Mult(x, y_pa);
+   y_pa -= y_fa;
+   return y_pa.Normlinf()/y_fa.Normlinf();
+}
+
+int main()
+{
+   const char *mesh_files[] = { "../data/star.mesh", "../data/fichera.mesh" };
+   int failed = 0;
+
+   for (int m = 0; m < 2; m++)
+      for (int curved = 0; curved <= 1; curved++)
+      {
+         ifstream imesh(mesh_files[m]);
+         Mesh mesh(imesh, 1, 1);
+         H1_FECollection nfec(2, mesh.Dimension());
+         FiniteElementSpace nfes(&mesh, &nfec, mesh.Dimension());
+         if (curved)
+         {
+            mesh.SetNodalFESpace(&nfes);
+            mesh.Transform(perturb);
+         }
+         for (int order = 1; order <= 3; order++)
+         {
+            double err = Check(mesh, order);
+            cout << mesh_files[m] << (curved ? " (curved)" : "")
+                 << ", order " << order << ": relative error = " << err
+                 << endl;
+            if (err > 1e-12)
+               failed = 1;
+         }
+      }
+
+   return failed;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: pipelined and single-reduction CG
+//
+// Compile with: make pipelined_cg
+//
+// Description:  Solves a diffusion-reaction system with CGSolver,
+//               PipelinedCGSolver and SingleReductionCGSolver, without and
+//               with a Jacobi preconditioner. The two communication-reducing
+//               variants must converge, give the CG solution, and use about
+//               the same number of iterations as CG.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new MassIntegrator(one));
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+
+   Vector b(A.Size()), x_cg(A.Size()), x(A.Size()), r(A.Size());
+   b.Randomize(1);
+   DSmoother jacobi(A);
+
+   const char *name[] = { "PipelinedCG", "SingleReductionCG" };
+   int failed = 0;
+
+   for (int pc = 0; pc <= 1; pc++)
+   {
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(2000);
+      cg.SetPrintLevel(-1);
+      if (pc)
+         cg.SetPreconditioner(jacobi);
+      cg.SetOperator(A);
+      x_cg = 0.0;
+      cg.Mult(b, x_cg);
+      const int it_cg = cg.GetNumIterations();
+      cout << (pc ? "Jacobi-" : "") << "CG: " << it_cg << " iterations"
+           << endl;
+      if (!cg.GetConverged())
+         failed = 1;
+
+      for (int k = 0; k < 2; k++)
+      {
+         PipelinedCGSolver pipe;
+         SingleReductionCGSolver sr;
+         IterativeSolver &solver = (k == 0) ?
+                                   (IterativeSolver &)pipe : sr;
+         solver.SetRelTol(1e-10);
+         solver.SetMaxIter(2000);
+         solver.SetPrintLevel(-1);
+         if (pc)
+            solver.SetPreconditioner(jacobi);
+         solver.SetOperator(A);
+         x = 0.0;
+         solver.Mult(b, x);
+
+         A.Mult(x, r);
+         subtract(b, r, r);
+         const double res = r.Norml2()/b.Norml2();
+         r = x;
+         r -= x_cg;
+         const double err = r.Normlinf()/x_cg.Normlinf();
+         const int it = solver.GetNumIterations();
+         cout << (pc ? "Jacobi-" : "") << name[k] << ": " << it
+              << " iterations, relative residual = " << res
+              << ", difference from CG = " << err << endl;
+         if (!solver.GetConverged() || res > 1e-8 || err > 1e-6 ||
+             abs(it - it_cg) > 0.1*it_cg + 2)
+            failed = 1;
+      }
+   }
+
+   return failed;
+}
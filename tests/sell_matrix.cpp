@@ -0,0 +1,113 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: SELL-C-sigma vs. CSR matrix products
+//
+// Compile with: make sell_matrix
+//
+// Description:  Compares the products of a SELLMatrix (for several chunk
+//               heights C and sorting windows sigma) with a vector, its
+//               transpose with a vector, and with a multi-vector of 1 to 7
+//               columns to the same products computed by the CSR
+//               SparseMatrix, and checks the SparseMatrix multi-vector
+//               product against column-by-column products.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double RelErr(const double *y1, const double *y2, int n)
+{
+   double d = 0.0, m = 0.0;
+   for (int i = 0; i < n; i++)
+   {
+      d = fmax(d, fabs(y1[i] - y2[i]));
+      m = fmax(m, fabs(y2[i]));
+   }
+   return d/m;
+}
+
+int main()
+{
+   ifstream imesh("../data/fichera.mesh");
+   Mesh mesh(imesh, 1, 1);
+   // use a mix of row lengths (element, face, edge and vertex dofs)
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+   const int n = A.Size();
+   int failed = 0;
+
+   Vector x(n), y(n), y_sell(n);
+   x.Randomize(1);
+
+   // CSR multi-vector product vs. column-by-column products
+   for (int nv = 1; nv <= 7; nv++)
+   {
+      DenseMatrix X(n, nv), Y(n, nv);
+      for (int k = 0; k < n*nv; k++)
+         X.Data()[k] = sin(1.3*k);
+      A.Mult(X, Y);
+      double err = 0.0;
+      for (int v = 0; v < nv; v++)
+      {
+         Vector xv(X.Data() + v*n, n);
+         A.Mult(xv, y);
+         err = fmax(err, RelErr(Y.Data() + v*n, y.GetData(), n));
+      }
+      cout << "CSR, " << nv << " columns: relative error = " << err << endl;
+      if (err > 1e-12)
+         failed = 1;
+   }
+
+   const int Cs[] = { 1, 4, 8 }, sigmas[] = { 1, 32, 256 };
+   for (int c = 0; c < 3; c++)
+      for (int s = 0; s < 3; s++)
+      {
+         const int C = Cs[c], sigma = (sigmas[s] < C) ? C : sigmas[s];
+         SELLMatrix S(A, C, sigma);
+
+         A.Mult(x, y);
+         S.Mult(x, y_sell);
+         double err = RelErr(y_sell.GetData(), y.GetData(), n);
+
+         A.MultTranspose(x, y);
+         S.MultTranspose(x, y_sell);
+         err = fmax(err, RelErr(y_sell.GetData(), y.GetData(), n));
+
+         for (int nv = 1; nv <= 7; nv++)
+         {
+            DenseMatrix X(n, nv), Y(n, nv), Y_sell;
+            for (int k = 0; k < n*nv; k++)
+               X.Data()[k] = cos(0.7*k);
+            A.Mult(X, Y);
+            S.Mult(X, Y_sell);
+            err = fmax(err, RelErr(Y_sell.Data(), Y.Data(), n*nv));
+         }
+
+         cout << "SELL, C = " << C << ", sigma = " << sigma
+              << ", fill ratio = " << S.GetFillRatio()
+              << ": relative error = " << err << endl;
+         if (err > 1e-12)
+            failed = 1;
+      }
+
+   return failed;
+}
@@ -0,0 +1,225 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: integrators with the cached reference shape tables
+//
+// Compile with: make shape_tables
+//
+// Description:  On curved triangle and quadrilateral meshes and on hexahedral
+//               and tetrahedral meshes, compares the element matrices and
+//               vectors of the integrators that read the DofToQuad tables
+//               (mass, diffusion, their mixed versions, vector FE mass,
+//               curl-curl, div-div and the scalar linear form integrators)
+//               with the same quantities computed from the Calc...Shape()
+//               methods. Also compares GridFunction::ComputeL2Error() with the
+//               computation on explicitly given (uncached) rules.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+double f(Vector &x) { return 1.0 + x(0)*x(0) - 0.5*x(1); }
+
+// Relative difference of two element matrices
+double Difference(DenseMatrix &A, DenseMatrix &B)
+{
+   B -= A;
+   return B.MaxMaxNorm()/A.MaxMaxNorm();
+}
+
+// Reference element matrices, computed point by point. 'type' is 0: mass,
+// 1: diffusion, 2: vector FE mass, 3: curl-curl, 4: div-div.
+void RefElementMatrix(int type, const FiniteElement &tr_fe,
+                      const FiniteElement &te_fe, ElementTransformation &T,
+                      const IntegrationRule &ir, DenseMatrix &elmat)
+{
+   const int tr_nd = tr_fe.GetDof(), te_nd = te_fe.GetDof();
+   const int dim = tr_fe.GetDim(), sdim = T.GetSpaceDim();
+   Vector tr_s(tr_nd), te_s(te_nd);
+   DenseMatrix tr_d(tr_nd, dim), te_d(te_nd, dim), Jinv(dim, sdim);
+   DenseMatrix tr_p(tr_nd, sdim), te_p(te_nd, sdim);
+   elmat.SetSize(te_nd, tr_nd);
+   elmat = 0.0;
+   for (int q = 0; q < ir.GetNPoints(); q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      T.SetIntPoint(&ip);
+      const double w = ip.weight*T.Weight();
+      CalcInverse(T.Jacobian(), Jinv);
+      switch (type)
+      {
+      case 0:
+         tr_fe.CalcShape(ip, tr_s);
+         te_fe.CalcShape(ip, te_s);
+         AddMult_a_VWt(w, te_s, tr_s, elmat);
+         break;
+      case 1:
+         tr_fe.CalcDShape(ip, tr_d);
+         te_fe.CalcDShape(ip, te_d);
+         Mult(tr_d, Jinv, tr_p);
+         Mult(te_d, Jinv, te_p);
+         te_p *= w;
+         AddMultABt(te_p, tr_p, elmat);
+         break;
+      case 2:
+         tr_fe.CalcVShape(T, tr_p);
+         AddMult_a_AAt(w, tr_p, elmat);
+         break;
+      case 3:
+         tr_fe.CalcCurlShape(ip, tr_d);
+         MultABt(tr_d, T.Jacobian(), tr_p);
+         AddMult_a_AAt(w/(T.Weight()*T.Weight()), tr_p, elmat);
+         break;
+      case 4:
+         tr_fe.CalcDivShape(ip, tr_s);
+         AddMult_a_VVt(w/(T.Weight()*T.Weight()), tr_s, elmat);
+         break;
+      }
+   }
+}
+
+int main()
+{
+   const char *mesh_file[] =
+   {
+      "../data/square-disc-p2.mesh", "../data/star-q2.mesh",
+      "../data/fichera-q2.mesh", "../data/beam-tet.mesh"
+   };
+   ConstantCoefficient one(1.0);
+   FunctionCoefficient fc(f);
+   int failed = 0;
+
+   for (int m = 0; m < 4; m++)
+   {
+      ifstream imesh(mesh_file[m]);
+      Mesh mesh(imesh, 1, 1);
+      const int dim = mesh.Dimension();
+      const int geom = mesh.GetElementBaseGeometry(0);
+
+      H1_FECollection h1_1(1, dim), h1_2(2, dim);
+      L2_FECollection l2(1, dim);
+      ND_FECollection nd(1, dim);
+      RT_FECollection rt(0, dim);
+      FiniteElementSpace fes1(&mesh, &h1_1), fes2(&mesh, &h1_2);
+      FiniteElementSpace fes_l2(&mesh, &l2), fes_nd(&mesh, &nd);
+      FiniteElementSpace fes_rt(&mesh, &rt);
+
+      // bilinear integrators: name, integrator, trial space, test space,
+      // reference type, integration order
+      MassIntegrator mass;
+      DiffusionIntegrator diff;
+      VectorFEMassIntegrator vmass;
+      CurlCurlIntegrator curlcurl;
+      DivDivIntegrator divdiv;
+      struct
+      {
+         const char *name; BilinearFormIntegrator *bfi;
+         FiniteElementSpace *tr, *te; int type, order;
+      } checks[] =
+      {
+         { "H1 mass", &mass, &fes2, &fes2, 0, 4 },
+         { "L2 mass", &mass, &fes_l2, &fes_l2, 0, 2 },
+         { "H1 diffusion", &diff, &fes2, &fes2, 1, 2 },
+         { "mixed mass", &mass, &fes1, &fes2, 0, 3 },
+         { "mixed diffusion", &diff, &fes1, &fes2, 1, 1 },
+         { "ND mass", &vmass, &fes_nd, &fes_nd, 2, 2 },
+         { "RT mass", &vmass, &fes_rt, &fes_rt, 2, 2 },
+         { "ND curl-curl", &curlcurl, &fes_nd, &fes_nd, 3, 0 },
+         { "RT div-div", &divdiv, &fes_rt, &fes_rt, 4, 0 }
+      };
+
+      cout << mesh_file[m] << ":" << endl;
+      DenseMatrix elmat, ref;
+      for (int c = 0; c < 9; c++)
+      {
+         // the curls are only cached in 3D
+         if (c == 7 && dim == 2)
+            continue;
+         const IntegrationRule &ir = IntRules.Get(geom, checks[c].order);
+         checks[c].bfi->SetIntRule(&ir);
+         double err = 0.0;
+         for (int e = 0; e < mesh.GetNE(); e++)
+         {
+            const FiniteElement &tr_fe = *checks[c].tr->GetFE(e);
+            const FiniteElement &te_fe = *checks[c].te->GetFE(e);
+            ElementTransformation &T = *mesh.GetElementTransformation(e);
+            if (checks[c].tr == checks[c].te)
+               checks[c].bfi->AssembleElementMatrix(tr_fe, T, elmat);
+            else
+               checks[c].bfi->AssembleElementMatrix2(tr_fe, te_fe, T, elmat);
+            RefElementMatrix(checks[c].type, tr_fe, te_fe, T, ir, ref);
+            err = fmax(err, Difference(ref, elmat));
+         }
+         cout << "   " << checks[c].name << ": relative difference = " << err
+              << endl;
+         if (err > 1e-12)
+            failed = 1;
+      }
+
+      // linear form integrators
+      DomainLFIntegrator dlf(fc);
+      BoundaryLFIntegrator blf(fc);
+      Vector elvect, refvect, shape;
+      double err = 0.0;
+      for (int bdr = 0; bdr <= 1; bdr++)
+      {
+         const int ne = bdr ? mesh.GetNBE() : mesh.GetNE();
+         for (int e = 0; e < ne; e++)
+         {
+            const FiniteElement &fe = bdr ? *fes2.GetBE(e) : *fes2.GetFE(e);
+            ElementTransformation &T = bdr ?
+                                       *mesh.GetBdrElementTransformation(e) :
+                                       *mesh.GetElementTransformation(e);
+            const IntegrationRule &ir = IntRules.Get(fe.GetGeomType(), 4);
+            LinearFormIntegrator &lfi = bdr ? (LinearFormIntegrator &)blf :
+                                        (LinearFormIntegrator &)dlf;
+            lfi.SetIntRule(&ir);
+            lfi.AssembleRHSElementVect(fe, T, elvect);
+            refvect.SetSize(fe.GetDof());
+            refvect = 0.0;
+            shape.SetSize(fe.GetDof());
+            for (int q = 0; q < ir.GetNPoints(); q++)
+            {
+               const IntegrationPoint &ip = ir.IntPoint(q);
+               T.SetIntPoint(&ip);
+               fe.CalcShape(ip, shape);
+               refvect.Add(ip.weight*T.Weight()*fc.Eval(T, ip), shape);
+            }
+            refvect -= elvect;
+            err = fmax(err, refvect.Normlinf()/elvect.Normlinf());
+         }
+      }
+      cout << "   domain and boundary LF: relative difference = " << err
+           << endl;
+      if (err > 1e-12)
+         failed = 1;
+
+      // L2 error with the default (cached) and with explicit rules
+      GridFunction x(&fes2);
+      x.ProjectCoefficient(one);
+      const IntegrationRule *irs[Geometry::NumGeom];
+      for (int g = 0; g < Geometry::NumGeom; g++)
+         irs[g] = NULL;
+      irs[geom] = &IntRules.Get(geom, 2*fes2.GetFE(0)->GetOrder() + 1);
+      const double err_def = x.ComputeL2Error(fc);
+      const double err_irs = x.ComputeL2Error(fc, irs);
+      cout << "   L2 error: " << err_def << " (explicit rules: " << err_irs
+           << ")" << endl;
+      if (fabs(err_def - err_irs) > 1e-12*err_irs)
+         failed = 1;
+   }
+
+   return failed;
+}
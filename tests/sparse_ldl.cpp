@@ -0,0 +1,228 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: sparse LDL^T solver with minimum degree ordering
+//
+// Compile with: make sparse_ldl
+//
+// Description:  Solves diffusion-reaction systems, an elasticity system with
+//               eliminated essential boundary conditions and a quasi-definite
+//               block system with SparseLDLSolver, reusing one solver for a
+//               matrix with the same sparsity (new values) and for one with a
+//               different sparsity. The backward errors must be at round-off
+//               level, the ordering must be a permutation, and the fill of L
+//               must be smaller than with the original ordering. This also
+//               holds for a matrix that stores only its lower triangular
+//               part.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace mfem;
+
+// Number of nonzeros of L (with the unit diagonal) for the given ordering,
+// from the elimination tree of the lower triangular part of A
+int FactorNonZeros(const SparseMatrix &A, const Array<int> &perm)
+{
+   const int n = A.Size(), *I = A.GetI(), *J = A.GetJ();
+   Array<int> iperm(n), parent(n), flag(n);
+   for (int i = 0; i < n; i++)
+      iperm[perm[i]] = i;
+
+   // the rows of the lower triangular part of P A P^T
+   Table C;
+   C.MakeI(n);
+   for (int r = 0; r < n; r++)
+      for (int q = I[r]; q < I[r+1]; q++)
+         if (J[q] <= r)
+            C.AddAColumnInRow(max(iperm[r], iperm[J[q]]));
+   C.MakeJ();
+   for (int r = 0; r < n; r++)
+      for (int q = I[r]; q < I[r+1]; q++)
+         if (J[q] <= r)
+            C.AddConnection(max(iperm[r], iperm[J[q]]),
+                            min(iperm[r], iperm[J[q]]));
+   C.ShiftUpI();
+
+   int nnz = n;
+   for (int i = 0; i < n; i++)
+   {
+      parent[i] = -1;
+      flag[i] = i;
+      for (int q = 0; q < C.RowSize(i); q++)
+         for (int k = C.GetRow(i)[q]; k < i && flag[k] != i; k = parent[k])
+         {
+            if (parent[k] == -1)
+               parent[k] = i;
+            flag[k] = i;
+            nnz++;
+         }
+   }
+   return nnz;
+}
+
+// Solve with the given solver and check the residual and the ordering
+int Check(SparseLDLSolver &ldl, const SparseMatrix &A, const char *name)
+{
+   const int n = A.Size();
+   ldl.SetOperator(A);
+
+   Vector b(n), x(n), r(n);
+   b.Randomize(1);
+   ldl.Mult(b, x);
+   A.Mult(x, r);
+   subtract(b, r, r);
+   // normwise backward error
+   double anorm = 0.0;
+   for (int i = 0; i < n; i++)
+      anorm = fmax(anorm, A.GetRowNorml1(i));
+   const double berr =
+      r.Normlinf()/(anorm*x.Normlinf() + b.Normlinf());
+
+   Array<int> perm, natural(n);
+   MinimumDegreeOrdering(A, perm);
+   Array<int> count(n);
+   count = 0;
+   for (int i = 0; i < perm.Size(); i++)
+      count[perm[i]]++;
+   bool is_perm = (perm.Size() == n);
+   for (int i = 0; i < n; i++)
+   {
+      is_perm = is_perm && (count[i] == 1);
+      natural[i] = i;
+   }
+   const int nnz_nat = FactorNonZeros(A, natural);
+
+   cout << name << ": " << n << " unknowns, nnz(L) = " << ldl.NumNonZeroElems()
+        << " (original ordering: " << nnz_nat << "), backward error = "
+        << berr << endl;
+   return (berr > 1e-14 || !is_perm || ldl.NumNonZeroElems() >= nnz_nat ||
+           FactorNonZeros(A, perm) != ldl.NumNonZeroElems());
+}
+
+int main()
+{
+   int failed = 0;
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec(2, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec);
+
+   // the same sparsity with two sets of values, then a new sparsity
+   ConstantCoefficient one(1.0), ten(10.0);
+   SparseLDLSolver ldl;
+   for (int k = 0; k < 2; k++)
+   {
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(k ? ten : one));
+      a.Assemble();
+      a.Finalize();
+      failed |= Check(ldl, a.SpMat(), k ? "diffusion-reaction (new values)" :
+                      "diffusion-reaction");
+   }
+
+   ifstream ibeam("../data/beam-quad.mesh");
+   Mesh beam(ibeam, 1, 1);
+   for (int ref = 0; ref < 3; ref++)
+      beam.UniformRefinement();
+   H1_FECollection fec1(2, beam.Dimension());
+   FiniteElementSpace fes_beam(&beam, &fec1, beam.Dimension());
+   {
+      BilinearForm a(&fes_beam);
+      a.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+      a.Assemble();
+      GridFunction x(&fes_beam);
+      x = 0.0;
+      Vector b(fes_beam.GetVSize());
+      b = 0.0;
+      Array<int> ess_bdr(beam.bdr_attributes.Max());
+      ess_bdr = 0;
+      ess_bdr[0] = 1;
+      a.EliminateEssentialBC(ess_bdr, x, b);
+      a.Finalize();
+      failed |= Check(ldl, a.SpMat(), "elasticity (new sparsity)");
+   }
+
+   // quasi-definite system [ K M ; M -M ]
+   {
+      ConstantCoefficient minus_one(-1.0);
+      BilinearForm k(&fes), m(&fes), negm(&fes);
+      k.AddDomainIntegrator(new DiffusionIntegrator(one));
+      k.AddDomainIntegrator(new MassIntegrator(one));
+      k.Assemble();
+      k.Finalize();
+      m.AddDomainIntegrator(new MassIntegrator(one));
+      m.Assemble();
+      m.Finalize();
+      negm.AddDomainIntegrator(new MassIntegrator(minus_one));
+      negm.Assemble();
+      negm.Finalize();
+
+      Array<int> offsets(3);
+      offsets[0] = 0;
+      offsets[1] = fes.GetVSize();
+      offsets[2] = 2*fes.GetVSize();
+      BlockMatrix block(offsets);
+      block.SetBlock(0, 0, &k.SpMat());
+      block.SetBlock(0, 1, &m.SpMat());
+      block.SetBlock(1, 0, &m.SpMat());
+      block.SetBlock(1, 1, &negm.SpMat());
+      SparseMatrix *A = block.CreateMonolithic();
+      SparseLDLSolver qd;
+      failed |= Check(qd, *A, "quasi-definite");
+      delete A;
+   }
+
+   // a matrix that stores only its lower triangular part
+   {
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(one));
+      a.Assemble();
+      a.Finalize();
+      const SparseMatrix &A = a.SpMat();
+      const int n = A.Size(), *I = A.GetI(), *J = A.GetJ();
+      const double *V = A.GetData();
+      SparseMatrix lower(n);
+      for (int i = 0; i < n; i++)
+         for (int q = I[i]; q < I[i+1]; q++)
+            if (J[q] <= i)
+               lower.Set(i, J[q], V[q]);
+      lower.Finalize();
+
+      SparseLDLSolver ldl_lower(lower);
+      Vector b(n), x(n), r(n);
+      b.Randomize(1);
+      ldl_lower.Mult(b, x);
+      A.Mult(x, r);
+      subtract(b, r, r);
+      double anorm = 0.0;
+      for (int i = 0; i < n; i++)
+         anorm = fmax(anorm, A.GetRowNorml1(i));
+      const double berr =
+         r.Normlinf()/(anorm*x.Normlinf() + b.Normlinf());
+      cout << "lower triangular storage: " << n << " unknowns, nnz(L) = "
+           << ldl_lower.NumNonZeroElems() << ", backward error = " << berr
+           << endl;
+      if (berr > 1e-14)
+         failed = 1;
+   }
+
+   return failed;
+}
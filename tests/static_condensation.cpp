@@ -0,0 +1,135 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: static condensation of the element interior dofs
+//
+// Compile with: make static_condensation
+//
+// Description:  Solves H1 diffusion-mass problems (with a boundary mass term
+//               and natural b.c. in 2D), a vector elasticity problem, and an
+//               H(curl) problem in 3D with and without static condensation,
+//               for random right-hand sides and essential b.c. values. The
+//               reduced system must be smaller, and the solutions recovered
+//               from it must agree with the solutions of the full systems.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+using namespace mfem;
+
+void AddIntegrators(BilinearForm &a, int type, Coefficient &one)
+{
+   switch (type)
+   {
+   case 0:
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(one));
+      a.AddBoundaryIntegrator(new BoundaryMassIntegrator(one));
+      break;
+   case 1:
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(one));
+      break;
+   case 2:
+      a.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+      break;
+   case 3:
+      a.AddDomainIntegrator(new CurlCurlIntegrator(one));
+      a.AddDomainIntegrator(new VectorFEMassIntegrator(one));
+      break;
+   }
+}
+
+int main()
+{
+   const char *mesh_file[] =
+   {
+      "../data/star.mesh", "../data/star.mesh", "../data/beam-tet.mesh",
+      "../data/star.mesh", "../data/fichera.mesh"
+   };
+   // 0: H1 diffusion-mass, natural b.c.; 1: H1 diffusion-mass; 2: vector H1
+   // elasticity; 3: H(curl)
+   const int type[] = { 0, 1, 1, 2, 3 };
+   const int order[] = { 3, 4, 4, 3, 2 };
+   const char *name[] =
+   {
+      "H1 p=3, natural b.c.", "H1 p=4", "H1 p=4 (tetrahedra)",
+      "elasticity p=3", "H(curl) p=2 (hexahedra)"
+   };
+   ConstantCoefficient one(1.0);
+   int failed = 0;
+
+   for (int c = 0; c < 5; c++)
+   {
+      ifstream imesh(mesh_file[c]);
+      Mesh mesh(imesh, 1, 1);
+      const int dim = mesh.Dimension();
+      if (dim == 2)
+         mesh.UniformRefinement();
+
+      FiniteElementCollection *fec;
+      if (type[c] == 3)
+         fec = new ND_FECollection(order[c], dim);
+      else
+         fec = new H1_FECollection(order[c], dim);
+      FiniteElementSpace fes(&mesh, fec, (type[c] == 2) ? dim : 1,
+                             Ordering::byVDIM);
+      const int n = fes.GetVSize();
+
+      Array<int> ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = (type[c] == 0) ? 0 : 1;
+
+      Vector x(n), b(n);
+      x.Randomize(1);
+      b.Randomize(2);
+
+      // the full system
+      BilinearForm a(&fes);
+      AddIntegrators(a, type[c], one);
+      a.Assemble();
+      Vector x_ref(x), b_ref(b);
+      a.EliminateEssentialBC(ess_bdr, x_ref, b_ref);
+      a.Finalize();
+      GSSmoother M(a.SpMat());
+      PCG(a, M, b_ref, x_ref, 0, 2000, 1e-28, 0.0);
+
+      // the condensed system
+      BilinearForm a_sc(&fes);
+      AddIntegrators(a_sc, type[c], one);
+      a_sc.EnableStaticCondensation();
+      StaticCondensation &sc = *a_sc.GetStaticCondensation();
+      a_sc.Assemble();
+      Vector sc_x, sc_b, x_sc;
+      sc.ReduceRHS(b, sc_b);
+      sc.ReduceSolution(x, sc_x);
+      sc.EliminateEssentialBC(ess_bdr, sc_x, sc_b);
+      a_sc.Finalize();
+      GSSmoother M_sc(sc.GetMatrix());
+      PCG(sc.GetMatrix(), M_sc, sc_b, sc_x, 0, 2000, 1e-28, 0.0);
+      sc.ComputeSolution(b, sc_x, x_sc);
+
+      x_sc -= x_ref;
+      const double err = x_sc.Normlinf()/x_ref.Normlinf();
+      const int nr = sc.GetNExDofs();
+      cout << name[c] << ": " << n << " dofs, " << nr
+           << " in the reduced system, relative difference = " << err
+           << endl;
+      if (err > 1e-9 || nr >= n || sc.GetMatrix().Size() != nr)
+         failed = 1;
+
+      delete fec;
+   }
+
+   return failed;
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: assembly into a precomputed CSR pattern
+//
+// Compile with: make threaded_assembly
+//
+// Description:  Assembles H1 elasticity, H(curl) and H(div) forms on a
+//               tetrahedral and a hexahedral mesh, with the linked list
+//               assembly (UsePrecomputedSparsity(0)) and with
+//               BilinearForm::UsePrecomputedSparsity(), which scatters
+//               directly into the CSR matrix -- from several threads, over a
+//               coloring of the elements, when MFEM is built with OpenMP.
+//               The latter is repeated with an integrator that can not be
+//               cloned, which must fall back to one thread. The matrices are
+//               compared through their action on a random vector.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Integrator without Clone(), delegating to another integrator
+class NoCloneIntegrator : public BilinearFormIntegrator
+{
+private:
+   BilinearFormIntegrator *bfi;
+
+public:
+   NoCloneIntegrator(BilinearFormIntegrator *_bfi) { bfi = _bfi; }
+
+   virtual void AssembleElementMatrix(const FiniteElement &el,
+                                      ElementTransformation &Trans,
+                                      DenseMatrix &elmat)
+   { bfi->AssembleElementMatrix(el, Trans, elmat); }
+
+   virtual ~NoCloneIntegrator() { delete bfi; }
+};
+
+void AddIntegrators(BilinearForm &a, int type, Coefficient &one,
+                    bool no_clone = false)
+{
+   if (type == 0 && no_clone)
+      a.AddDomainIntegrator(
+         new NoCloneIntegrator(new ElasticityIntegrator(one, 1.0, 2.0)));
+   else if (type == 0)
+      a.AddDomainIntegrator(new ElasticityIntegrator(one, 1.0, 2.0));
+   else if (type == 1)
+   {
+      a.AddDomainIntegrator(new CurlCurlIntegrator(one));
+      a.AddDomainIntegrator(new VectorFEMassIntegrator(one));
+   }
+   else
+   {
+      a.AddDomainIntegrator(new DivDivIntegrator(one));
+      if (no_clone)
+         a.AddDomainIntegrator(
+            new NoCloneIntegrator(new VectorFEMassIntegrator(one)));
+      else
+         a.AddDomainIntegrator(new VectorFEMassIntegrator(one));
+   }
+}
+
+int main()
+{
+   const char *mesh_files[] =
+   { "../data/beam-tet.mesh", "../data/beam-hex.mesh" };
+   const char *name[] = { "H1 elasticity", "ND curl-curl", "RT div-div" };
+   ConstantCoefficient one(1.0);
+   int failed = 0;
+
+   for (int m = 0; m < 2; m++)
+   {
+      ifstream imesh(mesh_files[m]);
+      Mesh mesh(imesh, 1, 1);
+      const int dim = mesh.Dimension();
+      mesh.UniformRefinement();
+      if (m == 0)
+         mesh.ReorientTetMesh();
+
+      for (int type = 0; type < 3; type++)
+      {
+         FiniteElementCollection *fec;
+         if (type == 0)
+            fec = new H1_FECollection(2, dim);
+         else if (type == 1)
+            fec = new ND_FECollection(2, dim);
+         else
+            fec = new RT_FECollection(1, dim);
+         FiniteElementSpace fes(&mesh, fec, (type == 0) ? dim : 1);
+
+         BilinearForm a(&fes), a_csr(&fes), a_nc(&fes);
+         AddIntegrators(a, type, one);
+         AddIntegrators(a_csr, type, one);
+         AddIntegrators(a_nc, type, one, true);
+         a.UsePrecomputedSparsity(0);
+         a_csr.UsePrecomputedSparsity();
+         a_nc.UsePrecomputedSparsity();
+         a.Assemble();
+         a.Finalize();
+         a_csr.Assemble();
+         a_csr.Finalize();
+         a_nc.Assemble();
+         a_nc.Finalize();
+
+         Vector x(fes.GetVSize()), y(fes.GetVSize()), y_csr(fes.GetVSize());
+         Vector y_nc(fes.GetVSize());
+         x.Randomize(1);
+         a.Mult(x, y);
+         a_csr.Mult(x, y_csr);
+         a_nc.Mult(x, y_nc);
+         y_csr -= y;
+         y_nc -= y;
+         const double err = y_csr.Normlinf()/y.Normlinf();
+         const double err_nc = y_nc.Normlinf()/y.Normlinf();
+         cout << mesh_files[m] << ", " << name[type] << ": relative error = "
+              << err << ", without Clone(): " << err_nc << endl;
+         if (err > 1e-12 || err_nc > 1e-12)
+            failed = 1;
+
+         delete fec;
+      }
+   }
+
+   return failed;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.googlecode.com.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+//             Check: reuse of the UMFPACK symbolic factorization
+//
+// Compile with: make umfpack_reuse (requires MFEM_USE_SUITESPARSE=YES)
+//
+// Description:  Factors two matrices with the same sparsity pattern and then
+//               one with a different pattern with a single UMFPackSolver,
+//               with int and long indices. The symbolic factorization must
+//               be kept for the second matrix, and all the solves must be
+//               accurate. (The third one can not be told apart by the address
+//               of the new symbolic object, which may be the freed one.)
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Access to the symbolic factorization
+class UMFPackCheck : public UMFPackSolver
+{
+public:
+   UMFPackCheck(bool long_ints) : UMFPackSolver(long_ints) { }
+   const void *GetSymbolic() const { return Symbolic; }
+};
+
+SparseMatrix *Assemble(FiniteElementSpace &fes, double c)
+{
+   ConstantCoefficient one(1.0), coeff(c);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new MassIntegrator(coeff));
+   a.Assemble();
+   a.Finalize();
+   return a.LoseMat();
+}
+
+int main()
+{
+   ifstream imesh("../data/star.mesh");
+   Mesh mesh(imesh, 1, 1);
+   mesh.UniformRefinement();
+   mesh.UniformRefinement();
+   H1_FECollection fec1(1, mesh.Dimension()), fec2(2, mesh.Dimension());
+   FiniteElementSpace fes1(&mesh, &fec1), fes2(&mesh, &fec2);
+
+   SparseMatrix *A[3];
+   A[0] = Assemble(fes2, 1.0);
+   A[1] = Assemble(fes2, 10.0);
+   A[2] = Assemble(fes1, 1.0);
+   const char *name[] = { "first matrix", "same pattern", "new pattern" };
+
+   int failed = 0;
+   for (int long_ints = 0; long_ints <= 1; long_ints++)
+   {
+      UMFPackCheck umf(long_ints);
+      const void *sym = NULL;
+      for (int k = 0; k < 3; k++)
+      {
+         umf.SetOperator(*A[k]);
+         const bool reused = (umf.GetSymbolic() == sym);
+         sym = umf.GetSymbolic();
+
+         const int n = A[k]->Size();
+         Vector b(n), x(n), r(n);
+         b.Randomize(1);
+         umf.Mult(b, x);
+         A[k]->Mult(x, r);
+         subtract(b, r, r);
+         const double res = r.Normlinf()/b.Normlinf();
+         cout << (long_ints ? "long" : "int") << " indices, " << name[k]
+              << ": symbolic object " << (reused ? "kept" : "replaced")
+              << ", relative residual = " << res << endl;
+         if (res > 1e-10 || (k == 1 && !reused))
+            failed = 1;
+      }
+   }
+
+   for (int k = 0; k < 3; k++)
+      delete A[k];
+
+   return failed;
+}